@@ -0,0 +1,279 @@
+// Cache and check-cycle costs against a temporary XDG_CONFIG_HOME and
+// XDG_CACHE_HOME: cache_save + cache_load round trips and cache_load alone on
+// a full window, persisting one consumed trigger by full rewrite versus the
+// fired log, cache_build_triggers (one day), cache_build_window, building and
+// draining a window of about 10k triggers, the per-minute "is anything due"
+// check with and without a compiled MinuteMap, and full run_check_cycle calls
+// on the cache-hit and rebuild paths.
+//
+// The check-cycle config has every prayer disabled and the cache-hit cache
+// only holds triggers due weeks ahead, so no notification can fire while
+// benchmarking.
+
+#define _GNU_SOURCE
+#include "bench_common.h"
+#include "cache.h"
+#include "check_cycle.h"
+#include "config.h"
+#include "platform.h"
+#include "prayer_checker.h"
+
+#include <unistd.h>
+
+static char tmpdir[256];
+
+static Config bench_config(bool prayers_enabled) {
+  Config cfg = config_default();
+  cfg.latitude = -6.2088;
+  cfg.longitude = 106.8456;
+  snprintf(cfg.timezone, sizeof(cfg.timezone), "Asia/Jakarta");
+  cfg.timezone_offset = 7.0;
+  cfg.auto_detect = false;
+  PrayerConfig *all[7] = {&cfg.fajr, &cfg.sunrise, &cfg.dhuha, &cfg.dhuhr,
+                          &cfg.asr,  &cfg.maghrib, &cfg.isha};
+  for (int i = 0; i < 7; i++) {
+    all[i]->enabled = prayers_enabled;
+    all[i]->reminder_count = 3;
+    all[i]->reminders[0] = 30;
+    all[i]->reminders[1] = 15;
+    all[i]->reminders[2] = 5;
+  }
+  return cfg;
+}
+
+static void today_str(char *buf, size_t size) {
+  time_t now = time(NULL);
+  struct tm tm_now;
+  localtime_r(&now, &tm_now);
+  char full[64];
+  snprintf(full, sizeof(full), "%04d-%02d-%02d", tm_now.tm_year + 1900, tm_now.tm_mon + 1,
+           tm_now.tm_mday);
+  snprintf(buf, size, "%.10s", full);
+}
+
+static PrayerCache full_cache(void) {
+  Config cfg = bench_config(true);
+  PrayerCache cache = {0};
+  cache_build_window(&cache, &cfg, "2026-01-15", CACHE_WINDOW_DAYS, 0);
+  return cache;
+}
+
+static void run_round_trip(void *arg, int batch) {
+  const PrayerCache *cache = arg;
+  PrayerCache loaded = {0};
+  int acc = 0;
+  for (int i = 0; i < batch; i++) {
+    if (cache_save(cache) != 0 || cache_load(&loaded) != 0) {
+      fprintf(stderr, "bench: cache round trip failed\n");
+      exit(1);
+    }
+    acc += loaded.trigger_count;
+  }
+  cache_free(&loaded);
+  bench_sink += acc;
+}
+
+static void run_load(void *arg, int batch) {
+  (void)arg;
+  PrayerCache loaded = {0};
+  int acc = 0;
+  for (int i = 0; i < batch; i++) {
+    if (cache_load(&loaded) != 0) {
+      fprintf(stderr, "bench: cache_load failed\n");
+      exit(1);
+    }
+    acc += loaded.trigger_count;
+  }
+  cache_free(&loaded);
+  bench_sink += acc;
+}
+
+// Consume one trigger and persist it, cycling through the window
+static void run_consume(void *arg, int batch, int (*persist)(const PrayerCache *)) {
+  PrayerCache *cache = arg;
+  platform_file_delete(cache_get_fired_path());
+  for (int i = 0; i < batch; i++) {
+    if (cache_pending(cache) == 0)
+      cache->head = 0;
+    cache_remove_first(cache, 1);
+    if (persist(cache) != 0) {
+      fprintf(stderr, "bench: persisting a consumed trigger failed\n");
+      exit(1);
+    }
+  }
+  bench_sink += cache->head;
+}
+
+static void run_consume_rewrite(void *arg, int batch) {
+  run_consume(arg, batch, cache_save);
+}
+
+static void run_consume_log(void *arg, int batch) {
+  run_consume(arg, batch, cache_save_fired);
+}
+
+static void run_build_triggers(void *arg, int batch) {
+  const Config *cfg = arg;
+  struct PrayerTimes times =
+      calculate_prayer_times(2026, 1, 15, cfg->latitude, cfg->longitude, cfg->timezone_offset,
+                             method_params_get(CALC_KEMENAG));
+  PrayerCache cache = {0};
+  int acc = 0;
+  for (int i = 0; i < batch; i++)
+    acc += cache_build_triggers(&cache, cfg, &times, i % 1440, "2026-01-15");
+  cache_free(&cache);
+  bench_sink += acc;
+}
+
+static void run_build_window(void *arg, int batch) {
+  const Config *cfg = arg;
+  PrayerCache cache = {0};
+  int acc = 0;
+  for (int i = 0; i < batch; i++)
+    acc += cache_build_window(&cache, cfg, "2026-01-15", CACHE_WINDOW_DAYS, 0);
+  cache_free(&cache);
+  bench_sink += acc;
+}
+
+// 28 triggers a day with every prayer and three reminders
+#define LARGE_WINDOW_DAYS 358
+
+// Build a window of about 10k triggers into a fresh block, then fire them in
+// order the way the daemon does
+static void run_build_consume(void *arg, int batch) {
+  const Config *cfg = arg;
+  int acc = 0;
+  for (int i = 0; i < batch; i++) {
+    PrayerCache cache = {0};
+    if (cache_build_window(&cache, cfg, "2026-01-15", LARGE_WINDOW_DAYS, 0) < 0) {
+      fprintf(stderr, "bench: large window build failed\n");
+      exit(1);
+    }
+    while (cache_pending(&cache) > 0) {
+      time_t due = cache.triggers[cache.head].due;
+      cache_remove_first(&cache, cache_first_due_after(&cache, due) - cache.head);
+      acc++;
+    }
+    cache_free(&cache);
+  }
+  bench_sink += acc;
+}
+
+typedef struct {
+  Config cfg;
+  struct PrayerTimes times;
+  MinuteMap map;
+} PollCase;
+
+static void run_check_current(void *arg, int batch) {
+  PollCase *c = arg;
+  int acc = 0;
+  for (int i = 0; i < batch; i++) {
+    struct tm now = {.tm_hour = i / 60 % 24, .tm_min = i % 60};
+    acc += prayer_check_current(&c->cfg, &now, &c->times).type;
+  }
+  bench_sink += acc;
+}
+
+static void run_map_check(void *arg, int batch) {
+  const PollCase *c = arg;
+  int acc = 0;
+  for (int i = 0; i < batch; i++)
+    acc += prayer_map_check(&c->map, i % MINUTES_PER_DAY).type;
+  bench_sink += acc;
+}
+
+static void run_map_next(void *arg, int batch) {
+  const PollCase *c = arg;
+  int acc = 0;
+  for (int i = 0; i < batch; i++)
+    acc += prayer_map_next(&c->map, i % MINUTES_PER_DAY);
+  bench_sink += acc;
+}
+
+static void run_cycle_hit(void *arg, int batch) {
+  (void)arg;
+  for (int i = 0; i < batch; i++)
+    bench_sink += run_check_cycle();
+}
+
+static void run_cycle_rebuild(void *arg, int batch) {
+  (void)arg;
+  for (int i = 0; i < batch; i++) {
+    cache_invalidate();
+    bench_sink += run_check_cycle();
+  }
+}
+
+int main(int argc, char **argv) {
+  snprintf(tmpdir, sizeof(tmpdir), "/tmp/muslimtify_bench_XXXXXX");
+  if (!mkdtemp(tmpdir)) {
+    fprintf(stderr, "bench: mkdtemp failed\n");
+    return 1;
+  }
+  // Before any path lookup: platform.c caches the directories
+  setenv("XDG_CONFIG_HOME", tmpdir, 1);
+  setenv("XDG_CACHE_HOME", tmpdir, 1);
+  cache_reset_path();
+
+  Config quiet = bench_config(false);
+  if (config_save(&quiet) != 0) {
+    fprintf(stderr, "bench: config_save failed\n");
+    return 1;
+  }
+  Config enabled = bench_config(true);
+  PrayerCache cache = full_cache();
+
+  BenchReport r;
+  bench_begin(&r, "cache", argc, argv);
+  char name[64];
+  snprintf(name, sizeof(name), "cache_save+cache_load/%d triggers", cache.trigger_count);
+  bench_run(&r, name, run_round_trip, &cache, 5, 50, 20);
+  snprintf(name, sizeof(name), "cache_load/%d triggers", cache.trigger_count);
+  bench_run(&r, name, run_load, NULL, 5, 50, 200);
+  PrayerCache consumed = {0};
+  cache_copy(&consumed, &cache);
+  bench_run(&r, "consume 1 + cache_save", run_consume_rewrite, &consumed, 5, 50, 20);
+  cache_copy(&consumed, &cache);
+  bench_run(&r, "consume 1 + cache_save_fired", run_consume_log, &consumed, 5, 50, 20);
+  bench_run(&r, "cache_build_triggers", run_build_triggers, &enabled, 5, 50, 1000);
+  snprintf(name, sizeof(name), "cache_build_window/%d days", CACHE_WINDOW_DAYS);
+  bench_run(&r, name, run_build_window, &enabled, 5, 50, 100);
+  snprintf(name, sizeof(name), "build+consume/%d triggers", LARGE_WINDOW_DAYS * 28);
+  bench_run(&r, name, run_build_consume, &enabled, 3, 10, 1);
+
+  PollCase poll = {.cfg = enabled};
+  poll.times = calculate_prayer_times(2026, 1, 15, enabled.latitude, enabled.longitude,
+                                      enabled.timezone_offset, method_params_get(CALC_KEMENAG));
+  SchedulePlan plan;
+  schedule_plan_build(&plan, &poll.cfg);
+  prayer_map_build(&poll.map, &plan, &poll.times);
+  bench_run(&r, "prayer_check_current", run_check_current, &poll, 5, 50, 1440);
+  bench_run(&r, "prayer_map_check", run_map_check, &poll, 5, 50, 1440);
+  bench_run(&r, "prayer_map_next", run_map_next, &poll, 5, 50, 1440);
+
+  // Valid full window from today whose triggers are all weeks away
+  PrayerCache hit = {0};
+  cache_copy(&hit, &cache);
+  today_str(hit.date, sizeof(hit.date));
+  hit.config_hash = config_schedule_hash(&quiet);
+  time_t later = time(NULL) + 30 * 86400;
+  for (int i = 0; i < hit.trigger_count; i++)
+    hit.triggers[i].due = later + i;
+  cache_save(&hit);
+  bench_run(&r, "run_check_cycle/cache hit", run_cycle_hit, NULL, 5, 50, 20);
+  bench_run(&r, "run_check_cycle/rebuild", run_cycle_rebuild, NULL, 5, 50, 20);
+  cache_free(&hit);
+  cache_free(&consumed);
+  cache_free(&cache);
+
+  // Best-effort cleanup of what the benchmarks created; the config and cache
+  // directories may be the same one
+  platform_file_delete(cache_get_fired_path());
+  platform_file_delete(cache_get_path());
+  platform_file_delete(config_get_path());
+  rmdir(platform_cache_dir());
+  rmdir(platform_config_dir());
+  rmdir(tmpdir);
+  return bench_end(&r);
+}
@@ -0,0 +1,109 @@
+// Shared harness for the microbenchmark suite (bench_core, bench_json,
+// bench_cache). Header-only: each benchmark is one translation unit.
+//
+// A benchmark runs `warmup` untimed samples, then `iterations` timed samples
+// of `batch` operations each. Reported per operation: median and p99 over
+// the samples, and ops/sec over all timed operations. Run a binary with
+// --json to get one machine-readable document for regression tracking:
+//
+//   {"suite": "core", "version": "0.2.5", "results": [
+//     {"name": "...", "warmup": 5, "iterations": 50, "batch": 365,
+//      "median_ns": 310.2, "p99_ns": 355.0, "ops_per_sec": 3187621}, ...]}
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include "version.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef void (*BenchFn)(void *arg, int batch);
+
+typedef struct {
+  const char *suite;
+  bool json;
+  int count; // results reported so far
+} BenchReport;
+
+// Prevents the optimizer from discarding results; benchmarks add to it
+static volatile double bench_sink;
+
+static double bench_now_ns(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static int bench_cmp_double(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static void bench_begin(BenchReport *r, const char *suite, int argc, char **argv) {
+  r->suite = suite;
+  r->json = false;
+  r->count = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--json") == 0)
+      r->json = true;
+  }
+  if (r->json) {
+    printf("{\"suite\": \"%s\", \"version\": \"%s\", \"results\": [", suite, MUSLIMTIFY_VERSION);
+  } else {
+    printf("%s benchmarks (muslimtify %s)\n", suite, MUSLIMTIFY_VERSION);
+    printf("  %-40s %6s %6s %6s %12s %12s %14s\n", "name", "warmup", "iters", "batch",
+           "median ns", "p99 ns", "ops/sec");
+  }
+}
+
+// Time fn(arg, batch) and report it under name
+static void bench_run(BenchReport *r, const char *name, BenchFn fn, void *arg, int warmup,
+                      int iterations, int batch) {
+  double *samples = malloc((size_t)iterations * sizeof(*samples));
+  if (!samples) {
+    fprintf(stderr, "bench: out of memory\n");
+    exit(1);
+  }
+
+  for (int i = 0; i < warmup; i++)
+    fn(arg, batch);
+
+  double total = 0.0;
+  for (int i = 0; i < iterations; i++) {
+    double start = bench_now_ns();
+    fn(arg, batch);
+    samples[i] = (bench_now_ns() - start) / batch;
+    total += samples[i] * batch;
+  }
+
+  qsort(samples, (size_t)iterations, sizeof(*samples), bench_cmp_double);
+  double median = iterations % 2 ? samples[iterations / 2]
+                                 : 0.5 * (samples[iterations / 2 - 1] + samples[iterations / 2]);
+  int p99_index = (int)(0.99 * (iterations - 1) + 0.5);
+  double p99 = samples[p99_index];
+  double ops_per_sec = total > 0.0 ? (double)iterations * batch / (total / 1e9) : 0.0;
+  free(samples);
+
+  if (r->json) {
+    printf("%s\n  {\"name\": \"%s\", \"warmup\": %d, \"iterations\": %d, \"batch\": %d, "
+           "\"median_ns\": %.1f, \"p99_ns\": %.1f, \"ops_per_sec\": %.0f}",
+           r->count ? "," : "", name, warmup, iterations, batch, median, p99, ops_per_sec);
+  } else {
+    printf("  %-40s %6d %6d %6d %12.1f %12.1f %14.0f\n", name, warmup, iterations, batch, median,
+           p99, ops_per_sec);
+  }
+  fflush(stdout);
+  r->count++;
+}
+
+static int bench_end(BenchReport *r) {
+  if (r->json)
+    printf("\n]}\n");
+  return 0;
+}
+
+#endif // BENCH_COMMON_H
@@ -0,0 +1,55 @@
+// calculate_prayer_times for every catalogue method in three latitude bands.
+// One operation is one call; a sample walks the days of 2026 across four
+// latitudes of the band.
+
+#define PRAYERTIMES_IMPLEMENTATION
+#include "bench_common.h"
+#include "prayertimes.h"
+
+typedef struct {
+  const char *name;
+  double lat_lo, lat_hi;
+} LatitudeBand;
+
+static const LatitudeBand BANDS[] = {
+    {"equatorial", -10.0, 10.0},
+    {"mid", 30.0, 45.0},
+    {"high", 50.0, 60.0},
+};
+
+typedef struct {
+  const MethodParams *params;
+  const LatitudeBand *band;
+} CoreCase;
+
+static void run_days(void *arg, int batch) {
+  static const int dim[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  const CoreCase *c = arg;
+  double acc = 0.0;
+  int m = 1, d = 1;
+  for (int i = 0; i < batch; i++) {
+    double lat = c->band->lat_lo + (i % 4) * (c->band->lat_hi - c->band->lat_lo) / 3.0;
+    struct PrayerTimes t = calculate_prayer_times(2026, m, d, lat, 30.0, 2.0, c->params);
+    acc += t.fajr + t.dhuhr + t.asr + t.isha;
+    if (++d > dim[m - 1]) {
+      d = 1;
+      m = m % 12 + 1;
+    }
+  }
+  bench_sink += acc;
+}
+
+int main(int argc, char **argv) {
+  BenchReport r;
+  bench_begin(&r, "core", argc, argv);
+  for (int m = 0; m < CALC_CUSTOM; m++) {
+    for (size_t b = 0; b < sizeof(BANDS) / sizeof(BANDS[0]); b++) {
+      CoreCase c = {method_params_get((CalcMethod)m), &BANDS[b]};
+      char name[64];
+      snprintf(name, sizeof(name), "calculate_prayer_times/%s/%s",
+               method_to_string((CalcMethod)m), BANDS[b].name);
+      bench_run(&r, name, run_days, &c, 5, 50, 365);
+    }
+  }
+  return bench_end(&r);
+}
@@ -0,0 +1,111 @@
+// get_value on a config.json-sized document (the default config) and a
+// next_prayer.json-sized one (a full day of triggers, as cache_save writes
+// it). One operation is one lookup; each sample runs in a fresh JsonContext.
+
+#define JSON_IMPLEMENTATION
+#include "bench_common.h"
+#include "json.h"
+
+static const char CONFIG_DOC[] =
+    "{\n"
+    "  \"location\": {\n"
+    "    \"latitude\": -6.2088,\n"
+    "    \"longitude\": 106.8456,\n"
+    "    \"timezone\": \"Asia/Jakarta\",\n"
+    "    \"timezone_offset\": 7.0,\n"
+    "    \"auto_detect\": false,\n"
+    "    \"city\": \"Jakarta\",\n"
+    "    \"country\": \"ID\"\n"
+    "  },\n"
+    "  \"prayers\": {\n"
+    "    \"fajr\": {\"enabled\": true, \"reminders\": [30, 15, 5]},\n"
+    "    \"sunrise\": {\"enabled\": false, \"reminders\": []},\n"
+    "    \"dhuha\": {\"enabled\": false, \"reminders\": []},\n"
+    "    \"dhuhr\": {\"enabled\": true, \"reminders\": [30, 15, 5]},\n"
+    "    \"asr\": {\"enabled\": true, \"reminders\": [30, 15, 5]},\n"
+    "    \"maghrib\": {\"enabled\": true, \"reminders\": [30, 15, 5]},\n"
+    "    \"isha\": {\"enabled\": true, \"reminders\": [30, 15, 5]}\n"
+    "  },\n"
+    "  \"notification\": {\n"
+    "    \"timeout\": 5000,\n"
+    "    \"urgency\": \"normal\",\n"
+    "    \"sound\": true,\n"
+    "    \"icon\": \"muslimtify\"\n"
+    "  },\n"
+    "  \"calculation\": {\n"
+    "    \"method\": \"kemenag\",\n"
+    "    \"madhab\": \"shafi\"\n"
+    "  }\n"
+    "}\n";
+
+// Same layout as cache_save(): 5 prayers x (3 reminders + exact time)
+static char *make_cache_doc(void) {
+  static const char *prayers[5] = {"fajr", "dhuhr", "asr", "maghrib", "isha"};
+  static const double times[5] = {4.4333, 12.0667, 15.4833, 18.2833, 19.5333};
+  static const int before[4] = {30, 15, 5, 0};
+  size_t cap = 8192, len = 0;
+  char *doc = malloc(cap);
+  if (!doc)
+    return NULL;
+  len += (size_t)snprintf(doc + len, cap - len,
+                          "{\n  \"date\": \"2026-01-15\",\n  \"triggers\": [\n");
+  for (int p = 0; p < 5; p++) {
+    for (int b = 0; b < 4; b++) {
+      int minute = (int)(times[p] * 60.0 + 0.999) - before[b];
+      len += (size_t)snprintf(doc + len, cap - len,
+                              "    {\"prayer\": \"%s\", \"minute\": %d, "
+                              "\"minutes_before\": %d, \"prayer_time\": %.4f}%s\n",
+                              prayers[p], minute, before[b], times[p],
+                              p == 4 && b == 3 ? "" : ",");
+    }
+  }
+  snprintf(doc + len, cap - len, "  ]\n}\n");
+  return doc;
+}
+
+typedef struct {
+  char *doc;
+  const char *key;
+} JsonCase;
+
+static void run_get_value(void *arg, int batch) {
+  const JsonCase *c = arg;
+  JsonContext *ctx = json_begin();
+  size_t acc = 0;
+  for (int i = 0; i < batch; i++) {
+    char *v = get_value(ctx, c->key, c->doc);
+    acc += v ? (size_t)v[0] : 0;
+  }
+  json_end(ctx);
+  bench_sink += (double)acc;
+}
+
+int main(int argc, char **argv) {
+  char *config_doc = malloc(sizeof(CONFIG_DOC));
+  char *cache_doc = make_cache_doc();
+  if (!config_doc || !cache_doc) {
+    fprintf(stderr, "bench: out of memory\n");
+    return 1;
+  }
+  memcpy(config_doc, CONFIG_DOC, sizeof(CONFIG_DOC));
+
+  const struct {
+    const char *name;
+    JsonCase c;
+  } cases[] = {
+      {"get_value/config/location (first key)", {config_doc, "location"}},
+      {"get_value/config/calculation (last key)", {config_doc, "calculation"}},
+      {"get_value/config/missing", {config_doc, "no_such_key"}},
+      {"get_value/cache/date", {cache_doc, "date"}},
+      {"get_value/cache/triggers (20 entries)", {cache_doc, "triggers"}},
+  };
+
+  BenchReport r;
+  bench_begin(&r, "json", argc, argv);
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    bench_run(&r, cases[i].name, run_get_value, (void *)&cases[i].c, 5, 50, 1000);
+
+  free(config_doc);
+  free(cache_doc);
+  return bench_end(&r);
+}
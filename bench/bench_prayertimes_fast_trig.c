@@ -0,0 +1,73 @@
+// calculate_prayer_times built against libm versus the PRAYERTIMES_FAST_TRIG
+// copy of the engine: a year of Kemenag times for a set of sites, reported as
+// days/second. Accuracy is covered by tests/test_prayertimes_fast_trig.c.
+
+#define PRAYERTIMES_IMPLEMENTATION
+#include "prayertimes_fast_trig.h"
+
+#include <stdio.h>
+#include <time.h>
+
+typedef struct PrayerTimes (*CalcFn)(int year, int month, int day, double latitude,
+                                     double longitude, double timezone,
+                                     const MethodParams *params);
+
+static const double SITES[][3] = {
+    {-6.1667, 106.8167, 7.0}, {-7.2333, 112.75, 7.0}, {21.4225, 39.8262, 3.0},
+    {30.0444, 31.2357, 2.0},  {41.0082, 28.9784, 3.0}, {51.5074, -0.1278, 0.0},
+    {40.7128, -74.006, -5.0}, {35.6762, 139.6503, 9.0}, {3.139, 101.6869, 8.0},
+    {59.9139, 10.7522, 1.0},
+};
+
+#define N_SITES ((int)(sizeof(SITES) / sizeof(SITES[0])))
+#define N_DAYS 365
+#define ROUNDS 40
+
+static double now_seconds(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Prevents the optimizer from discarding the computed times
+static volatile double sink;
+
+static double bench(CalcFn calc, const MethodParams *params) {
+  static const int dim[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  double start = now_seconds();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (int s = 0; s < N_SITES; s++) {
+      int m = 1, d = 1;
+      double acc = 0.0;
+      for (int i = 0; i < N_DAYS; i++) {
+        struct PrayerTimes t = calc(2026, m, d, SITES[s][0], SITES[s][1], SITES[s][2], params);
+        acc += t.fajr + t.sunrise + t.dhuha + t.dhuhr + t.asr + t.maghrib + t.isha;
+        if (++d > dim[m - 1]) {
+          d = 1;
+          m++;
+        }
+      }
+      sink += acc;
+    }
+  }
+  return now_seconds() - start;
+}
+
+int main(void) {
+  const MethodParams *params = method_params_get(CALC_KEMENAG);
+  double days = (double)ROUNDS * N_SITES * N_DAYS;
+
+  // Warm caches and the branch predictor before timing
+  bench(calculate_prayer_times, params);
+  bench(fast_calculate_prayer_times, params);
+
+  double t_libm = bench(calculate_prayer_times, params);
+  double t_fast = bench(fast_calculate_prayer_times, params);
+
+  printf("fast-trig benchmark: %d sites x %d days x %d rounds\n", N_SITES, N_DAYS, ROUNDS);
+  printf("  %-22s %10.0f days/s  (%.1f ns/day)\n", "libm", days / t_libm, t_libm / days * 1e9);
+  printf("  %-22s %10.0f days/s  (%.1f ns/day)\n", "PRAYERTIMES_FAST_TRIG", days / t_fast,
+         t_fast / days * 1e9);
+  printf("  speedup: %.2fx\n", t_libm / t_fast);
+  return 0;
+}
@@ -0,0 +1,98 @@
+// Throughput of calculate_prayer_times_range against the equivalent loop of
+// single-day calculate_prayer_times calls: a full-year timetable for a set of
+// sites, reported as days/second.
+
+#define PRAYERTIMES_IMPLEMENTATION
+#include "prayertimes.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef struct {
+  const char *name;
+  double lat;
+  double lon;
+  double tz;
+} Site;
+
+static const Site SITES[] = {
+    {"Jakarta", -6.1667, 106.8167, 7.0},   {"Surabaya", -7.2333, 112.75, 7.0},
+    {"Makkah", 21.4225, 39.8262, 3.0},     {"Cairo", 30.0444, 31.2357, 2.0},
+    {"Istanbul", 41.0082, 28.9784, 3.0},   {"London", 51.5074, -0.1278, 0.0},
+    {"New York", 40.7128, -74.006, -5.0},  {"Tokyo", 35.6762, 139.6503, 9.0},
+    {"Kuala Lumpur", 3.139, 101.6869, 8.0}, {"Oslo", 59.9139, 10.7522, 1.0},
+};
+
+#define N_SITES ((int)(sizeof(SITES) / sizeof(SITES[0])))
+#define N_DAYS 365
+#define ROUNDS 40
+
+static double now_seconds(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Prevents the optimizer from discarding the computed timetables
+static volatile double sink;
+
+static void consume(const struct PrayerTimes *t, int n) {
+  double acc = 0.0;
+  for (int i = 0; i < n; i++)
+    acc += t[i].fajr + t[i].isha;
+  sink += acc;
+}
+
+static double bench_single_day(const MethodParams *params, struct PrayerTimes *out) {
+  double start = now_seconds();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (int s = 0; s < N_SITES; s++) {
+      int y = 2026, m = 1, d = 1;
+      static const int dim[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+      for (int i = 0; i < N_DAYS; i++) {
+        out[i] = calculate_prayer_times(y, m, d, SITES[s].lat, SITES[s].lon, SITES[s].tz, params);
+        if (++d > dim[m - 1]) {
+          d = 1;
+          m++;
+        }
+      }
+      consume(out, N_DAYS);
+    }
+  }
+  return now_seconds() - start;
+}
+
+static double bench_range(const MethodParams *params, struct PrayerTimes *out) {
+  double start = now_seconds();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (int s = 0; s < N_SITES; s++) {
+      calculate_prayer_times_range(2026, 1, 1, N_DAYS, SITES[s].lat, SITES[s].lon, SITES[s].tz,
+                                   NULL, NULL, params, out);
+      consume(out, N_DAYS);
+    }
+  }
+  return now_seconds() - start;
+}
+
+int main(void) {
+  const MethodParams *params = method_params_get(CALC_KEMENAG);
+  static struct PrayerTimes out[N_DAYS];
+  double days = (double)ROUNDS * N_SITES * N_DAYS;
+
+  // Warm caches and the branch predictor before timing
+  bench_single_day(params, out);
+  bench_range(params, out);
+
+  double t_single = bench_single_day(params, out);
+  double t_range = bench_range(params, out);
+
+  printf("prayer-time range benchmark: %d sites x %d days x %d rounds\n", N_SITES, N_DAYS,
+         ROUNDS);
+  printf("  %-30s %10.0f days/s  (%.1f ns/day)\n", "calculate_prayer_times", days / t_single,
+         t_single / days * 1e9);
+  printf("  %-30s %10.0f days/s  (%.1f ns/day)\n", "calculate_prayer_times_range",
+         days / t_range, t_range / days * 1e9);
+  printf("  speedup: %.2fx\n", t_single / t_range);
+  return 0;
+}
@@ -0,0 +1,76 @@
+// Throughput of the structure-of-arrays kernel against a scalar loop of
+// calculate_prayer_times over a city grid on one date, for every instruction
+// set available on this CPU.
+
+#define PRAYERTIMES_IMPLEMENTATION
+#include "prayertimes_soa.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define GRID_LAT 100
+#define GRID_LON 100
+#define N_SITES (GRID_LAT * GRID_LON)
+#define ROUNDS 50
+
+static double now_seconds(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Prevents the optimizer from discarding the computed times
+static volatile double sink;
+
+int main(void) {
+  static double lat[N_SITES], lon[N_SITES], tz[N_SITES], buf[7 * N_SITES];
+  PrayerTimesSoA out = {buf,
+                        buf + N_SITES,
+                        buf + 2 * N_SITES,
+                        buf + 3 * N_SITES,
+                        buf + 4 * N_SITES,
+                        buf + 5 * N_SITES,
+                        buf + 6 * N_SITES};
+  for (int a = 0; a < GRID_LAT; a++) {
+    for (int b = 0; b < GRID_LON; b++) {
+      int k = a * GRID_LON + b;
+      lat[k] = -10.0 + a * 0.2; // a regional grid, e.g. the Indonesian archipelago
+      lon[k] = 95.0 + b * 0.45;
+      tz[k] = floor(lon[k] / 15.0 + 0.5);
+    }
+  }
+
+  const MethodParams *params = method_params_get(CALC_KEMENAG);
+  double sites = (double)N_SITES * ROUNDS;
+
+  printf("prayer-time SoA benchmark: %d sites x %d rounds\n", N_SITES, ROUNDS);
+
+  double start = now_seconds();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (int k = 0; k < N_SITES; k++) {
+      struct PrayerTimes t = calculate_prayer_times(2026, 6, 15, lat[k], lon[k], tz[k], params);
+      sink += t.fajr;
+    }
+  }
+  double t_base = now_seconds() - start;
+  printf("  %-30s %10.0f sites/s  (%.1f ns/site)\n", "calculate_prayer_times", sites / t_base,
+         t_base / sites * 1e9);
+
+  SunState sun = sun_state_for_date(2026, 6, 15);
+  for (int isa = PRAYER_SIMD_SCALAR; isa <= (int)prayer_simd_detect(); isa++) {
+    prayer_times_soa_isa((PrayerSimdIsa)isa, &sun, params, N_SITES, lat, lon, tz, &out);
+    start = now_seconds();
+    for (int r = 0; r < ROUNDS; r++) {
+      prayer_times_soa_isa((PrayerSimdIsa)isa, &sun, params, N_SITES, lat, lon, tz, &out);
+      sink += out.fajr[r];
+    }
+    double t = now_seconds() - start;
+    char label[48];
+    snprintf(label, sizeof(label), "prayer_times_soa (%s)", prayer_simd_isa_name((PrayerSimdIsa)isa));
+    printf("  %-30s %10.0f sites/s  (%.1f ns/site, %.1fx)\n", label, sites / t, t / sites * 1e9,
+           t_base / t);
+  }
+  return 0;
+}
@@ -0,0 +1,91 @@
+// Solar ephemeris backends: the engine's built-in analytic formula, the
+// Chebyshev fit (sun_chebyshev.h) and the VSOP87 reference it was fitted to.
+// Reports ns per (declination, equation of time) evaluation and the maximum
+// error of each backend against VSOP87 over 1900-2200.
+
+#define PRAYERTIMES_IMPLEMENTATION
+#include "prayertimes.h"
+#include "sun_chebyshev.h"
+#include "vsop87_sun.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+typedef void (*SunFn)(double jd, double *declination, double *equation_of_time);
+
+#define N_EVALS 2000000
+
+static double now_seconds(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Prevents the optimizer from discarding the computed values
+static volatile double sink;
+
+static void chebyshev(double jd, double *declination, double *equation_of_time) {
+  sun_chebyshev(jd, declination, equation_of_time);
+}
+
+static void reference(double jd, double *declination, double *equation_of_time) {
+  vsop87_sun_apparent(jd, NULL, declination, equation_of_time);
+}
+
+// Days spread over the span in a fixed pseudo-random order, so table lookups
+// are not all cache hits on one segment
+static double sample_jd(double first, double days, int i) {
+  return first + floor(fmod(i * 7919.0, days));
+}
+
+static double bench(SunFn fn, double first, double days, int n) {
+  double start = now_seconds();
+  double acc = 0.0;
+  for (int i = 0; i < n; i++) {
+    double d, e;
+    fn(sample_jd(first, days, i), &d, &e);
+    acc += d + e;
+  }
+  sink += acc;
+  return (now_seconds() - start) / n * 1e9;
+}
+
+static void max_error(SunFn fn, double first, double days, double *decl_arcsec,
+                      double *eqt_seconds) {
+  *decl_arcsec = *eqt_seconds = 0.0;
+  for (double t = 0.0; t < days; t += 1.0) {
+    double d, e, rd, re;
+    fn(first + t, &d, &e);
+    reference(first + t, &rd, &re);
+    *decl_arcsec = fmax(*decl_arcsec, fabs(d - rd) * 3600.0);
+    *eqt_seconds = fmax(*eqt_seconds, fabs(e - re) * 3600.0);
+  }
+}
+
+int main(void) {
+  double first, last;
+  sun_chebyshev_range(&first, &last);
+  double days = last - first;
+
+  static const struct {
+    const char *name;
+    SunFn fn;
+    int evals;
+  } backends[] = {
+      {"analytic (built-in)", sun_position_analytic, N_EVALS},
+      {"chebyshev", chebyshev, N_EVALS},
+      {"vsop87 (reference)", reference, N_EVALS / 50},
+  };
+
+  printf("solar ephemeris benchmark: 1900-2200, %.0f days\n", days);
+  printf("  %-22s %10s %16s %18s\n", "backend", "ns/eval", "max decl error", "max EoT error");
+  for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+    bench(backends[b].fn, first, days, backends[b].evals / 10); // warm up
+    double ns = bench(backends[b].fn, first, days, backends[b].evals);
+    double de, ee;
+    max_error(backends[b].fn, first, days, &de, &ee);
+    printf("  %-22s %10.1f %15.3g\" %16.3g s\n", backends[b].name, ns, de, ee);
+  }
+  return 0;
+}
@@ -0,0 +1,95 @@
+// timetable_export() for 5,000 synthetic mosques over one year, written to the
+// null device, at 1, 2, 4, .. threads up to the processor count (and at least
+// 4), against the serial calculate_prayer_times + fprintf loop it replaces.
+// Reported as rows (location-days) per second.
+
+#define PRAYERTIMES_IMPLEMENTATION
+#include "platform.h"
+#include "timetable.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef _WIN32
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+#define N_LOCATIONS 5000
+
+static double now_seconds(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static double bench_serial_printf(FILE *out, const TimetableLocation *locs, size_t n) {
+  static const int dim[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  double start = now_seconds();
+  for (size_t i = 0; i < n; i++) {
+    const MethodParams *p = method_params_get(locs[i].method);
+    for (int m = 1; m <= 12; m++) {
+      for (int d = 1; d <= dim[m - 1]; d++) {
+        struct PrayerTimes t = calculate_prayer_times(2026, m, d, locs[i].latitude,
+                                                      locs[i].longitude, locs[i].timezone, p);
+        const double v[7] = {t.fajr, t.sunrise, t.dhuha, t.dhuhr, t.asr, t.maghrib, t.isha};
+        char hm[7][16];
+        for (int e = 0; e < 7; e++)
+          format_time_hm(v[e], hm[e], sizeof(hm[e]));
+        fprintf(out, "%s,2026-%02d-%02d,%s,%s,%s,%s,%s,%s,%s\n", locs[i].name, m, d, hm[0], hm[1],
+                hm[2], hm[3], hm[4], hm[5], hm[6]);
+      }
+    }
+  }
+  fflush(out);
+  return now_seconds() - start;
+}
+
+int main(void) {
+  FILE *out = fopen(NULL_DEVICE, "w");
+  TimetableLocation *locs = calloc(N_LOCATIONS, sizeof(*locs));
+  if (!out || !locs) {
+    fprintf(stderr, "setup failed\n");
+    return 1;
+  }
+  // Mosques spread over the populated latitudes, every catalogue method
+  for (int i = 0; i < N_LOCATIONS; i++) {
+    snprintf(locs[i].name, sizeof(locs[i].name), "Masjid %d", i);
+    locs[i].latitude = -40.0 + fmod(i * 0.6180339887 * 100.0, 100.0);
+    locs[i].longitude = -180.0 + fmod(i * 0.4142135623 * 360.0, 360.0);
+    locs[i].timezone = floor(locs[i].longitude / 15.0 + 0.5);
+    locs[i].method = (CalcMethod)(i % CALC_CUSTOM);
+  }
+  TimetableDate from = {2026, 1, 1}, to = {2026, 12, 31};
+  double rows = (double)N_LOCATIONS * 365;
+  int cpus = platform_cpu_count();
+  int max_threads = cpus < 4 ? 4 : cpus;
+
+  printf("timetable export benchmark: %d locations x 365 days, %d processors\n", N_LOCATIONS,
+         cpus);
+  double t_serial = bench_serial_printf(out, locs, N_LOCATIONS);
+  printf("  %-24s %10.0f rows/s\n", "serial printf loop", rows / t_serial);
+
+  double t_one = 0.0;
+  for (int threads = 1; threads <= max_threads; threads *= 2) {
+    double start = now_seconds();
+    if (timetable_export(out, locs, N_LOCATIONS, from, to, threads) != 0) {
+      fprintf(stderr, "export failed\n");
+      return 1;
+    }
+    double t = now_seconds() - start;
+    if (threads == 1)
+      t_one = t;
+    char label[32];
+    snprintf(label, sizeof(label), "export, %d thread%s", threads, threads > 1 ? "s" : "");
+    printf("  %-24s %10.0f rows/s  (%.2fx serial loop, %.2fx 1 thread)\n", label, rows / t,
+           t_serial / t, t_one / t);
+  }
+
+  fclose(out);
+  free(locs);
+  return 0;
+}
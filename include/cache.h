@@ -2,63 +2,220 @@
 #define CACHE_H
 
 #include "config.h"
+#include "prayer_checker.h"
 #include "prayertimes.h"
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#define MAX_TRIGGERS 64
+// Days of triggers kept ahead, starting today
+#define CACHE_WINDOW_DAYS 7
+
+/*
+ * On-disk cache (next_prayer.bin), native byte order checked through
+ * byte_order, laid out so one read or mmap of the file is the whole cache:
+ *   CacheFileHeader (56 bytes)
+ *   trigger_count x CacheTrigger (record_size bytes each)
+ * crc is the CRC-32 of the header (crc field zeroed) and the records.
+ *
+ * Firing does not rewrite it: each consumption appends one int64_t, the due
+ * time of the last trigger consumed, to the fired log (next_prayer.fired),
+ * and cache_load() skips every trigger due at or before the newest entry.
+ * cache_save() writes only the pending triggers and empties the log.
+ */
+
+#define CACHE_FILE_NAME "next_prayer.bin"
+#define CACHE_FIRED_FILE_NAME "next_prayer.fired"
+#define CACHE_MAGIC "MTTRIGGR"
+#define CACHE_VERSION 2
+#define CACHE_BYTE_ORDER 0x01020304u
 
 typedef struct {
   char prayer[16];    // Prayer name (e.g., "fajr")
-  int minute;         // Absolute minute of day (hour*60 + min)
+  int minute;         // Local minute of day the trigger fires at (hour*60 + min)
   int minutes_before; // 0 = exact time, >0 = reminder
-  double prayer_time; // Prayer time in decimal hours
+  double prayer_time; // Prayer time in decimal hours, on the prayer's own day
+  time_t due;         // Start of the trigger minute (epoch)
 } CacheTrigger;
 
 typedef struct {
-  char date[16]; // "YYYY-MM-DD"
-  CacheTrigger triggers[MAX_TRIGGERS];
+  char magic[8];         // CACHE_MAGIC, not NUL-terminated
+  uint32_t version;      // CACHE_VERSION
+  uint32_t byte_order;   // CACHE_BYTE_ORDER as stored by the writer
+  uint64_t config_hash;  // See PrayerCache
+  char date[16];         // "YYYY-MM-DD", NUL-terminated
+  uint32_t record_size;  // sizeof(CacheTrigger) of the writer
+  uint32_t trigger_count;
+  uint32_t crc;
+  uint32_t days;
+} CacheFileHeader;
+
+/*
+ * Triggers for a window of days starting at date, sorted by due time.
+ * triggers[head..trigger_count) are pending; consuming triggers only moves
+ * head. A prayer's reminders are built with the prayer's own day, so one
+ * that falls before midnight (tomorrow's Fajr) lands on the evening before
+ * at its exact time.
+ *
+ * The triggers live in one heap block owned by the cache. Builds reserve
+ * the exact worst case up front, so filling a window is one allocation and
+ * the block is reused by later builds. A zeroed PrayerCache is empty and
+ * valid; release it with cache_free(). Copy with cache_copy(), not `=`.
+ */
+typedef struct {
+  char date[16];        // First day of the window, "YYYY-MM-DD"
+  int days;             // Days built, date included
+  uint64_t config_hash; // config_schedule_hash() of the config the triggers were built from
+  CacheTrigger *triggers;
   int trigger_count;
+  int capacity; // Triggers the block holds
+  int head;     // First pending trigger; the ones before it were consumed
 } PrayerCache;
 
 /**
- * Get cache file path (~/.cache/muslimtify/next_prayer.json)
+ * Release the trigger block and leave an empty cache.
+ */
+void cache_free(PrayerCache *cache);
+
+/**
+ * Make room for at least count triggers, keeping the current ones.
+ * Returns: 0 on success, -1 if out of memory
+ */
+int cache_reserve(PrayerCache *cache, int count);
+
+/**
+ * Replace dst (which must be initialized) with a deep copy of src.
+ * Returns: 0 on success, -1 if out of memory
+ */
+int cache_copy(PrayerCache *dst, const PrayerCache *src);
+
+/**
+ * Get cache file path (~/.cache/muslimtify/next_prayer.bin)
  */
 const char *cache_get_path(void);
 
 /**
- * Load cache from disk.
- * Returns: 0 on success, -1 on error (missing/corrupt/wrong date)
+ * Get fired log path (~/.cache/muslimtify/next_prayer.fired)
+ */
+const char *cache_get_fired_path(void);
+
+/**
+ * Load cache from disk into cache (which must be initialized), validating
+ * the header, size and CRC, then apply the fired log. The records are read
+ * straight into the trigger block. Files in an older format or from another
+ * build layout are rejected.
+ * Returns: 0 on success, -1 on error (missing/corrupt/out of memory)
  */
 int cache_load(PrayerCache *cache);
 
 /**
- * Save cache to disk.
+ * Validate a cache file image of size bytes (e.g. from platform_map_file).
+ * Returns: its header, whose records follow it, or NULL if invalid
+ */
+const CacheFileHeader *cache_file_check(const void *data, size_t size);
+
+/**
+ * Position of date ("YYYY-MM-DD") in the cache window.
+ * Returns: 0 for the first day, -1 if date is outside the window
+ */
+int cache_day_index(const PrayerCache *cache, const char *date);
+
+/**
+ * Whether a loaded cache can be used as-is: its window covers date and it
+ * was built from a config with the same schedule hash as cfg.
+ */
+bool cache_is_current(const PrayerCache *cache, const Config *cfg, const char *date);
+
+/**
+ * Save the pending triggers to disk and empty the fired log.
  * Returns: 0 on success, -1 on error
  */
 int cache_save(const PrayerCache *cache);
 
 /**
- * Delete cache file (invalidate).
+ * Persist the triggers consumed since the last save or load by appending
+ * one record to the fired log; the cache file itself is not rewritten.
+ * Returns: 0 on success (or nothing consumed), -1 on error
+ */
+int cache_save_fired(const PrayerCache *cache);
+
+/**
+ * Number of pending triggers.
+ */
+int cache_pending(const PrayerCache *cache);
+
+/**
+ * Write the cache as JSON, for debugging (`muslimtify check --dump-cache`).
+ */
+void cache_export_json(const PrayerCache *cache, FILE *out);
+
+/**
+ * Delete the cache file and fired log (invalidate).
  */
 void cache_invalidate(void);
 
 /**
- * Build trigger list from current time and prayer times.
- * Only includes triggers at or after current_minute.
- * Returns: number of triggers added
+ * Build one day's trigger list from the given prayer times.
+ * Only includes triggers at or after current_minute of date_str.
+ * Records cfg's schedule hash.
+ * Returns: number of triggers added, -1 if out of memory
  */
 int cache_build_triggers(PrayerCache *cache, const Config *cfg, const struct PrayerTimes *times,
                          int current_minute, const char *date_str);
 
+/**
+ * Build the triggers of days consecutive days from first_date (usually
+ * CACHE_WINDOW_DAYS), computing each day's prayer times from cfg. Only
+ * includes triggers due at or after from. Records cfg's schedule hash.
+ * Returns: number of triggers added, -1 if out of memory
+ */
+int cache_build_window(PrayerCache *cache, const Config *cfg, const char *first_date, int days,
+                       time_t from);
+
+/**
+ * Roll the window forward so it starts at today and again spans
+ * CACHE_WINDOW_DAYS: days before today are forgotten (their triggers have
+ * been fired or dropped) and the missing days are built at the end.
+ * Returns: days added, 0 if the window was full, -1 if today is outside it
+ * or out of memory
+ */
+int cache_extend(PrayerCache *cache, const Config *cfg, const char *today, time_t from);
+
+/**
+ * Replace one prayer's triggers in every day of the window with ones built
+ * from cfg and due at or after from, leaving every other prayer's triggers
+ * untouched. Records cfg's schedule hash.
+ * Returns: number of triggers in the cache, -1 if out of memory
+ */
+int cache_rebuild_prayer(PrayerCache *cache, const Config *cfg, PrayerType type, time_t from);
+
 /**
  * Remove a trigger by index (caller must call cache_save afterward).
  */
 void cache_remove_trigger(PrayerCache *cache, int index);
 
+/**
+ * Consume the first count pending triggers in O(1) by advancing head
+ * (caller must call cache_save_fired or cache_save afterward).
+ */
+void cache_remove_first(PrayerCache *cache, int count);
+
+/**
+ * Binary search the pending triggers for the first one due after t.
+ * Returns: its index, or trigger_count if none
+ */
+int cache_first_due_after(const PrayerCache *cache, time_t t);
+
+/**
+ * One day's prayer times for cfg, indexed by PrayerType.
+ */
+void cache_day_times(const Config *cfg, const struct tm *day, double times[PRAYER_NONE]);
+
 /**
  * Reset cached path (for testing with different XDG_CACHE_HOME).
  */
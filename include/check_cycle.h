@@ -1,12 +1,93 @@
 #ifndef CHECK_CYCLE_H
 #define CHECK_CYCLE_H
 
+#include "cache.h"
+#include "config.h"
+#include "platform.h"
+
+#include <stdbool.h>
+#include <time.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * One-shot check: load config and cache from disk, notify for triggers due
+ * this minute and persist what is left. Used by `muslimtify check`.
+ * Returns: 0 on success, 1 on error
+ */
 int run_check_cycle(void);
 
+/* Delivers one due trigger. The default shows a desktop notification. */
+typedef void (*CheckNotifyFn)(const CacheTrigger *trigger, const Config *cfg, void *user);
+
+/*
+ * Resident state for the long-running daemon: the config, the pending
+ * triggers of the next CACHE_WINDOW_DAYS days, and the stamp config.json was
+ * loaded at. The window is built once and rolled forward by the first check
+ * of each new day, after that check's deliveries, so midnight itself needs
+ * no wake-up or rebuild.
+ * daemon_state_check() re-reads the config only when its stamp changes (or
+ * a reload is requested) and diffs it against the loaded one: location or
+ * calculation changes rebuild the window, reminder or enable changes rebuild
+ * only the affected prayers' triggers, and notification settings rebuild
+ * nothing. A check with nothing to do costs one stat() and no file reads
+ * or writes.
+ */
+typedef struct {
+  Config cfg;
+  bool config_loaded;
+  bool reload_requested;          // Re-read config.json on the next check
+  PlatformFileStamp config_stamp; // Zeroed when config.json did not exist
+  unsigned last_diff;             // CONFIG_DIFF_* bits of the last reload
+  PrayerCache cache;              // Pending triggers from today through the window
+  time_t fired_through;           // Triggers due at or before this were fired or dropped
+  CheckNotifyFn notify;           // NULL: desktop notification
+  void *notify_user;
+} DaemonState;
+
+/**
+ * Initialize an empty state; the first daemon_state_check() loads everything.
+ */
+void daemon_state_init(DaemonState *st);
+
+/**
+ * Free the trigger cache and reset st.
+ */
+void daemon_state_free(DaemonState *st);
+
+/**
+ * Bring st up to date for local time now and deliver the triggers that are
+ * due. Triggers missed by up to cfg.notification_catchup minutes (suspend,
+ * clock step forward) still fire, older ones are dropped, and nothing due at
+ * or before fired_through fires again after the clock steps back. The cache
+ * file is written only when the schedule is rebuilt or the window rolls;
+ * removed triggers append 8 bytes to the fired log.
+ * Returns: 0 on success, 1 on error (st keeps its last good config)
+ */
+int daemon_state_check(DaemonState *st, time_t now);
+
+/**
+ * Force the next daemon_state_check() to re-read config.json even if its
+ * stamp is unchanged (SIGHUP).
+ */
+void daemon_state_request_reload(DaemonState *st);
+
+/**
+ * Whether config.json was saved since st loaded it, i.e. whether the next
+ * daemon_state_check() reloads. Costs one stat().
+ */
+bool daemon_state_config_changed(const DaemonState *st);
+
+/**
+ * When the daemon next has work after a daemon_state_check(st, now): the
+ * due time of the earliest pending trigger, else the next local midnight
+ * to roll the window. A state whose window misses today (load error)
+ * retries at the next minute.
+ */
+time_t daemon_state_next_wake(const DaemonState *st, time_t now);
+
 #ifdef __cplusplus
 }
 #endif
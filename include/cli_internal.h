@@ -22,6 +22,11 @@ static inline const CommandEntry *dispatch_lookup(const CommandEntry *table, int
 
 #define DISPATCH_N(table) ((int)(sizeof(table) / sizeof((table)[0])))
 
+/* Install the optional precomputed sun table (tools/gen_ephemeris), once per
+ * process; the analytic model stays without one. Called only on the paths
+ * that compute prayer times, so other commands never map it. */
+void cli_use_sun_table(void);
+
 int handle_show(int argc, char **argv);
 int handle_check(int argc, char **argv);
 int handle_next(int argc, char **argv);
@@ -35,6 +40,7 @@ int handle_daemon(int argc, char **argv);
 int handle_notification(int argc, char **argv);
 int handle_sound(int argc, char **argv);
 int handle_method(int argc, char **argv);
+int handle_export(int argc, char **argv);
 int handle_version(int argc, char **argv);
 int handle_help(int argc, char **argv);
 
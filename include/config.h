@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,6 +38,7 @@ typedef struct {
 
   // Notification
   int notification_timeout;
+  int notification_catchup; // minutes a missed trigger may still fire late (suspend, clock step)
   char notification_urgency[16];
   bool notification_sound;
   char notification_sound_alarm[16];    // preset name for "it's time" notification
@@ -78,6 +80,26 @@ const char *config_get_path(void);
  */
 bool config_validate(const Config *cfg);
 
+/* config_diff() result bits */
+#define CONFIG_DIFF_PRAYER(i) (1u << (i)) // PrayerConfig i (fajr..isha, PrayerType order)
+#define CONFIG_DIFF_PRAYERS 0x7Fu
+#define CONFIG_DIFF_TIMES (1u << 7) // Location or calculation: every prayer time moves
+#define CONFIG_DIFF_OTHER (1u << 8) // Notification and display settings only
+
+/**
+ * Compare two configs field by field.
+ * Returns: CONFIG_DIFF_* bits for what changed, 0 if equal
+ */
+unsigned config_diff(const Config *a, const Config *b);
+
+/**
+ * 64-bit FNV-1a hash of every field that changes the trigger schedule
+ * (location, calculation, enabled prayers and reminders) plus the program
+ * version and the installed sun table (ephemeris_installed_id), so a cache
+ * built under a different config or engine is detected.
+ */
+uint64_t config_schedule_hash(const Config *cfg);
+
 /**
  * Get prayer config by name (case-insensitive)
  * Returns: pointer to PrayerConfig or NULL if not found
@@ -11,9 +11,43 @@ extern "C" {
  * Pure; exposed for unit testing. */
 int seconds_until_next_minute(time_t now);
 
+/* Wake-ups in one local day; the daemon logs the total when the day ends. */
+typedef struct {
+  int day; /* YYYYMMDD being counted, 0 before the first wake-up */
+  unsigned count;
+} WakeCounter;
+
+/* Count a wake-up at now. When now starts a new local day, stores the
+ * previous day and its total in *finished_day / *finished_count and
+ * returns 1; otherwise returns 0. */
+int wake_counter_tick(WakeCounter *c, time_t now, int *finished_day, unsigned *finished_count);
+
+/* Seconds on the three clocks at one wake-up. */
+typedef struct {
+  long long realtime;  /* CLOCK_REALTIME: wall clock, steps with NTP/settimeofday */
+  long long boottime;  /* CLOCK_BOOTTIME: steady, counts suspend */
+  long long monotonic; /* CLOCK_MONOTONIC: steady, stops during suspend */
+} ClockSample;
+
+/* Discrepancies (seconds) at or above this are logged as clock events. */
+#define CLOCK_JUMP_THRESHOLD 2
+
+/* Split the time between two samples into *stepped, how far the wall clock
+ * moved beyond the time that really passed (negative for a backward step),
+ * and *suspended, how long the machine slept. Pure; exposed for unit
+ * testing. */
+void clock_discontinuity(const ClockSample *prev, const ClockSample *cur, long long *stepped,
+                         long long *suspended);
+
 /* Runs the prayer-notification loop in the foreground until SIGTERM/SIGINT.
- * Calls run_check_cycle() once per wall-clock minute. Returns 0 on clean
- * shutdown. */
+ * One epoll reactor multiplexes a signalfd (SIGTERM/SIGINT stop, SIGHUP
+ * reloads, SIGUSR1 logs latency statistics), an absolute CLOCK_REALTIME
+ * timerfd armed for the next pending trigger (or midnight), an inotify
+ * watch that reloads config.json when it is saved and the query socket
+ * (query.h) CLI commands ask before computing locally. Each cycle publishes
+ * the day's schedule to the shared snapshot (snapshot.h). Keeps a resident
+ * DaemonState and logs clock steps, suspends and wake-ups per day.
+ * Returns 0 on clean shutdown, 1 if the reactor cannot be set up. */
 int run_daemon_loop(void);
 
 #ifdef __cplusplus
@@ -2,6 +2,7 @@
 #define DISPLAY_H
 
 #include "config.h"
+#include "prayer_checker.h"
 #include "prayertimes.h"
 #include <time.h>
 
@@ -32,6 +33,11 @@ void display_prayer_times_json(const struct PrayerTimes *times, const Config *cf
 void display_next_prayer(const struct PrayerTimes *times, const Config *cfg,
                          struct tm *current_time);
 
+/**
+ * Display next prayer info from an already computed answer
+ */
+void display_next_prayer_at(PrayerType next, double prayer_time, int minutes_until);
+
 /**
  * Display location info
  */
@@ -0,0 +1,102 @@
+#ifndef EPHEMERIS_H
+#define EPHEMERIS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Precomputed solar ephemeris: one (declination, equation of time) record per
+ * day at 0h UT, memory-mapped and installed as the prayer-time engine's sun
+ * source (prayer_set_sun_source). Dates outside the table, or a missing or
+ * invalid file, fall back to the analytic model.
+ *
+ * File layout (native byte order, checked through byte_order):
+ *   EphemerisHeader (48 bytes)
+ *   count x { double declination_deg; double equation_of_time_hours; }
+ */
+
+#define EPHEMERIS_FILE_NAME "sun_ephemeris.bin"
+#define EPHEMERIS_MAGIC "MTSUNEPH"
+#define EPHEMERIS_VERSION 1
+#define EPHEMERIS_BYTE_ORDER 0x01020304u
+
+typedef struct {
+  char magic[8];       // EPHEMERIS_MAGIC, not NUL-terminated
+  uint32_t version;    // EPHEMERIS_VERSION
+  uint32_t byte_order; // EPHEMERIS_BYTE_ORDER as stored by the writer
+  double first_jd;     // Julian day (0h UT) of record 0
+  uint32_t count;      // Number of daily records
+  uint32_t reserved;
+  char source[16]; // Model the table was generated from (e.g. "analytic")
+} EphemerisHeader;
+
+typedef struct {
+  const void *map; // NULL when closed
+  size_t map_size;
+  const EphemerisHeader *header;
+  const double *records; // 2 * header->count values
+} EphemerisTable;
+
+/* Daily solar values for ephemeris_write(). */
+typedef void (*EphemerisSourceFn)(double jd, double *declination, double *equation_of_time);
+
+/**
+ * Get table path (~/.cache/muslimtify/sun_ephemeris.bin)
+ */
+const char *ephemeris_get_path(void);
+
+/**
+ * Write a table covering Jan 1 of first_year through Dec 31 of last_year,
+ * sampling source once per day. source_name is stored in the header.
+ * Returns: 0 on success, -1 on error
+ */
+int ephemeris_write(const char *path, int first_year, int last_year, EphemerisSourceFn source,
+                    const char *source_name);
+
+/**
+ * Map and validate a table.
+ * Returns: 0 on success, -1 if missing or invalid (table left closed)
+ */
+int ephemeris_open(EphemerisTable *table, const char *path);
+
+/**
+ * Unmap a table opened by ephemeris_open().
+ */
+void ephemeris_close(EphemerisTable *table);
+
+/**
+ * Declination (degrees) and equation of time (hours) at jd. Whole days are
+ * read directly; fractional days use 4-point Lagrange interpolation.
+ * Returns: 1 if jd is inside the table, 0 otherwise
+ */
+int ephemeris_lookup(const EphemerisTable *table, double jd, double *declination,
+                     double *equation_of_time);
+
+/**
+ * Map the table at path and install it as the engine's sun source,
+ * replacing any table installed before.
+ * Returns: 0 on success, -1 if missing or invalid (analytic model stays)
+ */
+int ephemeris_install(const char *path);
+
+/**
+ * Remove the installed table and restore the analytic model.
+ */
+void ephemeris_uninstall(void);
+
+/**
+ * Identity of the installed table: a hash of its header and file stamp, so a
+ * regenerated or replaced table gets a new one.
+ * Returns: the id, or 0 while the analytic model is in use
+ */
+uint64_t ephemeris_installed_id(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EPHEMERIS_H
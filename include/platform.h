@@ -83,11 +83,53 @@ int platform_file_delete(const char *path);
  */
 int platform_atomic_rename(const char *src, const char *dst);
 
+/* Modification time and size of a file, compared to detect changes without reading it. */
+typedef struct {
+  long long mtime_ns;
+  long long size;
+} PlatformFileStamp;
+
+/**
+ * Stat a file into *stamp. Returns 0 on success, -1 if the file is missing.
+ */
+int platform_file_stamp(const char *path, PlatformFileStamp *stamp);
+
+/**
+ * Map a whole file read-only into memory. Returns the base address and stores the length in
+ * *size, or NULL if the file is missing, empty or cannot be mapped. Release with
+ * platform_unmap_file().
+ */
+const void *platform_map_file(const char *path, size_t *size);
+
+/**
+ * Release a mapping returned by platform_map_file().
+ */
+void platform_unmap_file(const void *addr, size_t size);
+
+/**
+ * Number of online processors (at least 1).
+ */
+int platform_cpu_count(void);
+
+typedef void (*PlatformThreadFn)(void *arg, int index);
+
+/**
+ * Run fn(arg, i) for i in [0, nthreads) concurrently and wait for all of them. Index 0 runs on the
+ * calling thread. An index whose thread cannot be started runs on the caller after the others.
+ */
+void platform_run_threads(int nthreads, PlatformThreadFn fn, void *arg);
+
 /**
  * Thread-safe localtime. Wraps localtime_r (POSIX) or localtime_s (MSVC).
  */
 void platform_localtime(const time_t *t, struct tm *result);
 
+/**
+ * Sleep until time(NULL) reaches t; returns at once if it already has. On POSIX the
+ * deadline is absolute on CLOCK_REALTIME, so it holds across clock steps and suspend.
+ */
+void platform_sleep_until(time_t t);
+
 /**
  * Check if a FILE stream is a terminal. Returns 1 if tty, 0 otherwise.
  */
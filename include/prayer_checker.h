@@ -3,6 +3,7 @@
 
 #include "config.h"
 #include "prayertimes.h"
+#include <stdint.h>
 #include <time.h>
 
 #ifdef __cplusplus
@@ -26,8 +27,116 @@ typedef struct {
   double prayer_time; // Actual prayer time (hours)
 } PrayerMatch;
 
+/*
+ * The schedule settings of a Config compiled once for the loops that walk
+ * every prayer: an enabled-prayer bitmask and every reminder packed into
+ * one array, indexed by PrayerType instead of the seven named PrayerConfig
+ * fields. Prayer i's reminders are reminders[reminder_first[i] ..
+ * reminder_first[i + 1]), sorted so the earliest (largest offset) fires first.
+ */
+typedef struct {
+  unsigned enabled; // Bit i set: PrayerType i is enabled
+  uint8_t reminder_first[PRAYER_NONE + 1];
+  int reminders[PRAYER_NONE * MAX_REMINDERS];
+} SchedulePlan;
+
+/**
+ * Compile cfg's prayer switches and reminders. Unused entries are zero, so
+ * two plans compare with memcmp.
+ */
+void schedule_plan_build(SchedulePlan *plan, const Config *cfg);
+
+/**
+ * Whether type is enabled in plan.
+ */
+bool schedule_plan_enabled(const SchedulePlan *plan, PrayerType type);
+
+/**
+ * type's reminders in minutes before, earliest first.
+ * Returns: reminder count, *reminders points into plan
+ */
+int schedule_plan_reminders(const SchedulePlan *plan, PrayerType type, const int **reminders);
+
+/**
+ * Copy times into an array indexed by PrayerType.
+ */
+void prayer_times_unpack(const struct PrayerTimes *times, double out[PRAYER_NONE]);
+
+#define MINUTES_PER_DAY (24 * 60)
+#define MINUTE_MAP_WORDS (MINUTES_PER_DAY / 32)
+#define MINUTE_MAP_SLOTS (PRAYER_NONE * (1 + MAX_REMINDERS))
+
+typedef struct {
+  uint8_t type;           // PrayerType
+  int16_t minutes_before; // 0 = exact time, >0 = reminder
+} MinuteTrigger;
+
+/*
+ * One day's schedule compiled for polling: a 1440-bit bitmap (180 bytes)
+ * with a bit for every minute that has a prayer or reminder, plus a
+ * minute->trigger index. "Is anything due at minute m" is one bit test and
+ * the next due minute is a find-first-set scan. The triggers of set minute k
+ * (counting set bits from midnight) are triggers[first[k]..first[k + 1]),
+ * in prayer_check_current() priority order; rank[w] counts the set bits
+ * before word w, so k is a popcount away. Build once per day and config.
+ */
+typedef struct {
+  uint32_t bits[MINUTE_MAP_WORDS];
+  uint8_t rank[MINUTE_MAP_WORDS];
+  uint8_t first[MINUTE_MAP_SLOTS + 1];
+  MinuteTrigger triggers[MINUTE_MAP_SLOTS];
+  double prayer_time[PRAYER_NONE]; // Hours, as given to prayer_map_build()
+} MinuteMap;
+
+/**
+ * Compile the enabled prayers and reminders of one day. Minutes use the
+ * same rounding as prayer_check_current(); a reminder before midnight
+ * wraps to the end of the day.
+ */
+void prayer_map_build(MinuteMap *map, const SchedulePlan *plan, const struct PrayerTimes *times);
+
+/**
+ * Whether any trigger is at minute of day (0-1439).
+ */
+bool prayer_map_due(const MinuteMap *map, int minute);
+
+/**
+ * First minute of day at or after minute with a trigger.
+ * Returns: minute (0-1439), -1 if nothing is left today
+ */
+int prayer_map_next(const MinuteMap *map, int minute);
+
+/**
+ * Triggers at minute of day, highest priority first.
+ * Returns: trigger count (0 if none), *triggers set when non-zero
+ */
+int prayer_map_lookup(const MinuteMap *map, int minute, const MinuteTrigger **triggers);
+
 /**
- * Check if current time matches any prayer time or reminder
+ * prayer_check_current() against a compiled map.
+ */
+PrayerMatch prayer_map_check(const MinuteMap *map, int minute);
+
+/* The last schedule prayer_check_cached() compiled. Zero-initialize. */
+typedef struct {
+  SchedulePlan plan;
+  struct PrayerTimes times;
+  MinuteMap map;
+  bool valid;
+} PrayerCheckCache;
+
+/**
+ * prayer_check_current() with a caller-owned cache: the map in cache is
+ * recompiled only when the times or prayer settings change. Callers that
+ * need their own cache, e.g. one per thread, use this.
+ */
+PrayerMatch prayer_check_cached(PrayerCheckCache *cache, const Config *cfg,
+                                const struct tm *current_time, const struct PrayerTimes *times);
+
+/**
+ * Check if current time matches any prayer time or reminder.
+ * prayer_check_cached() on a single static cache, so it is neither
+ * reentrant nor thread-safe.
  * Returns: PrayerMatch with type and minutes_before
  */
 PrayerMatch prayer_check_current(const Config *cfg, struct tm *current_time,
@@ -59,6 +168,12 @@ const PrayerConfig *prayer_get_config(const Config *cfg, PrayerType type);
 PrayerType prayer_get_next(const Config *cfg, struct tm *now, struct PrayerTimes *times,
                            int *minutes_until);
 
+/**
+ * prayer_get_next() for a compiled plan and unpacked times.
+ */
+PrayerType prayer_plan_next(const SchedulePlan *plan, const double times[PRAYER_NONE],
+                            const struct tm *now, int *minutes_until);
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,6 +8,15 @@ extern "C" {
 #define _USE_MATH_DEFINES
 #include <string.h>
 
+/* Define PRAYERTIMES_STATIC together with PRAYERTIMES_IMPLEMENTATION to give
+ * the engine internal linkage, so a translation unit can carry its own copy
+ * (e.g. a PRAYERTIMES_FAST_TRIG build) next to the one linked elsewhere. */
+#ifdef PRAYERTIMES_STATIC
+#define PRAYERTIMES_DEF static inline
+#else
+#define PRAYERTIMES_DEF
+#endif
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -100,17 +109,108 @@ struct PrayerTimes {
   double isha;
 };
 
-void format_time_hm(double timeHours, char *outBuffer, size_t bufSize);
-
-void format_time_hms(double timeHours, char *outBuffer, size_t bufSize);
-
-const MethodParams *method_params_get(CalcMethod method);
-CalcMethod method_from_string(const char *name);
-const char *method_to_string(CalcMethod method);
-
-struct PrayerTimes calculate_prayer_times(int year, int month, int day, double latitude,
-                                          double longitude, double timezone,
-                                          const MethodParams *params);
+/* Solar ephemeris for one date. Depends only on the date, so it can be
+ * computed once and shared by every location and every method. */
+typedef struct {
+  double jd;               /* Julian day (0h UT) */
+  double declination;      /* degrees */
+  double equation_of_time; /* hours */
+  double sin_decl;
+  double cos_decl;
+} SunState;
+
+struct PrayerLocationCtx;
+
+/* One day's times for a prepared location; see prayer_kernel_get(). */
+typedef struct PrayerTimes (*PrayerKernelFn)(const SunState *sun,
+                                             const struct PrayerLocationCtx *ctx);
+
+/* Per-location constants, built once by prayer_location_ctx_init() and reused
+ * for every day at that site. Holds the latitude trig, longitude / 15 and the
+ * sines of the method's fixed sun altitudes, so the per-day path needs only
+ * one acos per event plus one tan for Asr. */
+typedef struct PrayerLocationCtx {
+  double latitude;
+  double sin_lat;
+  double cos_lat;
+  double lon_hours; /* longitude / 15 */
+  double timezone;
+  MethodParams params;
+  double sin_alt_sunrise; /* sin(-REFRACTION_CORRECTION) */
+  double sin_alt_dhuha;   /* sin(DHUHA_ALTITUDE) */
+  double sin_alt_fajr;    /* sin(-fajr_angle) */
+  double sin_alt_isha;    /* sin(-isha_angle) */
+  PrayerKernelFn kernel;  /* specialized for params when they match a catalogue method */
+} PrayerLocationCtx;
+
+PRAYERTIMES_DEF void format_time_hm(double timeHours, char *outBuffer, size_t bufSize);
+
+PRAYERTIMES_DEF void format_time_hms(double timeHours, char *outBuffer, size_t bufSize);
+
+PRAYERTIMES_DEF const MethodParams *method_params_get(CalcMethod method);
+PRAYERTIMES_DEF CalcMethod method_from_string(const char *name);
+PRAYERTIMES_DEF const char *method_to_string(CalcMethod method);
+
+PRAYERTIMES_DEF struct PrayerTimes calculate_prayer_times(int year, int month, int day,
+                                                          double latitude, double longitude,
+                                                          double timezone,
+                                                          const MethodParams *params);
+
+/* Two-stage API: compute the sun's state once per date, then derive the
+ * times for any number of locations from it. calculate_prayer_times() is
+ * equivalent to calling both stages for a single location. */
+PRAYERTIMES_DEF SunState sun_state_for_date(int year, int month, int day);
+PRAYERTIMES_DEF struct PrayerTimes prayer_times_from_sun_state(const SunState *sun, double latitude,
+                                                               double longitude, double timezone,
+                                                               const MethodParams *params);
+
+/* Julian day (0h UT) of a Gregorian date, as in SunState.jd, without
+ * computing the sun. */
+PRAYERTIMES_DEF double julian_day_for_date(int year, int month, int day);
+
+/* Optional replacement for the built-in solar model, e.g. a precomputed table
+ * (see ephemeris.h). fn fills the declination (degrees) and equation of time
+ * (hours) for a Julian day and returns nonzero, or returns 0 to fall back to
+ * the analytic formula for that day. Pass NULL to remove. Not thread-safe:
+ * install it before computing times. */
+typedef int (*PrayerSunSourceFn)(double jd, double *declination, double *equation_of_time,
+                                 void *user);
+PRAYERTIMES_DEF void prayer_set_sun_source(PrayerSunSourceFn fn, void *user);
+
+/* The built-in analytic solar model, bypassing any installed sun source. */
+PRAYERTIMES_DEF void sun_position_analytic(double jd, double *declination,
+                                           double *equation_of_time);
+
+PRAYERTIMES_DEF void prayer_location_ctx_init(PrayerLocationCtx *ctx, double latitude,
+                                              double longitude, double timezone,
+                                              const MethodParams *params);
+PRAYERTIMES_DEF struct PrayerTimes prayer_times_from_ctx(const SunState *sun,
+                                                         const PrayerLocationCtx *ctx);
+
+/* Kernels behind prayer_times_from_ctx(). Each catalogue method has one with
+ * its angles, intervals and ihtiyat compiled in, so the interval/ihtiyat
+ * branches and the altitude sines fold away; only asr_shadow (madhab) is read
+ * from ctx. prayer_location_ctx_init() picks the kernel whose constants equal
+ * the params, else the generic one that reads everything from ctx->params.
+ * prayer_kernel_get(CALC_CUSTOM) returns the generic kernel. */
+PRAYERTIMES_DEF PrayerKernelFn prayer_kernel_get(CalcMethod method);
+PRAYERTIMES_DEF struct PrayerTimes prayer_times_generic(const SunState *sun,
+                                                        const PrayerLocationCtx *ctx);
+
+/* UTC offset (hours) in effect on a calendar date; lets range callers honor DST. */
+typedef double (*PrayerTzFn)(int year, int month, int day, void *user);
+
+/* Fill out[0..n_days) with the times for n_days consecutive dates starting at
+ * year-month-day. The Julian day is stepped incrementally and the location
+ * context is built once for the whole range. When tz_fn is NULL every day uses
+ * `timezone`; otherwise tz_fn(y, m, d, tz_user) supplies each day's offset.
+ * Returns the number of days written (0 on invalid arguments, including a
+ * start date that does not exist). */
+PRAYERTIMES_DEF int calculate_prayer_times_range(int year, int month, int day, int n_days,
+                                                 double latitude, double longitude, double timezone,
+                                                 PrayerTzFn tz_fn, void *tz_user,
+                                                 const MethodParams *params,
+                                                 struct PrayerTimes *out);
 
 #ifdef PRAYERTIMES_IMPLEMENTATION
 
@@ -118,9 +218,193 @@ struct PrayerTimes calculate_prayer_times(int year, int month, int day, double l
 #include <stdbool.h>
 #include <stdio.h>
 
+/* -- Trigonometry -------------------------------------------------------- */
+
+/* The per-day path (sun_position, hour angles, Asr) goes through pt_* wrappers.
+ * By default they are libm. With PRAYERTIMES_FAST_TRIG they are the fdlibm
+ * minimax kernels below, inlined and without libm's large-argument reduction.
+ * Each is within 1e-15 of libm on the ranges used here, which keeps every
+ * event within 1 µs of time of the libm build (measured worst case 4 ns over
+ * 1900-2100, latitudes ±65°; see tests/test_prayertimes_fast_trig.c). Only a
+ * cos(H) landing within ~1e-15 of ±1 can fall on the other side of the polar
+ * day/night fallback. */
+#ifdef PRAYERTIMES_FAST_TRIG
+
+/* Cody-Waite split of pi/2 (fdlibm pio2_1 / pio2_1t); exact for |n| < 2^20 */
+#define PT_PIO2_HI 1.57079632673412561417e+00
+#define PT_PIO2_LO 6.07710050650619224932e-11
+
+static inline void pt_sincos(double x, double *s_out, double *c_out) {
+  /* Round to the nearest quadrant with a conversion rather than floor(), which
+   * is a libm call unless SSE4.1 is enabled */
+  double fn = x * (2.0 / M_PI);
+  long long n = (long long)(fn < 0.0 ? fn - 0.5 : fn + 0.5);
+  double r = (x - (double)n * PT_PIO2_HI) - (double)n * PT_PIO2_LO;
+  double z = r * r;
+
+  double s = r + r * z *
+                     (-1.66666666666666324348e-01 +
+                      z * (8.33333333332248946124e-03 +
+                           z * (-1.98412698298579493134e-04 +
+                                z * (2.75573137070700676789e-06 +
+                                     z * (-2.50507602534068634195e-08 +
+                                          z * 1.58969099521155010221e-10)))));
+  double c = 1.0 - 0.5 * z +
+             z * z *
+                 (4.16666666666666019037e-02 +
+                  z * (-1.38888888888741095749e-03 +
+                       z * (2.48015872894767294178e-05 +
+                            z * (-2.75573143513906633035e-07 +
+                                 z * (2.08757232129817482790e-09 +
+                                      z * -1.13596475577881948265e-11)))));
+
+  /* Quadrant n mod 4: odd quadrants swap sin and cos, then fix the signs */
+  double sq = (n & 1) ? c : s;
+  double cq = (n & 1) ? s : c;
+  *s_out = (n & 2) ? -sq : sq;
+  *c_out = ((n + 1) & 2) ? -cq : cq;
+}
+
+static inline double pt_sin(double x) {
+  double s, c;
+  pt_sincos(x, &s, &c);
+  return s;
+}
+
+static inline double pt_cos(double x) {
+  double s, c;
+  pt_sincos(x, &s, &c);
+  return c;
+}
+
+static inline double pt_tan(double x) {
+  double s, c;
+  pt_sincos(x, &s, &c);
+  return s / c;
+}
+
+/* asin/acos rational kernel R(z) = (asin(sqrt z) - sqrt z) / sqrt z, z <= 1/4 */
+static inline double pt_asin_r(double z) {
+  double p = z * (1.66666666666666657415e-01 +
+                  z * (-3.25565818622400915405e-01 +
+                       z * (2.01212532134862925881e-01 +
+                            z * (-4.00555345006794114027e-02 +
+                                 z * (7.91534994289814532176e-04 +
+                                      z * 3.47933107596021167570e-05)))));
+  double q = 1.0 + z * (-2.40339491173441421878e+00 +
+                        z * (2.02094576023350569471e+00 +
+                             z * (-6.88283971605453293030e-01 + z * 7.70381505559019352791e-02)));
+  return p / q;
+}
+
+static inline double pt_asin(double x) {
+  double ax = fabs(x);
+  if (!(ax <= 1.0))
+    return NAN;
+  if (ax < 0.5)
+    return x + x * pt_asin_r(x * x);
+  double z = (1.0 - ax) * 0.5;
+  double s = sqrt(z);
+  double r = (M_PI / 2.0) - 2.0 * (s + s * pt_asin_r(z));
+  return x < 0.0 ? -r : r;
+}
+
+static inline double pt_acos(double x) {
+  double ax = fabs(x);
+  if (!(ax <= 1.0))
+    return NAN;
+  if (ax < 0.5)
+    return (M_PI / 2.0) - (x + x * pt_asin_r(x * x));
+  double z = (1.0 - ax) * 0.5;
+  double s = sqrt(z);
+  double r = 2.0 * (s + s * pt_asin_r(z));
+  return x < 0.0 ? M_PI - r : r;
+}
+
+/* atan with fdlibm's four-interval argument reduction */
+static inline double pt_atan(double x) {
+  static const double atan_hi[4] = {4.63647609000806093515e-01, 7.85398163397448278999e-01,
+                                    9.82793723247329054082e-01, 1.57079632679489655800e+00};
+  static const double atan_lo[4] = {2.26987774529616870924e-17, 3.06161699786838301793e-17,
+                                    1.39033110312309984516e-17, 6.12323399573676603587e-17};
+  double ax = fabs(x);
+  int id;
+  if (ax < 0.4375) {
+    id = -1;
+  } else if (ax < 0.6875) {
+    id = 0;
+    ax = (2.0 * ax - 1.0) / (2.0 + ax);
+  } else if (ax < 1.1875) {
+    id = 1;
+    ax = (ax - 1.0) / (ax + 1.0);
+  } else if (ax < 2.4375) {
+    id = 2;
+    ax = (ax - 1.5) / (1.0 + 1.5 * ax);
+  } else {
+    id = 3;
+    ax = -1.0 / ax;
+  }
+  double z = ax * ax;
+  double w = z * z;
+  double s1 = z * (3.33333333333329318027e-01 +
+                   w * (1.42857142725034663711e-01 +
+                        w * (9.09088713343650656196e-02 +
+                             w * (6.66107313738753120669e-02 +
+                                  w * (4.97687799461593236017e-02 +
+                                       w * 1.62858201153657823623e-02)))));
+  double s2 = w * (-1.99999999998764832476e-01 +
+                   w * (-1.11111104054623557880e-01 +
+                        w * (-7.69187620504482999495e-02 +
+                             w * (-5.83357013379057348645e-02 + w * -3.65315727442169155270e-02))));
+  double r = id < 0 ? ax - ax * (s1 + s2) : atan_hi[id] - ((ax * (s1 + s2) - atan_lo[id]) - ax);
+  return x < 0.0 ? -r : r;
+}
+
+static inline double pt_atan2(double y, double x) {
+  if (x > 0.0)
+    return pt_atan(y / x);
+  if (x < 0.0)
+    return y < 0.0 ? pt_atan(y / x) - M_PI : pt_atan(y / x) + M_PI;
+  return y < 0.0 ? -(M_PI / 2.0) : (y > 0.0 ? (M_PI / 2.0) : 0.0);
+}
+
+/* |x / y| < 2^63, which holds for the day counts and degrees used here */
+static inline double pt_fmod(double x, double y) {
+  return x - y * (double)(long long)(x / y);
+}
+
+#undef PT_PIO2_HI
+#undef PT_PIO2_LO
+
+#else
+
+static inline double pt_sin(double x) {
+  return sin(x);
+}
+static inline double pt_cos(double x) {
+  return cos(x);
+}
+static inline double pt_tan(double x) {
+  return tan(x);
+}
+static inline double pt_asin(double x) {
+  return asin(x);
+}
+static inline double pt_acos(double x) {
+  return acos(x);
+}
+static inline double pt_atan2(double y, double x) {
+  return atan2(y, x);
+}
+static inline double pt_fmod(double x, double y) {
+  return fmod(x, y);
+}
+
+#endif /* PRAYERTIMES_FAST_TRIG */
+
 // Helper: normalize angle to [0,360)
 static double normalize_deg(double angle) {
-  double a = fmod(angle, 360.0);
+  double a = pt_fmod(angle, 360.0);
   if (a < 0)
     a += 360.0;
   return a;
@@ -128,40 +412,45 @@ static double normalize_deg(double angle) {
 
 /* -- Method parameter table ------------------------------------------- */
 
+/* Fixed catalogue methods, expanded into METHOD_TABLE, METHOD_KEYS and one
+ * specialized kernel each. CALC_CUSTOM is listed separately because its angles
+ * come from the config file.
+ *
+ * X(id, key, name, fajr_angle, isha_angle, isha_interval, maghrib_interval, ihtiyat) */
+#define PRAYERTIMES_METHODS(X)                                                                     \
+  X(CALC_MWL, mwl, "Muslim World League", 18.0, 17.0, 0, 0, 0)                                     \
+  X(CALC_MAKKAH, makkah, "Umm al-Qura, Makkah", 18.5, 0, 90, 0, 0)                                 \
+  X(CALC_ISNA, isna, "ISNA", 15.0, 15.0, 0, 0, 0)                                                  \
+  X(CALC_EGYPT, egypt, "Egyptian General Authority", 19.5, 17.5, 0, 0, 0)                          \
+  X(CALC_KARACHI, karachi, "Univ. Islamic Sciences, Karachi", 18.0, 18.0, 0, 0, 0)                 \
+  X(CALC_TURKEY, turkey, "Diyanet, Turkey", 18.0, 17.0, 0, 0, 0)                                   \
+  X(CALC_SINGAPORE, singapore, "MUIS, Singapore", 20.0, 18.0, 0, 0, 0)                             \
+  X(CALC_JAKIM, jakim, "JAKIM, Malaysia", 20.0, 18.0, 0, 0, 0)                                     \
+  X(CALC_KEMENAG, kemenag, "KEMENAG, Indonesia", 20.0, 18.0, 0, 0, 2)                              \
+  X(CALC_FRANCE, france, "UOIF, France", 12.0, 12.0, 0, 0, 0)                                      \
+  X(CALC_RUSSIA, russia, "Spiritual Admin., Russia", 16.0, 15.0, 0, 0, 0)                          \
+  X(CALC_DUBAI, dubai, "GAIAE, Dubai", 18.2, 18.2, 0, 0, 0)                                        \
+  X(CALC_QATAR, qatar, "Min. of Awqaf, Qatar", 18.0, 0, 90, 0, 0)                                  \
+  X(CALC_KUWAIT, kuwait, "Min. of Awqaf, Kuwait", 18.0, 17.5, 0, 0, 0)                             \
+  X(CALC_JORDAN, jordan, "Min. of Awqaf, Jordan", 18.0, 18.0, 0, 0, 5)                             \
+  X(CALC_GULF, gulf, "Gulf Region", 19.5, 0, 90, 0, 0)                                             \
+  X(CALC_TUNISIA, tunisia, "Min. of Religious Affairs, Tunisia", 18.0, 18.0, 0, 0, 0)              \
+  X(CALC_ALGERIA, algeria, "Min. of Religious Affairs, Algeria", 18.0, 17.0, 0, 0, 0)              \
+  X(CALC_MOROCCO, morocco, "Min. of Habous, Morocco", 19.0, 17.0, 0, 0, 0)                         \
+  X(CALC_PORTUGAL, portugal, "Comunidade Islamica de Lisboa", 18.0, 0, 77, 3, 0)                   \
+  X(CALC_MOONSIGHTING, moonsighting, "Moonsighting Committee", 18.0, 18.0, 0, 3, 0)
+
+#define PT_METHOD_PARAMS(id, key, name, fajr, isha, isha_iv, maghrib_iv, iht)                      \
+  [id] = {name, fajr, isha, isha_iv, maghrib_iv, ASR_STANDARD, MIDNIGHT_STANDARD, iht},
+
 static const MethodParams METHOD_TABLE[CALC_COUNT] = {
-    [CALC_MWL] = {"Muslim World League", 18.0, 17.0, 0, 0, ASR_STANDARD, MIDNIGHT_STANDARD, 0},
-    [CALC_MAKKAH] = {"Umm al-Qura, Makkah", 18.5, 0, 90, 0, ASR_STANDARD, MIDNIGHT_STANDARD, 0},
-    [CALC_ISNA] = {"ISNA", 15.0, 15.0, 0, 0, ASR_STANDARD, MIDNIGHT_STANDARD, 0},
-    [CALC_EGYPT] = {"Egyptian General Authority", 19.5, 17.5, 0, 0, ASR_STANDARD, MIDNIGHT_STANDARD,
-                    0},
-    [CALC_KARACHI] = {"Univ. Islamic Sciences, Karachi", 18.0, 18.0, 0, 0, ASR_STANDARD,
-                      MIDNIGHT_STANDARD, 0},
-    [CALC_TURKEY] = {"Diyanet, Turkey", 18.0, 17.0, 0, 0, ASR_STANDARD, MIDNIGHT_STANDARD, 0},
-    [CALC_SINGAPORE] = {"MUIS, Singapore", 20.0, 18.0, 0, 0, ASR_STANDARD, MIDNIGHT_STANDARD, 0},
-    [CALC_JAKIM] = {"JAKIM, Malaysia", 20.0, 18.0, 0, 0, ASR_STANDARD, MIDNIGHT_STANDARD, 0},
-    [CALC_KEMENAG] = {"KEMENAG, Indonesia", 20.0, 18.0, 0, 0, ASR_STANDARD, MIDNIGHT_STANDARD, 2},
-    [CALC_FRANCE] = {"UOIF, France", 12.0, 12.0, 0, 0, ASR_STANDARD, MIDNIGHT_STANDARD, 0},
-    [CALC_RUSSIA] = {"Spiritual Admin., Russia", 16.0, 15.0, 0, 0, ASR_STANDARD, MIDNIGHT_STANDARD,
-                     0},
-    [CALC_DUBAI] = {"GAIAE, Dubai", 18.2, 18.2, 0, 0, ASR_STANDARD, MIDNIGHT_STANDARD, 0},
-    [CALC_QATAR] = {"Min. of Awqaf, Qatar", 18.0, 0, 90, 0, ASR_STANDARD, MIDNIGHT_STANDARD, 0},
-    [CALC_KUWAIT] = {"Min. of Awqaf, Kuwait", 18.0, 17.5, 0, 0, ASR_STANDARD, MIDNIGHT_STANDARD, 0},
-    [CALC_JORDAN] = {"Min. of Awqaf, Jordan", 18.0, 18.0, 0, 0, ASR_STANDARD, MIDNIGHT_STANDARD, 5},
-    [CALC_GULF] = {"Gulf Region", 19.5, 0, 90, 0, ASR_STANDARD, MIDNIGHT_STANDARD, 0},
-    [CALC_TUNISIA] = {"Min. of Religious Affairs, Tunisia", 18.0, 18.0, 0, 0, ASR_STANDARD,
-                      MIDNIGHT_STANDARD, 0},
-    [CALC_ALGERIA] = {"Min. of Religious Affairs, Algeria", 18.0, 17.0, 0, 0, ASR_STANDARD,
-                      MIDNIGHT_STANDARD, 0},
-    [CALC_MOROCCO] = {"Min. of Habous, Morocco", 19.0, 17.0, 0, 0, ASR_STANDARD, MIDNIGHT_STANDARD,
-                      0},
-    [CALC_PORTUGAL] = {"Comunidade Islamica de Lisboa", 18.0, 0, 77, 3, ASR_STANDARD,
-                       MIDNIGHT_STANDARD, 0},
-    [CALC_MOONSIGHTING] = {"Moonsighting Committee", 18.0, 18.0, 0, 3, ASR_STANDARD,
-                           MIDNIGHT_STANDARD, 0},
+    PRAYERTIMES_METHODS(PT_METHOD_PARAMS)
     [CALC_CUSTOM] = {"Custom", 18.0, 17.0, 0, 0, ASR_STANDARD, MIDNIGHT_STANDARD, 0},
 };
 
-const MethodParams *method_params_get(CalcMethod method) {
+#undef PT_METHOD_PARAMS
+
+PRAYERTIMES_DEF const MethodParams *method_params_get(CalcMethod method) {
   if (method < 0 || method >= CALC_COUNT)
     return NULL;
   return &METHOD_TABLE[method];
@@ -174,32 +463,16 @@ typedef struct {
   CalcMethod method;
 } MethodKeyEntry;
 
+#define PT_METHOD_KEY(id, key, name, fajr, isha, isha_iv, maghrib_iv, iht) {#key, id},
+
 static const MethodKeyEntry METHOD_KEYS[] = {
-    {"mwl", CALC_MWL},
-    {"makkah", CALC_MAKKAH},
-    {"isna", CALC_ISNA},
-    {"egypt", CALC_EGYPT},
-    {"karachi", CALC_KARACHI},
-    {"turkey", CALC_TURKEY},
-    {"singapore", CALC_SINGAPORE},
-    {"jakim", CALC_JAKIM},
-    {"kemenag", CALC_KEMENAG},
-    {"france", CALC_FRANCE},
-    {"russia", CALC_RUSSIA},
-    {"dubai", CALC_DUBAI},
-    {"qatar", CALC_QATAR},
-    {"kuwait", CALC_KUWAIT},
-    {"jordan", CALC_JORDAN},
-    {"gulf", CALC_GULF},
-    {"tunisia", CALC_TUNISIA},
-    {"algeria", CALC_ALGERIA},
-    {"morocco", CALC_MOROCCO},
-    {"portugal", CALC_PORTUGAL},
-    {"moonsighting", CALC_MOONSIGHTING},
+    PRAYERTIMES_METHODS(PT_METHOD_KEY)
     {"custom", CALC_CUSTOM},
 };
 
-CalcMethod method_from_string(const char *name) {
+#undef PT_METHOD_KEY
+
+PRAYERTIMES_DEF CalcMethod method_from_string(const char *name) {
   if (!name)
     return CALC_CUSTOM;
   size_t count = sizeof(METHOD_KEYS) / sizeof(METHOD_KEYS[0]);
@@ -210,7 +483,7 @@ CalcMethod method_from_string(const char *name) {
   return CALC_CUSTOM;
 }
 
-const char *method_to_string(CalcMethod method) {
+PRAYERTIMES_DEF const char *method_to_string(CalcMethod method) {
   for (size_t i = 0; i < sizeof(METHOD_KEYS) / sizeof(METHOD_KEYS[0]); i++) {
     if (METHOD_KEYS[i].method == method)
       return METHOD_KEYS[i].key;
@@ -230,6 +503,10 @@ static double julian_day(int year, int month, int day) {
   return jd;
 }
 
+PRAYERTIMES_DEF double julian_day_for_date(int year, int month, int day) {
+  return julian_day(year, month, day);
+}
+
 // Calculate solar declination and equation of time
 static void sun_position(double jd, double *decl, double *eqt) {
   double D = jd - JULIAN_EPOCH;
@@ -237,50 +514,39 @@ static void sun_position(double jd, double *decl, double *eqt) {
   double g = normalize_deg(SUN_MEAN_ANOMALY_OFFSET + SUN_MEAN_ANOMALY_RATE * D);
   double q = normalize_deg(SUN_MEAN_LONGITUDE_OFFSET + SUN_MEAN_LONGITUDE_RATE * D);
 
-  double L = normalize_deg(q + SUN_ECCENTRICITY_AMPLITUDE1 * sin(g * DEG_TO_RAD) +
-                           SUN_ECCENTRICITY_AMPLITUDE2 * sin(2 * g * DEG_TO_RAD));
+  double L = normalize_deg(q + SUN_ECCENTRICITY_AMPLITUDE1 * pt_sin(g * DEG_TO_RAD) +
+                           SUN_ECCENTRICITY_AMPLITUDE2 * pt_sin(2 * g * DEG_TO_RAD));
 
   double e = OBLIQUITY_COEFF - OBLIQUITY_RATE * D;
 
-  double RA = atan2(cos(e * DEG_TO_RAD) * sin(L * DEG_TO_RAD), cos(L * DEG_TO_RAD)) * RAD_TO_DEG;
+  double sin_L = pt_sin(L * DEG_TO_RAD);
+  double RA = pt_atan2(pt_cos(e * DEG_TO_RAD) * sin_L, pt_cos(L * DEG_TO_RAD)) * RAD_TO_DEG;
   RA = normalize_deg(RA);
 
   // Normalize difference to [-180, 180] to handle wrap-around near 0/360 boundary
-  double diff = fmod(q - RA + 180.0, 360.0);
+  double diff = pt_fmod(q - RA + 180.0, 360.0);
   if (diff < 0)
     diff += 360.0;
   diff -= 180.0;
   *eqt = diff / 15.0;
-  *decl = asin(sin(e * DEG_TO_RAD) * sin(L * DEG_TO_RAD)) * RAD_TO_DEG;
-}
-
-// Compute the time difference from solar noon for a given sun altitude angle
-// For angles below horizon (Fajr, Sunrise, Maghrib, Isha): pass positive angle
-// For angles above horizon (Asr): pass negative angle to indicate positive
-// altitude
-static double hour_angle(double lat, double decl, double angle) {
-  double lat_rad = lat * DEG_TO_RAD;
-  double decl_rad = decl * DEG_TO_RAD;
-  double angle_rad = angle * DEG_TO_RAD;
-
-  // Formula: cos(H) = [sin(h) - sin(φ) × sin(δ)] / [cos(φ) × cos(δ)]
-  // For below-horizon events: h is negative, so we use -sin(angle) where angle
-  // is positive For above-horizon events: h is positive, so we use sin(angle)
-  // directly
-  double numerator = -sin(angle_rad) - sin(lat_rad) * sin(decl_rad);
-  double denominator = cos(lat_rad) * cos(decl_rad);
-  double ha = acos(numerator / denominator);
+  *decl = pt_asin(pt_sin(e * DEG_TO_RAD) * sin_L) * RAD_TO_DEG;
+}
+
+// Compute the time difference from solar noon for a given sun altitude, passed
+// as its sine (negative below the horizon):
+//   cos(H) = [sin(h) - sin(φ) × sin(δ)] / [cos(φ) × cos(δ)]
+static double hour_angle(const PrayerLocationCtx *ctx, const SunState *sun, double sin_alt) {
+  double numerator = sin_alt - ctx->sin_lat * sun->sin_decl;
+  double denominator = ctx->cos_lat * sun->cos_decl;
+  double ha = pt_acos(numerator / denominator);
   return ha * RAD_TO_DEG / 15.0; // convert from degrees to hours
 }
 
 // Safe version that checks cos_ha bounds for high-latitude locations
-static double hour_angle_safe(double lat, double decl, double angle, bool *failed) {
-  double lat_rad = lat * DEG_TO_RAD;
-  double decl_rad = decl * DEG_TO_RAD;
-  double angle_rad = angle * DEG_TO_RAD;
-
-  double numerator = -sin(angle_rad) - sin(lat_rad) * sin(decl_rad);
-  double denominator = cos(lat_rad) * cos(decl_rad);
+static double hour_angle_safe(const PrayerLocationCtx *ctx, const SunState *sun, double sin_alt,
+                              bool *failed) {
+  double numerator = sin_alt - ctx->sin_lat * sun->sin_decl;
+  double denominator = ctx->cos_lat * sun->cos_decl;
   double cos_ha = numerator / denominator;
 
   if (cos_ha < -1.0 || cos_ha > 1.0) {
@@ -289,12 +555,12 @@ static double hour_angle_safe(double lat, double decl, double angle, bool *faile
   }
 
   *failed = false;
-  double ha = acos(cos_ha);
+  double ha = pt_acos(cos_ha);
   return ha * RAD_TO_DEG / 15.0;
 }
 
 // Format time (double hours) into "HH:MM"
-void format_time_hm(double timeHours, char *outBuffer, size_t bufSize) {
+PRAYERTIMES_DEF void format_time_hm(double timeHours, char *outBuffer, size_t bufSize) {
   int hours = (int)timeHours;
   double fraction = timeHours - hours;
   int minutes = (int)ceil(fraction * 60.0); // Always round up (Kemenag method)
@@ -310,7 +576,7 @@ void format_time_hm(double timeHours, char *outBuffer, size_t bufSize) {
 }
 
 // Format time into "HH:MM:SS"
-void format_time_hms(double timeHours, char *outBuffer, size_t bufSize) {
+PRAYERTIMES_DEF void format_time_hms(double timeHours, char *outBuffer, size_t bufSize) {
   int hours = (int)timeHours;
   double fraction = timeHours - hours;
   int totalSeconds = (int)(fraction * 3600.0 + 0.5);
@@ -328,17 +594,54 @@ void format_time_hms(double timeHours, char *outBuffer, size_t bufSize) {
   snprintf(outBuffer, bufSize, "%02d:%02d:%02d", hours, minutes, seconds);
 }
 
-struct PrayerTimes calculate_prayer_times(int year, int month, int day, double latitude,
-                                          double longitude, double timezone,
-                                          const MethodParams *params) {
-  double jd = julian_day(year, month, day);
-  double decl, eqt;
-  sun_position(jd, &decl, &eqt);
+static PrayerSunSourceFn sun_source_fn = NULL;
+static void *sun_source_user = NULL;
 
-  double noon = 12.0 + timezone - (longitude / 15.0) - eqt;
+PRAYERTIMES_DEF void prayer_set_sun_source(PrayerSunSourceFn fn, void *user) {
+  sun_source_fn = fn;
+  sun_source_user = user;
+}
+
+PRAYERTIMES_DEF void sun_position_analytic(double jd, double *declination,
+                                           double *equation_of_time) {
+  sun_position(jd, declination, equation_of_time);
+}
+
+static SunState sun_state_for_jd(double jd) {
+  SunState sun;
+  sun.jd = jd;
+  if (!sun_source_fn ||
+      !sun_source_fn(jd, &sun.declination, &sun.equation_of_time, sun_source_user))
+    sun_position(jd, &sun.declination, &sun.equation_of_time);
+  double decl_rad = sun.declination * DEG_TO_RAD;
+  sun.sin_decl = pt_sin(decl_rad);
+  sun.cos_decl = pt_cos(decl_rad);
+  return sun;
+}
+
+PRAYERTIMES_DEF SunState sun_state_for_date(int year, int month, int day) {
+  return sun_state_for_jd(julian_day(year, month, day));
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PT_ALWAYS_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define PT_ALWAYS_INLINE __forceinline
+#else
+#define PT_ALWAYS_INLINE inline
+#endif
+
+// Shared body of the generic and per-method kernels. Method constants are
+// arguments so that each kernel, inlining this with literals, loses the
+// interval/ihtiyat branches and gets the altitude sines folded by the compiler.
+static PT_ALWAYS_INLINE struct PrayerTimes
+prayer_times_body(const SunState *sun, const PrayerLocationCtx *ctx, double sin_alt_sunrise,
+                  double sin_alt_dhuha, double fajr_angle, double sin_alt_fajr, double isha_angle,
+                  double sin_alt_isha, int isha_interval, int maghrib_interval, int ihtiyat) {
+  double noon = 12.0 + ctx->timezone - ctx->lon_hours - sun->equation_of_time;
 
   /* Sunrise & sunset (always use refraction correction) */
-  double ha_sunrise = hour_angle(latitude, decl, REFRACTION_CORRECTION);
+  double ha_sunrise = hour_angle(ctx, sun, sin_alt_sunrise);
   double sunrise = noon - ha_sunrise;
   double sunset = noon + ha_sunrise;
 
@@ -347,53 +650,55 @@ struct PrayerTimes calculate_prayer_times(int year, int month, int day, double l
 
   /* Fajr */
   bool fajr_failed = false;
-  double ha_fajr = hour_angle_safe(latitude, decl, params->fajr_angle, &fajr_failed);
+  double ha_fajr = hour_angle_safe(ctx, sun, sin_alt_fajr, &fajr_failed);
   double fajr = noon - ha_fajr;
   if (fajr_failed) {
     /* Angle-based high-latitude fallback */
-    fajr = sunrise - (params->fajr_angle / 60.0) * night;
+    fajr = sunrise - (fajr_angle / 60.0) * night;
   }
 
   /* Maghrib */
   double maghrib = sunset;
-  if (params->maghrib_interval > 0) {
-    maghrib = sunset + (double)params->maghrib_interval / 60.0;
+  if (maghrib_interval > 0) {
+    maghrib = sunset + (double)maghrib_interval / 60.0;
   }
 
   /* Isha */
   double isha;
-  if (params->isha_angle > 0.0) {
+  if (isha_angle > 0.0) {
     bool isha_failed = false;
-    double ha_isha = hour_angle_safe(latitude, decl, params->isha_angle, &isha_failed);
+    double ha_isha = hour_angle_safe(ctx, sun, sin_alt_isha, &isha_failed);
     isha = noon + ha_isha;
     if (isha_failed) {
-      isha = sunset + (params->isha_angle / 60.0) * night;
+      isha = sunset + (isha_angle / 60.0) * night;
     }
   } else {
     /* Interval-based (e.g. Makkah 90 min after maghrib) */
-    isha = maghrib + (double)params->isha_interval / 60.0;
+    isha = maghrib + (double)isha_interval / 60.0;
   }
 
-  /* Asr */
-  double asr_angle =
-      atan(1.0 / ((double)params->asr_shadow + tan(fabs(latitude - decl) * DEG_TO_RAD))) *
-      RAD_TO_DEG;
-  double ha_asr = hour_angle(latitude, decl, -asr_angle);
+  /* Asr: altitude h with cot(h) = shadow + tan|φ - δ|, so
+   * sin(h) = 1 / sqrt(1 + cot²(h)) without going through atan/sin. */
+  double cot_asr =
+      (double)ctx->params.asr_shadow + pt_tan(fabs(ctx->latitude - sun->declination) * DEG_TO_RAD);
+  double ha_asr = hour_angle(ctx, sun, 1.0 / sqrt(1.0 + cot_asr * cot_asr));
   double asr = noon + ha_asr;
 
   /* Dhuha */
-  double ha_dhuha = hour_angle(latitude, decl, -DHUHA_ALTITUDE);
+  double ha_dhuha = hour_angle(ctx, sun, sin_alt_dhuha);
   double dhuha = noon - ha_dhuha;
 
   /* Apply ihtiyat (precautionary) adjustments */
-  double iht = (double)params->ihtiyat / 60.0;
-  fajr += iht;
-  sunrise -= iht; /* sunrise ihtiyat is inverted */
-  noon += iht;
-  asr += iht;
-  maghrib += iht;
-  isha += iht;
-  /* Dhuha does not get ihtiyat */
+  if (ihtiyat != 0) {
+    double iht = (double)ihtiyat / 60.0;
+    fajr += iht;
+    sunrise -= iht; /* sunrise ihtiyat is inverted */
+    noon += iht;
+    asr += iht;
+    maghrib += iht;
+    isha += iht;
+    /* Dhuha does not get ihtiyat */
+  }
 
   struct PrayerTimes times = {
       .fajr = fajr,
@@ -407,6 +712,141 @@ struct PrayerTimes calculate_prayer_times(int year, int month, int day, double l
 
   return times;
 }
+
+PRAYERTIMES_DEF struct PrayerTimes prayer_times_generic(const SunState *sun,
+                                                        const PrayerLocationCtx *ctx) {
+  const MethodParams *params = &ctx->params;
+  return prayer_times_body(sun, ctx, ctx->sin_alt_sunrise, ctx->sin_alt_dhuha, params->fajr_angle,
+                           ctx->sin_alt_fajr, params->isha_angle, ctx->sin_alt_isha,
+                           params->isha_interval, params->maghrib_interval, params->ihtiyat);
+}
+
+/* One kernel per catalogue method. The sin() calls take constant arguments,
+ * which GCC and Clang evaluate at compile time. */
+#define PT_METHOD_KERNEL(id, key, name, fajr, isha, isha_iv, maghrib_iv, iht)                      \
+  static struct PrayerTimes prayer_kernel_##key(const SunState *sun,                               \
+                                                const PrayerLocationCtx *ctx) {                    \
+    return prayer_times_body(sun, ctx, -sin(REFRACTION_CORRECTION * DEG_TO_RAD),                   \
+                             sin(DHUHA_ALTITUDE * DEG_TO_RAD), fajr, -sin(fajr * DEG_TO_RAD),     \
+                             isha, -sin(isha * DEG_TO_RAD), isha_iv, maghrib_iv, iht);             \
+  }
+
+PRAYERTIMES_METHODS(PT_METHOD_KERNEL)
+
+#undef PT_METHOD_KERNEL
+
+#define PT_METHOD_KERNEL_ENTRY(id, key, name, fajr, isha, isha_iv, maghrib_iv, iht)                \
+  [id] = prayer_kernel_##key,
+
+static const PrayerKernelFn METHOD_KERNELS[CALC_COUNT] = {
+    PRAYERTIMES_METHODS(PT_METHOD_KERNEL_ENTRY)
+    [CALC_CUSTOM] = prayer_times_generic,
+};
+
+#undef PT_METHOD_KERNEL_ENTRY
+
+PRAYERTIMES_DEF PrayerKernelFn prayer_kernel_get(CalcMethod method) {
+  if (method < 0 || method >= CALC_COUNT)
+    return prayer_times_generic;
+  return METHOD_KERNELS[method];
+}
+
+// Kernel for params: a catalogue kernel when every constant it compiles in
+// matches (asr_shadow is read at run time), otherwise the generic one
+static PrayerKernelFn kernel_for_params(const MethodParams *params) {
+  for (int m = 0; m < CALC_CUSTOM; m++) {
+    const MethodParams *t = &METHOD_TABLE[m];
+    if (t->fajr_angle == params->fajr_angle && t->isha_angle == params->isha_angle &&
+        t->isha_interval == params->isha_interval &&
+        t->maghrib_interval == params->maghrib_interval && t->ihtiyat == params->ihtiyat)
+      return METHOD_KERNELS[m];
+  }
+  return prayer_times_generic;
+}
+
+PRAYERTIMES_DEF struct PrayerTimes prayer_times_from_ctx(const SunState *sun,
+                                                         const PrayerLocationCtx *ctx) {
+  return ctx->kernel(sun, ctx);
+}
+
+PRAYERTIMES_DEF void prayer_location_ctx_init(PrayerLocationCtx *ctx, double latitude,
+                                              double longitude, double timezone,
+                                              const MethodParams *params) {
+  double lat_rad = latitude * DEG_TO_RAD;
+  ctx->latitude = latitude;
+  ctx->sin_lat = sin(lat_rad);
+  ctx->cos_lat = cos(lat_rad);
+  ctx->lon_hours = longitude / 15.0;
+  ctx->timezone = timezone;
+  ctx->params = *params;
+  ctx->sin_alt_sunrise = -sin(REFRACTION_CORRECTION * DEG_TO_RAD);
+  ctx->sin_alt_dhuha = sin(DHUHA_ALTITUDE * DEG_TO_RAD);
+  ctx->sin_alt_fajr = -sin(params->fajr_angle * DEG_TO_RAD);
+  ctx->sin_alt_isha = -sin(params->isha_angle * DEG_TO_RAD);
+  ctx->kernel = kernel_for_params(params);
+}
+
+PRAYERTIMES_DEF struct PrayerTimes calculate_prayer_times(int year, int month, int day,
+                                                          double latitude, double longitude,
+                                                          double timezone,
+                                                          const MethodParams *params) {
+  SunState sun = sun_state_for_date(year, month, day);
+  return prayer_times_from_sun_state(&sun, latitude, longitude, timezone, params);
+}
+
+PRAYERTIMES_DEF struct PrayerTimes prayer_times_from_sun_state(const SunState *sun, double latitude,
+                                                               double longitude, double timezone,
+                                                               const MethodParams *params) {
+  PrayerLocationCtx ctx;
+  prayer_location_ctx_init(&ctx, latitude, longitude, timezone, params);
+  return prayer_times_from_ctx(sun, &ctx);
+}
+
+// Days in a Gregorian month, month 1-12
+static int civil_days_in_month(int year, int month) {
+  static const int days_in_month[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  if (month == 2 && ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0))
+    return 29;
+  return days_in_month[month - 1];
+}
+
+// Advance a Gregorian calendar date by one day
+static void civil_next_day(int *year, int *month, int *day) {
+  if (++*day > civil_days_in_month(*year, *month)) {
+    *day = 1;
+    if (++*month > 12) {
+      *month = 1;
+      ++*year;
+    }
+  }
+}
+
+PRAYERTIMES_DEF int calculate_prayer_times_range(int year, int month, int day, int n_days,
+                                                 double latitude, double longitude, double timezone,
+                                                 PrayerTzFn tz_fn, void *tz_user,
+                                                 const MethodParams *params,
+                                                 struct PrayerTimes *out) {
+  if (n_days <= 0 || !params || !out || month < 1 || month > 12 || day < 1 ||
+      day > civil_days_in_month(year, month))
+    return 0;
+
+  PrayerLocationCtx ctx;
+  prayer_location_ctx_init(&ctx, latitude, longitude, timezone, params);
+  double jd = julian_day(year, month, day);
+
+  for (int i = 0; i < n_days; i++) {
+    SunState sun = sun_state_for_jd(jd);
+
+    if (tz_fn)
+      ctx.timezone = tz_fn(year, month, day, tz_user);
+    out[i] = prayer_times_from_ctx(&sun, &ctx);
+
+    jd += 1.0;
+    civil_next_day(&year, &month, &day);
+  }
+
+  return n_days;
+}
 #endif // PRAYERTIMES_IMPLEMENTATION
 
 #ifdef __cplusplus
@@ -0,0 +1,62 @@
+#ifndef PRAYERTIMES_SOA_H
+#define PRAYERTIMES_SOA_H
+
+#include "prayertimes.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Structure-of-arrays output: each pointer addresses n doubles. */
+typedef struct {
+  double *fajr;
+  double *sunrise;
+  double *dhuha;
+  double *dhuhr;
+  double *asr;
+  double *maghrib;
+  double *isha;
+} PrayerTimesSoA;
+
+typedef enum {
+  PRAYER_SIMD_SCALAR, /* libm path, identical to calculate_prayer_times */
+  PRAYER_SIMD_SSE2,   /* 2 lanes, polynomial trig */
+  PRAYER_SIMD_AVX2,   /* 4 lanes, polynomial trig */
+} PrayerSimdIsa;
+
+/**
+ * Best instruction set supported by the running CPU (checked once, cached).
+ */
+PrayerSimdIsa prayer_simd_detect(void);
+
+/**
+ * Human-readable name ("scalar", "sse2", "avx2").
+ */
+const char *prayer_simd_isa_name(PrayerSimdIsa isa);
+
+/**
+ * Times for n locations on one date. lat/lon/tz are arrays of n values
+ * (degrees, degrees, UTC offset in hours); every location uses `params`.
+ * Dispatches to the best instruction set from prayer_simd_detect().
+ *
+ * The vector paths evaluate sin/cos/tan/acos with polynomials; each event
+ * stays within 1 ms of the scalar engine (see tests/test_prayertimes_soa.c).
+ */
+void prayer_times_soa(const SunState *sun, const MethodParams *params, size_t n,
+                      const double *lat, const double *lon, const double *tz,
+                      const PrayerTimesSoA *out);
+
+/**
+ * Same as prayer_times_soa() with an explicit instruction set. Falls back to
+ * the scalar path when `isa` is not available on this build or CPU.
+ */
+void prayer_times_soa_isa(PrayerSimdIsa isa, const SunState *sun, const MethodParams *params,
+                          size_t n, const double *lat, const double *lon, const double *tz,
+                          const PrayerTimesSoA *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PRAYERTIMES_SOA_H */
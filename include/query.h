@@ -0,0 +1,108 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include "check_cycle.h"
+#include "reactor.h"
+
+#include <stddef.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Local query socket. The daemon already holds the parsed config, so it
+ * answers schedule questions for CLI invocations, which then skip reading
+ * config.json and computing the day themselves. One request line per
+ * connection, answered in text lines and closed by the daemon:
+ *
+ *   next                 next <type> <hours> <minutes_until> | none
+ *   today                enabled <mask>, day <YYYY-MM-DD> <7 prayer hours>
+ *   range <date> <days>  enabled <mask>, then <days> day lines from <date>
+ *   stats                uptime, wake-ups, queries, pending triggers, the
+ *                        cache window and one latency line per reactor source,
+ *                        the connected clients' replaced by their serve times
+ *
+ * Every reply starts with "config <path>", the config.json it was computed
+ * from, so a client running against another config ignores it. Failures are
+ * "error <reason>". Prayer types and hours are as in prayer_checker.h.
+ */
+
+#define QUERY_SOCKET_NAME "muslimtify.sock"
+#define QUERY_REQUEST_MAX 128
+#define QUERY_REPLY_MAX 65536
+#define QUERY_RANGE_MAX 366
+#define QUERY_TIMEOUT_MS 100
+#define QUERY_CLIENT_SOURCE "client" // Reactor source name of a connected client
+
+/* What the daemon exposes to query_answer(). */
+typedef struct {
+  const DaemonState *state;
+  const Reactor *reactor; // NULL: no latency lines in stats
+  time_t started;
+  unsigned wakeups_today;
+  unsigned long long queries;
+  const LatencyHistogram *clients; // Serve times of all clients; NULL: no line
+} QueryContext;
+
+/**
+ * Socket path, $XDG_RUNTIME_DIR/muslimtify.sock. The runtime dir is private
+ * to the user; without one there is no socket.
+ * Returns: 0 on success, -1 if XDG_RUNTIME_DIR is unset or the path is too long
+ */
+int query_socket_path(char *buf, size_t size);
+
+/**
+ * Bind and listen on path (mode 0600), replacing a socket left behind by a
+ * daemon that died. The listening fd is non-blocking.
+ * Returns: listening fd, -1 on error (EADDRINUSE: another daemon answers)
+ */
+int query_listen(const char *path);
+
+/**
+ * Accept one pending connection.
+ * Returns: connected fd, -1 when none is pending or on error
+ */
+int query_accept(int listen_fd);
+
+/**
+ * Answer one request line for local time now into out, NUL-terminated.
+ * Pure apart from the prayer-time computation; exposed for unit testing.
+ * Returns: reply length, -1 if it does not fit in size
+ */
+int query_answer(const QueryContext *ctx, const char *request, time_t now, char *out,
+                 size_t size);
+
+/**
+ * Read one request from client_fd, answer it and write the reply, all within
+ * QUERY_TIMEOUT_MS, so a stalled or trickling client cannot hold the daemon.
+ * The caller closes client_fd.
+ * Returns: 0 on success, -1 on a read/write error or timeout
+ */
+int query_serve(int client_fd, const QueryContext *ctx, time_t now);
+
+/**
+ * Send request to the daemon at path and read the reply into reply,
+ * NUL-terminated, waiting at most timeout_ms for the whole exchange.
+ * Returns: 0 on a reply for this user's config.json, -1 otherwise (no
+ * daemon, timeout, error reply, other config)
+ */
+int query_request_at(const char *path, const char *request, char *reply, size_t size,
+                     int timeout_ms);
+
+/**
+ * query_request_at() on query_socket_path().
+ */
+int query_request(const char *request, char *reply, size_t size, int timeout_ms);
+
+/**
+ * The line after the "config" line of a successful reply.
+ */
+const char *query_reply_body(const char *reply);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // QUERY_H
@@ -0,0 +1,95 @@
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Single-threaded epoll reactor. Every event source the daemon has (signals,
+ * timers, file watches, sockets) is a file descriptor with a handler, so a
+ * new source is one reactor_add() call rather than another thread or poll.
+ * Each source keeps a histogram of its reaction latency: the time from the
+ * reactor waking up to the source's handler returning.
+ */
+
+#define LATENCY_BUCKETS 32
+
+/* Log2 histogram: bucket 0 holds samples under 1 us, bucket k (k >= 1)
+ * samples in [2^(k-1), 2^k) us; the last bucket also takes everything larger. */
+typedef struct {
+  uint64_t buckets[LATENCY_BUCKETS];
+  uint64_t count;
+  uint64_t total_ns;
+  uint64_t max_ns;
+} LatencyHistogram;
+
+/**
+ * Add one sample.
+ */
+void latency_record(LatencyHistogram *h, uint64_t ns);
+
+/**
+ * Upper bound (ns) of the bucket holding the p-th fraction of samples,
+ * p in [0, 1]. Returns 0 for an empty histogram.
+ */
+uint64_t latency_percentile_ns(const LatencyHistogram *h, double p);
+
+typedef struct Reactor Reactor;
+
+/* Called with the ready fd and its epoll event mask. */
+typedef void (*ReactorFn)(Reactor *r, int fd, uint32_t events, void *user);
+
+typedef struct {
+  int fd; // -1 for a free slot
+  char name[16];
+  ReactorFn fn;
+  void *user;
+  LatencyHistogram latency;
+} ReactorSource;
+
+struct Reactor {
+  int epfd;
+  ReactorSource *sources; // Slots keep their index while registered
+  int count;              // Slots in use or freed, i.e. the scan bound
+  int capacity;
+};
+
+/**
+ * Create the epoll instance.
+ * Returns: 0 on success, -1 on error
+ */
+int reactor_init(Reactor *r);
+
+/**
+ * Close the epoll instance and free the source table. Registered fds are
+ * not closed; they belong to the caller.
+ */
+void reactor_free(Reactor *r);
+
+/**
+ * Watch fd for input (EPOLLIN) and dispatch to fn. name labels the source
+ * in statistics.
+ * Returns: source index on success, -1 on error
+ */
+int reactor_add(Reactor *r, int fd, const char *name, ReactorFn fn, void *user);
+
+/**
+ * Stop watching fd. Safe to call from a handler, including fd's own.
+ * Returns: 0 on success, -1 if fd is not registered
+ */
+int reactor_remove(Reactor *r, int fd);
+
+/**
+ * Wait up to timeout_ms (-1: forever) and dispatch the ready sources.
+ * Returns: handlers run (0 on timeout or signal interruption), -1 on error
+ */
+int reactor_poll(Reactor *r, int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // REACTOR_H
@@ -0,0 +1,146 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "check_cycle.h"
+#include "platform.h"
+#include "prayer_checker.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Shared-memory schedule snapshot. The daemon publishes today's prayer times,
+ * the enabled prayers and its next trigger into a small file on the
+ * $XDG_RUNTIME_DIR tmpfs; readers map it read-only once and keep the
+ * mapping, then read it without locks or system calls. A sequence counter
+ * guards each update (a seqlock): the writer makes it odd, rewrites the data
+ * and makes it even again, and a reader retries whenever the counter was odd
+ * or moved while it copied.
+ *
+ * Staleness is signalled through the region itself. The daemon watches
+ * config.json and republishes (a new generation) on every reload; on exit it
+ * publishes generation 0, and a daemon starting after one that died does
+ * the same to the region it replaces, so a reader of either maps the file
+ * afresh. What remains is the few milliseconds between a save and the
+ * daemon's reload, or a daemon killed and never restarted;
+ * snapshot_config_unchanged() closes that gap at the cost of a stat() for
+ * callers that opt in.
+ */
+
+#define SNAPSHOT_FILE_NAME "muslimtify.snapshot"
+#define SNAPSHOT_MAGIC 0x5353544dU // "MTSS" little-endian
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_READ_RETRIES 64
+
+typedef struct {
+  uint64_t generation;            // Publishes since the daemon started; 0: no schedule
+  uint64_t config_key;            // snapshot_config_key() of the config.json used
+  PlatformFileStamp config_stamp; // config.json as loaded, see DaemonState
+  int32_t date;                   // YYYYMMDD the times are for
+  uint32_t enabled;               // SchedulePlan.enabled
+  double times[PRAYER_NONE];      // Decimal hours, PrayerType order
+  int64_t next_due;               // Next pending trigger (see CacheTrigger); 0 if none
+  double next_prayer_time;
+  int32_t next_minutes_before;
+  char next_prayer[16];
+} SnapshotData;
+
+typedef struct {
+  uint32_t magic;   // SNAPSHOT_MAGIC
+  uint32_t version; // SNAPSHOT_VERSION
+  uint32_t seq;     // Odd while the writer is updating data
+  uint32_t size;    // sizeof(SnapshotRegion) of the writer
+  SnapshotData data;
+} SnapshotRegion;
+
+typedef struct {
+  SnapshotRegion *region;
+  char path[PLATFORM_PATH_MAX];
+} SnapshotWriter;
+
+/**
+ * Snapshot path, $XDG_RUNTIME_DIR/muslimtify.snapshot.
+ * Returns: 0 on success, -1 if XDG_RUNTIME_DIR is unset or the path is too long
+ */
+int snapshot_path(char *buf, size_t size);
+
+/**
+ * Identifies config.json by path, so a reader using another config (other
+ * XDG_CONFIG_HOME) does not take the daemon's answer.
+ */
+uint64_t snapshot_config_key(const char *config_path);
+
+/**
+ * Create the region at path (mode 0600) and map it for writing. It replaces
+ * an earlier file by rename, so readers never see a half-initialized header,
+ * after publishing an empty schedule into the earlier one.
+ * Returns: 0 on success, -1 on error
+ */
+int snapshot_writer_open(SnapshotWriter *w, const char *path);
+
+/**
+ * Copy data into the region under the seqlock and bump its generation.
+ */
+void snapshot_publish(SnapshotWriter *w, const SnapshotData *data);
+
+/**
+ * Publish an empty schedule (generation 0) for readers that keep the region
+ * mapped, then unmap and remove the file.
+ */
+void snapshot_writer_close(SnapshotWriter *w);
+
+/**
+ * What the daemon publishes for local time now: the loaded config's times
+ * for today and the first trigger due after now.
+ * Returns: 0 on success, -1 if st has no config loaded
+ */
+int snapshot_fill(SnapshotData *data, const DaemonState *st, time_t now);
+
+/**
+ * Map the region at path read-only.
+ * Returns: the region, NULL if it is missing or of another version
+ */
+const SnapshotRegion *snapshot_map(const char *path);
+
+void snapshot_unmap(const SnapshotRegion *region);
+
+/**
+ * Copy a consistent snapshot out of region. Lock-free and syscall-free; gives
+ * up after SNAPSHOT_READ_RETRIES torn reads.
+ * Returns: 0 on success, -1 if no consistent copy was read or it holds no
+ * schedule
+ */
+int snapshot_read(const SnapshotRegion *region, SnapshotData *out);
+
+/**
+ * Whether data holds the schedule for now's local day computed from
+ * config_path. No system calls; see the staleness note above.
+ */
+bool snapshot_is_current(const SnapshotData *data, const struct tm *now, const char *config_path);
+
+/**
+ * Opt-in check that config_path on disk is still the file data was computed
+ * from, for callers that cannot take a schedule a save has just replaced.
+ * Costs one stat().
+ */
+bool snapshot_config_unchanged(const SnapshotData *data, const char *config_path);
+
+/**
+ * The next enabled prayer after now and the minutes until it, with
+ * prayer_get_next()'s semantics, from the snapshot alone.
+ * Returns: PRAYER_NONE if no prayer is enabled
+ */
+PrayerType snapshot_next_prayer(const SnapshotData *data, const struct tm *now,
+                                int *minutes_until);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SNAPSHOT_H
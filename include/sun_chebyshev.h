@@ -0,0 +1,38 @@
+#ifndef SUN_CHEBYSHEV_H
+#define SUN_CHEBYSHEV_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * High-accuracy solar ephemeris: piecewise Chebyshev polynomials for apparent
+ * declination and equation of time, fitted at build time to the VSOP87 model
+ * in tools/vsop87_sun.c (~1 arcsecond, nutation and aberration included) over
+ * 1900-2200. Evaluation is a table index plus two short Clenshaw sums, cheaper
+ * than the engine's built-in low-precision formula.
+ */
+
+/**
+ * Declination (degrees) and equation of time (hours) at a Julian day (UT).
+ * Returns: 1 if jd is inside the fitted span, 0 otherwise (outputs untouched)
+ */
+int sun_chebyshev(double jd, double *declination, double *equation_of_time);
+
+/**
+ * Fitted span as [first_jd, last_jd).
+ */
+void sun_chebyshev_range(double *first_jd, double *last_jd);
+
+/**
+ * Install as the engine's sun source (prayer_set_sun_source). Dates outside
+ * the fitted span keep the analytic model. Replaces any installed ephemeris
+ * table; prayer_set_sun_source(NULL, NULL) removes it.
+ */
+void sun_chebyshev_install(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SUN_CHEBYSHEV_H
@@ -0,0 +1,68 @@
+#ifndef TIMETABLE_H
+#define TIMETABLE_H
+
+#include "prayertimes.h"
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TIMETABLE_NAME_MAX 64
+
+typedef struct {
+  char name[TIMETABLE_NAME_MAX];
+  double latitude;
+  double longitude;
+  double timezone; // UTC offset in hours
+  CalcMethod method;
+} TimetableLocation;
+
+typedef struct {
+  int year;
+  int month;
+  int day;
+} TimetableDate;
+
+/**
+ * Load locations from a CSV file of name,lat,lon,tz,method lines, where
+ * method is a key such as "kemenag" (see `muslimtify method list`). Blank
+ * lines and lines starting with '#' are skipped. On success *locations is a
+ * malloc'd array the caller frees.
+ * Returns: 0 on success, -1 on error (message printed to stderr)
+ */
+int timetable_load_locations(const char *path, TimetableLocation **locations, size_t *count);
+
+/**
+ * Parse a YYYY-MM-DD date.
+ * Returns: 0 on success, -1 if malformed or not a calendar date
+ */
+int timetable_parse_date(const char *str, TimetableDate *date);
+
+/**
+ * Whether [from, to] is a range timetable_export() accepts: both dates in
+ * years 1-9999 and from not after to.
+ * Returns: 0 if valid, -1 otherwise
+ */
+int timetable_check_range(TimetableDate from, TimetableDate to);
+
+/**
+ * Write the timetable of every location for every date in [from, to] to out
+ * as CSV: name,date,fajr,sunrise,dhuha,dhuhr,asr,maghrib,isha (HH:MM, rounded
+ * up like the display; "--:--" when the sun never reaches the angle).
+ *
+ * Rows are ordered by location, then date, for any thread count. Work is
+ * split into (location, month) chunks run on nthreads threads (0 = one per
+ * processor) with work stealing; each thread formats into its own buffer and
+ * the buffers are written out in chunk order.
+ * Returns: 0 on success, -1 on invalid range, allocation or write failure
+ */
+int timetable_export(FILE *out, const TimetableLocation *locations, size_t count,
+                     TimetableDate from, TimetableDate to, int nthreads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TIMETABLE_H
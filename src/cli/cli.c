@@ -1,5 +1,6 @@
 #include "cli.h"
 #include "cli_internal.h"
+#include "ephemeris.h"
 #include "prayertimes.h"
 #include "version.h"
 #include <stdio.h>
@@ -13,12 +14,17 @@ static const CommandEntry top_commands[] = {
     {"disable", handle_disable},   {"list", handle_list},
     {"reminder", handle_reminder}, {"daemon", handle_daemon},
     {"method", handle_method},     {"notification", handle_notification},
-    {"sound", handle_sound},       {"version", handle_version},
-    {"--version", handle_version}, {"-v", handle_version},
-    {"help", handle_help},         {"--help", handle_help},
-    {"-h", handle_help},
+    {"sound", handle_sound},       {"export", handle_export},
+    {"version", handle_version},   {"--version", handle_version},
+    {"-v", handle_version},        {"help", handle_help},
+    {"--help", handle_help},       {"-h", handle_help},
 };
 
+void cli_use_sun_table(void) {
+  if (ephemeris_installed_id() == 0)
+    ephemeris_install(ephemeris_get_path());
+}
+
 // --- version / help -----------------------
 
 int handle_version(int argc, char **argv) {
@@ -77,8 +83,20 @@ void cli_print_help(void) {
 
   printf("  %-30s %s\n", "next remaining", "Print remaining time only");
 
+  printf("  %-30s %s\n", "next --follow", "Print next prayer on every change");
+
+  printf("  %-30s %s\n", "", "--format json|text (status bars)");
+
   printf("  %-30s %s\n", "check", "Check and send notifications");
 
+  printf("  %-30s %s\n", "check --dump-cache", "Print today's trigger cache as JSON");
+
+  printf("  %-30s %s\n", "export <locations.csv>", "Timetables for many locations as CSV");
+
+  printf("  %-30s %s\n", "", "--from=YYYY-MM-DD --to=YYYY-MM-DD");
+
+  printf("  %-30s %s\n", "", "--threads=N --output=<file>");
+
   printf("\n");
 
   /*
@@ -199,6 +217,9 @@ void cli_print_help(void) {
   printf("  %-30s %s\n", "daemon uninstall", "Remove daemon");
 
   printf("  %-30s %s\n", "daemon status", "Show daemon status");
+#ifndef _WIN32
+  printf("  %-30s %s\n", "daemon stats", "Show statistics of the running daemon");
+#endif
 
   printf("\n");
 
@@ -1,4 +1,3 @@
-#include "cache.h"
 #include "cli_internal.h"
 #include "display.h"
 #include "location.h"
@@ -29,7 +28,6 @@ static int config_reset_handler(int argc, char **argv) {
     fprintf(stderr, "Error: Failed to save config\n");
     return 1;
   }
-  cache_invalidate();
   printf("✓ Configuration reset to defaults\n");
   printf("  Config file: %s\n", config_get_path());
   return 0;
@@ -97,7 +95,6 @@ static int config_auto_handler(int argc, char **argv) {
     fprintf(stderr, "Error: Failed to save config\n");
     return 1;
   }
-  cache_invalidate();
 
   printf("✓ Location detected: ");
   if (cfg.city[0] != '\0')
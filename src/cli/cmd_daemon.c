@@ -15,6 +15,7 @@
 #ifndef MUSLIMTIFY_CMD_DAEMON_TEST
 #include "location.h"
 #include "prayertimes.h"
+#include "query.h"
 #endif
 
 // -- helpers -----------------------------------------------------------------
@@ -85,6 +86,7 @@ int build_service_unit(const char *binary_path, char *buffer, size_t buffer_size
                          "[Service]\n"
                          "Type=simple\n"
                          "ExecStart=%s daemon run\n"
+                         "ExecReload=/bin/kill -HUP $MAINPID\n"
                          "Restart=on-failure\n"
                          "RestartSec=5\n"
                          "\n"
@@ -257,8 +259,22 @@ static int daemon_status_handler(int argc, char **argv) {
 static int daemon_run_handler(int argc, char **argv) {
   (void)argc;
   (void)argv;
+  cli_use_sun_table();
   return run_daemon_loop();
 }
+
+static int daemon_stats_handler(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+
+  static char reply[QUERY_REPLY_MAX];
+  if (query_request("stats", reply, sizeof(reply), QUERY_TIMEOUT_MS) != 0) {
+    fprintf(stderr, "Error: No running daemon answered on its query socket\n");
+    return 1;
+  }
+  fputs(query_reply_body(reply), stdout);
+  return 0;
+}
 #endif
 
 static const CommandEntry daemon_commands[] = {
@@ -267,6 +283,7 @@ static const CommandEntry daemon_commands[] = {
     {"status", daemon_status_handler},
 #ifndef MUSLIMTIFY_CMD_DAEMON_TEST
     {"run", daemon_run_handler},
+    {"stats", daemon_stats_handler},
 #endif
 };
 
@@ -278,7 +295,7 @@ int handle_daemon(int argc, char **argv) {
       return sub->handler(argc - 1, argv + 1);
 
     fprintf(stderr, "Error: Unknown daemon subcommand '%s'\n", argv[0]);
-    fprintf(stderr, "Usage: muslimtify daemon [install|uninstall|status|run]\n");
+    fprintf(stderr, "Usage: muslimtify daemon [install|uninstall|status|stats|run]\n");
     return 1;
   }
 
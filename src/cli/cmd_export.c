@@ -0,0 +1,115 @@
+#include "cli_internal.h"
+#include "platform.h"
+#include "timetable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char *EXPORT_USAGE =
+    "Usage: muslimtify export <locations.csv> [--from=YYYY-MM-DD] [--to=YYYY-MM-DD] "
+    "[--threads=N] [--output=<file>]\n"
+    "  locations.csv: name,lat,lon,tz,method per line (method as in 'method list')\n";
+
+// Matches "--name=value" or "--name value"; advances *i past a separate value.
+// Returns the value, NULL if argv[*i] is another option, or "" if missing.
+static const char *option_value(int argc, char **argv, int *i, const char *name) {
+  size_t n = strlen(name);
+  if (strncmp(argv[*i], name, n) != 0)
+    return NULL;
+  if (argv[*i][n] == '=')
+    return argv[*i] + n + 1;
+  if (argv[*i][n] != '\0')
+    return NULL;
+  return *i + 1 < argc ? argv[++*i] : "";
+}
+
+int handle_export(int argc, char **argv) {
+  const char *csv = NULL, *from_str = NULL, *to_str = NULL, *threads_str = NULL, *output = NULL;
+
+  for (int i = 0; i < argc; i++) {
+    const char *v = NULL;
+    if ((v = option_value(argc, argv, &i, "--from"))) {
+      from_str = v;
+    } else if ((v = option_value(argc, argv, &i, "--to"))) {
+      to_str = v;
+    } else if ((v = option_value(argc, argv, &i, "--threads"))) {
+      threads_str = v;
+    } else if ((v = option_value(argc, argv, &i, "--output"))) {
+      output = v;
+    } else if (argv[i][0] != '-' && !csv) {
+      csv = argv[i];
+    } else {
+      fprintf(stderr, "Error: unexpected argument '%s'\n%s", argv[i], EXPORT_USAGE);
+      return 1;
+    }
+    // i is still on the option when its value is missing
+    if (v && *v == '\0') {
+      fprintf(stderr, "Error: missing value for %.*s\n%s", (int)strcspn(argv[i], "="), argv[i],
+              EXPORT_USAGE);
+      return 1;
+    }
+  }
+
+  if (!csv) {
+    fputs(EXPORT_USAGE, stderr);
+    return 1;
+  }
+
+  // Default range: the current calendar year
+  time_t now = time(NULL);
+  struct tm tm_now;
+  platform_localtime(&now, &tm_now);
+  TimetableDate from = {tm_now.tm_year + 1900, 1, 1};
+  if (from_str && timetable_parse_date(from_str, &from) != 0) {
+    fprintf(stderr, "Error: invalid --from date '%s' (expected YYYY-MM-DD)\n", from_str);
+    return 1;
+  }
+  TimetableDate to = {from.year, 12, 31};
+  if (to_str && timetable_parse_date(to_str, &to) != 0) {
+    fprintf(stderr, "Error: invalid --to date '%s' (expected YYYY-MM-DD)\n", to_str);
+    return 1;
+  }
+  // Before --output is truncated or anything is written
+  if (timetable_check_range(from, to) != 0) {
+    fprintf(stderr, "Error: invalid date range (--from after --to, or a year outside 1-9999)\n");
+    return 1;
+  }
+
+  int threads = 0;
+  if (threads_str) {
+    char *end;
+    long n = strtol(threads_str, &end, 10);
+    if (*threads_str == '\0' || *end != '\0' || n < 1 || n > 1024) {
+      fprintf(stderr, "Error: --threads must be between 1 and 1024\n");
+      return 1;
+    }
+    threads = (int)n;
+  }
+
+  TimetableLocation *locations = NULL;
+  size_t count = 0;
+  if (timetable_load_locations(csv, &locations, &count) != 0)
+    return 1;
+
+  FILE *out = stdout;
+  if (output) {
+    out = platform_file_open(output, "w");
+    if (!out) {
+      fprintf(stderr, "Error: cannot write %s\n", output);
+      free(locations);
+      return 1;
+    }
+  }
+
+  fputs("name,date,fajr,sunrise,dhuha,dhuhr,asr,maghrib,isha\n", out);
+  cli_use_sun_table();
+  int rc = timetable_export(out, locations, count, from, to, threads);
+  if (rc != 0)
+    fprintf(stderr, "Error: export failed (out of memory or cannot write output)\n");
+
+  if (out != stdout && fclose(out) != 0)
+    rc = -1;
+  free(locations);
+  return rc == 0 ? 0 : 1;
+}
@@ -1,4 +1,3 @@
-#include "cache.h"
 #include "cli_internal.h"
 #include "country.h"
 #include "display.h"
@@ -69,7 +68,6 @@ static int location_refresh_handler(int argc, char **argv) {
     fprintf(stderr, "Error: Failed to save config\n");
     return 1;
   }
-  cache_invalidate();
   printf("✓ Saved to config\n");
   return 0;
 }
@@ -245,8 +243,6 @@ static int location_set_handler(int argc, char **argv) {
     return 1;
   }
 
-  cache_invalidate();
-
   printf("✓ Location:\n");
   printf("  Latitude: %.4f\n", cfg.latitude);
   printf("  Longitude: %.4f\n", cfg.longitude);
@@ -285,7 +281,6 @@ static int location_clear_handler(int argc, char **argv) {
     return 1;
   }
 
-  cache_invalidate();
   printf("✓ Location cleared. Will auto-detect on next run.\n");
   return 0;
 }
@@ -1,4 +1,3 @@
-#include "cache.h"
 #include "cli_internal.h"
 #include "prayertimes.h"
 #include "string_util.h"
@@ -63,7 +62,6 @@ static int method_set_handler(int argc, char **argv) {
     return 1;
   }
 
-  cache_invalidate();
   printf("✓ Method set to: %s", argv[0]);
   if (p)
     printf(" (%s)", p->name);
@@ -95,7 +93,6 @@ static int method_madhab_handler(int argc, char **argv) {
     return 1;
   }
 
-  cache_invalidate();
   printf("✓ Madhab set to: %s", argv[0]);
   if (strcmp(argv[0], "hanafi") == 0)
     printf(" (Hanafi)");
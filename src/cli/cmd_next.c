@@ -3,12 +3,84 @@
 #include "location.h"
 #include "platform.h"
 #include "prayer_checker.h"
+#include <signal.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 
-static int next_name(int argc, char **argv) {
-  (void)argc;
-  (void)argv;
+#ifndef _WIN32
+#include "query.h"
+#include "snapshot.h"
+#endif
+
+#ifndef _WIN32
+/* Mapped on first use and kept for the life of the process, so --follow
+ * reads each minute without a system call. */
+static const SnapshotRegion *snapshot_region;
+
+static bool read_current_snapshot(SnapshotData *data, const struct tm *now) {
+  if (snapshot_region && snapshot_read(snapshot_region, data) == 0 &&
+      snapshot_is_current(data, now, config_get_path()))
+    return true;
+
+  // Not mapped yet, or a restarted daemon replaced the file: map it afresh
+  snapshot_unmap(snapshot_region);
+  snapshot_region = NULL;
+  char path[PLATFORM_PATH_MAX];
+  if (snapshot_path(path, sizeof(path)) != 0)
+    return false;
+  snapshot_region = snapshot_map(path);
+  return snapshot_region && snapshot_read(snapshot_region, data) == 0 &&
+         snapshot_is_current(data, now, config_get_path());
+}
+
+/* Read the schedule snapshot a running daemon publishes: no config parsing,
+ * no computation beyond picking the next enabled prayer. Returns false when
+ * there is no current snapshot. */
+static bool next_from_snapshot(PrayerType *next, double *prayer_time, int *minutes_until) {
+  time_t now = time(NULL);
+  struct tm tm_now;
+  platform_localtime(&now, &tm_now);
+  SnapshotData data;
+  if (!read_current_snapshot(&data, &tm_now))
+    return false;
+
+  *next = snapshot_next_prayer(&data, &tm_now, minutes_until);
+  *prayer_time = *next == PRAYER_NONE ? 0.0 : data.times[*next];
+  return true;
+}
+
+/* Ask a running daemon, which answers from its resident config without this
+ * process reading config.json. Returns false when no daemon answered. */
+static bool next_from_daemon(PrayerType *next, double *prayer_time, int *minutes_until) {
+  char reply[QUERY_REQUEST_MAX + PLATFORM_PATH_MAX];
+  if (query_request("next", reply, sizeof(reply), QUERY_TIMEOUT_MS) != 0)
+    return false;
+
+  const char *body = query_reply_body(reply);
+  int type;
+  if (strcmp(body, "none\n") == 0) {
+    *next = PRAYER_NONE;
+    return true;
+  }
+  if (sscanf(body, "next %d %lf %d", &type, prayer_time, minutes_until) != 3 || type < 0 ||
+      type >= PRAYER_NONE)
+    return false;
+  *next = (PrayerType)type;
+  return true;
+}
+#endif
+
+/* The next enabled prayer, its time and the minutes until it, from the
+ * daemon's snapshot or socket when one runs, else computed here.
+ * Returns: 0 on success, 1 on error (already reported) */
+static int find_next(PrayerType *next, double *prayer_time, int *minutes_until) {
+#ifndef _WIN32
+  if (next_from_snapshot(next, prayer_time, minutes_until) ||
+      next_from_daemon(next, prayer_time, minutes_until))
+    return 0;
+#endif
 
   Config cfg;
   if (config_load(&cfg) != 0) {
@@ -17,97 +89,174 @@ static int next_name(int argc, char **argv) {
   }
   if (ensure_location(&cfg) != 0)
     return 1;
+  cli_use_sun_table();
 
   time_t now = time(NULL);
-  struct tm tm_buf;
-  platform_localtime(&now, &tm_buf);
-  struct tm *tm_now = &tm_buf;
+  struct tm tm_now;
+  platform_localtime(&now, &tm_now);
 
   MethodParams params = method_params_from_config(&cfg);
   struct PrayerTimes times =
-      calculate_prayer_times(tm_now->tm_year + 1900, tm_now->tm_mon + 1, tm_now->tm_mday,
+      calculate_prayer_times(tm_now.tm_year + 1900, tm_now.tm_mon + 1, tm_now.tm_mday,
                              cfg.latitude, cfg.longitude, cfg.timezone_offset, &params);
 
-  int minutes_until = 0;
-  PrayerType next = prayer_get_next(&cfg, tm_now, &times, &minutes_until);
-  if (next == PRAYER_NONE) {
+  *minutes_until = 0;
+  *next = prayer_get_next(&cfg, &tm_now, &times, minutes_until);
+  *prayer_time = *next == PRAYER_NONE ? 0.0 : prayer_get_time(&times, *next);
+  return 0;
+}
+
+/* find_next() for the subcommands, which fail when nothing is enabled. */
+static int find_next_enabled(PrayerType *next, double *prayer_time, int *minutes_until) {
+  if (find_next(next, prayer_time, minutes_until) != 0)
+    return 1;
+  if (*next == PRAYER_NONE) {
     fprintf(stderr, "No upcoming prayers enabled.\n");
     return 1;
   }
-  printf("%s\n", prayer_get_name(next));
   return 0;
 }
 
-static int next_time(int argc, char **argv) {
+static int next_name(int argc, char **argv) {
   (void)argc;
   (void)argv;
 
-  Config cfg;
-  if (config_load(&cfg) != 0) {
-    fprintf(stderr, "Error: Failed to load config\n");
-    return 1;
-  }
-  if (ensure_location(&cfg) != 0)
+  PrayerType next;
+  double prayer_time;
+  int minutes_until;
+  if (find_next_enabled(&next, &prayer_time, &minutes_until) != 0)
     return 1;
+  printf("%s\n", prayer_get_name(next));
+  return 0;
+}
 
-  time_t now = time(NULL);
-  struct tm tm_buf;
-  platform_localtime(&now, &tm_buf);
-  struct tm *tm_now = &tm_buf;
-
-  MethodParams params = method_params_from_config(&cfg);
-  struct PrayerTimes times =
-      calculate_prayer_times(tm_now->tm_year + 1900, tm_now->tm_mon + 1, tm_now->tm_mday,
-                             cfg.latitude, cfg.longitude, cfg.timezone_offset, &params);
+static int next_time(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
 
-  int minutes_until = 0;
-  PrayerType next = prayer_get_next(&cfg, tm_now, &times, &minutes_until);
-  if (next == PRAYER_NONE) {
-    fprintf(stderr, "No upcoming prayers enabled.\n");
+  PrayerType next;
+  double prayer_time;
+  int minutes_until;
+  if (find_next_enabled(&next, &prayer_time, &minutes_until) != 0)
     return 1;
-  }
   char time_str[16];
-  format_time_hm(prayer_get_time(&times, next), time_str, sizeof(time_str));
+  format_time_hm(prayer_time, time_str, sizeof(time_str));
   printf("%s\n", time_str);
   return 0;
 }
 
+// "1:05" or, under an hour, "42m"
+static void format_remaining(int minutes_until, char *buf, size_t size) {
+  int hours = minutes_until / 60;
+  int mins = minutes_until % 60;
+  if (hours > 0) {
+    snprintf(buf, size, "%d:%02d", hours, mins);
+  } else {
+    snprintf(buf, size, "%dm", mins);
+  }
+}
+
 static int next_remaining(int argc, char **argv) {
   (void)argc;
   (void)argv;
 
-  Config cfg;
-  if (config_load(&cfg) != 0) {
-    fprintf(stderr, "Error: Failed to load config\n");
+  PrayerType next;
+  double prayer_time;
+  int minutes_until;
+  if (find_next_enabled(&next, &prayer_time, &minutes_until) != 0)
     return 1;
+  char remaining[16];
+  format_remaining(minutes_until, remaining, sizeof(remaining));
+  printf("%s\n", remaining);
+  return 0;
+}
+
+// One status-bar line; the JSON form is what waybar's custom modules read
+static void follow_line(bool json, PrayerType next, double prayer_time, int minutes_until,
+                        char *buf, size_t size) {
+  if (next == PRAYER_NONE) {
+    snprintf(buf, size, "%s",
+             json ? "{\"text\":\"\",\"prayer\":null}" : "No upcoming prayers enabled.");
+    return;
   }
-  if (ensure_location(&cfg) != 0)
-    return 1;
 
-  time_t now = time(NULL);
-  struct tm tm_buf;
-  platform_localtime(&now, &tm_buf);
-  struct tm *tm_now = &tm_buf;
+  const char *name = prayer_get_name(next);
+  char time_str[16], remaining[16];
+  format_time_hm(prayer_time, time_str, sizeof(time_str));
+  format_remaining(minutes_until, remaining, sizeof(remaining));
+  if (json) {
+    snprintf(buf, size,
+             "{\"text\":\"%s %s (%s)\",\"prayer\":\"%s\",\"time\":\"%s\","
+             "\"remaining\":\"%s\",\"minutes\":%d}",
+             name, time_str, remaining, name, time_str, remaining, minutes_until);
+  } else {
+    snprintf(buf, size, "%s %s (%s)", name, time_str, remaining);
+  }
+}
 
-  MethodParams params = method_params_from_config(&cfg);
-  struct PrayerTimes times =
-      calculate_prayer_times(tm_now->tm_year + 1900, tm_now->tm_mon + 1, tm_now->tm_mday,
-                             cfg.latitude, cfg.longitude, cfg.timezone_offset, &params);
+/* Print the next prayer whenever its line changes, until stdout goes away.
+ * The remaining time counts whole minutes and prayers fall on minute
+ * boundaries, so the line can only change at the start of a minute: sleep
+ * until exactly then, and use the daemon's snapshot when it runs. */
+static int next_follow(bool json) {
+#ifndef _WIN32
+  // A closed pipe must fail the write below instead of killing the process
+  signal(SIGPIPE, SIG_IGN);
+#endif
+  char last[256] = "";
+  for (bool first = true;; first = false) {
+    time_t now = time(NULL);
+    PrayerType next;
+    double prayer_time;
+    int minutes_until;
+    if (find_next(&next, &prayer_time, &minutes_until) == 0) {
+      char line[256];
+      follow_line(json, next, prayer_time, minutes_until, line, sizeof(line));
+      if (strcmp(line, last) != 0) {
+        if (printf("%s\n", line) < 0 || fflush(stdout) != 0)
+          return 0; // The status bar closed the pipe
+        snprintf(last, sizeof(last), "%s", line);
+      }
+    } else if (first) {
+      return 1;
+    }
+    platform_sleep_until(now - now % 60 + 60);
+  }
+}
 
-  int minutes_until = 0;
-  PrayerType next = prayer_get_next(&cfg, tm_now, &times, &minutes_until);
-  if (next == PRAYER_NONE) {
-    fprintf(stderr, "No upcoming prayers enabled.\n");
-    return 1;
+#define NEXT_USAGE "Usage: muslimtify next [name|time|remaining|--follow [--format json|text]]\n"
+
+static int next_options(int argc, char **argv) {
+  bool follow = false;
+  bool json = false;
+  for (int i = 0; i < argc; i++) {
+    const char *format = NULL;
+    if (strcmp(argv[i], "--follow") == 0) {
+      follow = true;
+    } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+      format = argv[++i];
+    } else if (strncmp(argv[i], "--format=", 9) == 0) {
+      format = argv[i] + 9;
+    } else {
+      fprintf(stderr, "Error: Unknown next option '%s'\n", argv[i]);
+      fprintf(stderr, NEXT_USAGE);
+      return 1;
+    }
+
+    if (format && strcmp(format, "json") != 0 && strcmp(format, "text") != 0) {
+      fprintf(stderr, "Error: Unknown format '%s' (use json or text)\n", format);
+      return 1;
+    }
+    if (format)
+      json = strcmp(format, "json") == 0;
   }
-  int hours = minutes_until / 60;
-  int mins = minutes_until % 60;
-  if (hours > 0) {
-    printf("%d:%02d\n", hours, mins);
-  } else {
-    printf("%dm\n", mins);
+
+  if (!follow) {
+    fprintf(stderr, "Error: --format applies to --follow\n");
+    fprintf(stderr, NEXT_USAGE);
+    return 1;
   }
-  return 0;
+  return next_follow(json);
 }
 
 static const CommandEntry next_commands[] = {
@@ -117,34 +266,24 @@ static const CommandEntry next_commands[] = {
 };
 
 int handle_next(int argc, char **argv) {
+  if (argc > 0 && strncmp(argv[0], "--", 2) == 0)
+    return next_options(argc, argv);
+
   if (argc > 0) {
     const CommandEntry *sub = dispatch_lookup(next_commands, DISPATCH_N(next_commands), argv[0]);
     if (sub)
       return sub->handler(argc - 1, argv + 1);
 
     fprintf(stderr, "Error: Unknown next subcommand '%s'\n", argv[0]);
-    fprintf(stderr, "Usage: muslimtify next [name|time|remaining]\n");
+    fprintf(stderr, NEXT_USAGE);
     return 1;
   }
 
-  Config cfg;
-  if (config_load(&cfg) != 0) {
-    fprintf(stderr, "Error: Failed to load config\n");
-    return 1;
-  }
-  if (ensure_location(&cfg) != 0)
+  PrayerType next;
+  double prayer_time;
+  int minutes_until;
+  if (find_next(&next, &prayer_time, &minutes_until) != 0)
     return 1;
-
-  time_t now = time(NULL);
-  struct tm tm_buf;
-  platform_localtime(&now, &tm_buf);
-  struct tm *tm_now = &tm_buf;
-
-  MethodParams params = method_params_from_config(&cfg);
-  struct PrayerTimes times =
-      calculate_prayer_times(tm_now->tm_year + 1900, tm_now->tm_mon + 1, tm_now->tm_mday,
-                             cfg.latitude, cfg.longitude, cfg.timezone_offset, &params);
-
-  display_next_prayer(&times, &cfg, tm_now);
+  display_next_prayer_at(next, prayer_time, minutes_until);
   return 0;
 }
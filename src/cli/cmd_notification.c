@@ -17,6 +17,7 @@ static int notification_test(int argc, char **argv) {
   }
   if (ensure_location(&cfg) != 0)
     return 1;
+  cli_use_sun_table();
 
   time_t now = time(NULL);
   struct tm tm_buf;
@@ -1,4 +1,3 @@
-#include "cache.h"
 #include "cli_internal.h"
 #include "display.h"
 #include <stdio.h>
@@ -30,7 +29,6 @@ int handle_enable(int argc, char **argv) {
       return 1;
     }
 
-    cache_invalidate();
     printf("✓ All prayers enabled\n");
     return 0;
   }
@@ -48,7 +46,6 @@ int handle_enable(int argc, char **argv) {
     return 1;
   }
 
-  cache_invalidate();
   printf("✓ %s notifications enabled\n", argv[0]);
   return 0;
 }
@@ -80,7 +77,6 @@ int handle_disable(int argc, char **argv) {
       return 1;
     }
 
-    cache_invalidate();
     printf("✓ All prayers disabled\n");
     return 0;
   }
@@ -98,7 +94,6 @@ int handle_disable(int argc, char **argv) {
     return 1;
   }
 
-  cache_invalidate();
   printf("✓ %s notifications disabled\n", argv[0]);
   return 0;
 }
@@ -172,7 +167,6 @@ int handle_reminder(int argc, char **argv) {
       return 1;
     }
 
-    cache_invalidate();
     if (count == 0) {
       printf("✓ Reminders cleared for all enabled prayers\n");
     } else {
@@ -205,7 +199,6 @@ int handle_reminder(int argc, char **argv) {
     return 1;
   }
 
-  cache_invalidate();
   if (count == 0) {
     printf("✓ Reminders cleared for %s\n", prayer_name);
   } else {
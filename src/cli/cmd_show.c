@@ -1,4 +1,6 @@
+#include "cache.h"
 #include "check_cycle.h"
+#include "cli_internal.h"
 #include "config.h"
 #include "display.h"
 #include "location.h"
@@ -17,6 +19,7 @@ int handle_show(int argc, char **argv) {
   if (ensure_location(&cfg) != 0) {
     return 1;
   }
+  cli_use_sun_table();
 
   time_t now = time(NULL);
   struct tm tm_buf;
@@ -53,7 +56,17 @@ int handle_show(int argc, char **argv) {
 }
 
 int handle_check(int argc, char **argv) {
-  (void)argc;
-  (void)argv;
+  if (argc > 0 && strcmp(argv[0], "--dump-cache") == 0) {
+    PrayerCache cache = {0};
+    if (cache_load(&cache) != 0) {
+      fprintf(stderr, "Error: No valid cache at %s\n", cache_get_path());
+      cache_free(&cache);
+      return 1;
+    }
+    cache_export_json(&cache, stdout);
+    cache_free(&cache);
+    return 0;
+  }
+  cli_use_sun_table(); // Before the cache check: its hash covers the table
   return run_check_cycle();
 }
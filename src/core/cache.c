@@ -1,7 +1,7 @@
 #include "cache.h"
-#include "json.h"
 #include "platform.h"
 #include "prayer_checker.h"
+#include <limits.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -10,6 +10,7 @@
 #include "string_util.h"
 
 static char cache_path_buf[PLATFORM_PATH_MAX] = {0};
+static char fired_path_buf[PLATFORM_PATH_MAX] = {0};
 static bool cache_trunc_logged = false;
 
 static void cache_log_trunc(const char *field) {
@@ -19,6 +20,49 @@ static void cache_log_trunc(const char *field) {
   }
 }
 
+void cache_free(PrayerCache *cache) {
+  if (!cache)
+    return;
+  free(cache->triggers);
+  memset(cache, 0, sizeof(*cache));
+}
+
+int cache_reserve(PrayerCache *cache, int count) {
+  if (!cache || count < 0)
+    return -1;
+  if (count <= cache->capacity)
+    return 0;
+
+  // Grow geometrically so a rolling window settles into its block
+  int capacity = cache->capacity > INT_MAX / 2 ? INT_MAX : cache->capacity * 2;
+  if (capacity < count)
+    capacity = count;
+  CacheTrigger *grown = realloc(cache->triggers, (size_t)capacity * sizeof(*grown));
+  if (!grown) {
+    fprintf(stderr, "cache: out of memory for %d triggers\n", count);
+    return -1;
+  }
+  cache->triggers = grown;
+  cache->capacity = capacity;
+  return 0;
+}
+
+int cache_copy(PrayerCache *dst, const PrayerCache *src) {
+  if (!dst || !src || dst == src)
+    return dst == src ? 0 : -1;
+  if (cache_reserve(dst, src->trigger_count) != 0)
+    return -1;
+
+  CacheTrigger *triggers = dst->triggers;
+  int capacity = dst->capacity;
+  *dst = *src;
+  dst->triggers = triggers;
+  dst->capacity = capacity;
+  if (src->trigger_count > 0)
+    memcpy(dst->triggers, src->triggers, (size_t)src->trigger_count * sizeof(CacheTrigger));
+  return 0;
+}
+
 const char *cache_get_path(void) {
   if (cache_path_buf[0] != '\0') {
     return cache_path_buf;
@@ -26,13 +70,27 @@ const char *cache_get_path(void) {
 
   const char *dir = platform_cache_dir();
   if (dir[0] != '\0') {
-    snprintf(cache_path_buf, sizeof(cache_path_buf), "%s%cnext_prayer.json", dir,
-             PLATFORM_PATH_SEP);
+    snprintf(cache_path_buf, sizeof(cache_path_buf), "%s%c%s", dir, PLATFORM_PATH_SEP,
+             CACHE_FILE_NAME);
   }
 
   return cache_path_buf;
 }
 
+const char *cache_get_fired_path(void) {
+  if (fired_path_buf[0] != '\0') {
+    return fired_path_buf;
+  }
+
+  const char *dir = platform_cache_dir();
+  if (dir[0] != '\0') {
+    snprintf(fired_path_buf, sizeof(fired_path_buf), "%s%c%s", dir, PLATFORM_PATH_SEP,
+             CACHE_FIRED_FILE_NAME);
+  }
+
+  return fired_path_buf;
+}
+
 static int ensure_cache_dir(void) {
   const char *dir = platform_cache_dir();
   if (dir[0] == '\0')
@@ -42,192 +100,420 @@ static int ensure_cache_dir(void) {
   return 0;
 }
 
-static char *read_file(const char *path) {
-  FILE *f = platform_file_open(path, "r");
-  if (!f)
-    return NULL;
-
-  fseek(f, 0, SEEK_END);
-  long size = ftell(f);
-  if (size < 0) {
-    fclose(f);
-    return NULL;
+static uint32_t crc32_update(uint32_t crc, const void *data, size_t size) {
+  // Byte-table CRC-32 (IEEE, reflected), table built on first use
+  static uint32_t table[256];
+  if (table[1] == 0) {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++)
+        c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+      table[i] = c;
+    }
   }
-  fseek(f, 0, SEEK_SET);
 
-  char *content = malloc((size_t)size + 1);
-  if (!content) {
-    fclose(f);
+  const unsigned char *p = data;
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++)
+    crc = table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
+static uint32_t cache_file_crc(const CacheFileHeader *header, const CacheTrigger *triggers) {
+  CacheFileHeader h = *header;
+  h.crc = 0;
+  uint32_t crc = crc32_update(0, &h, sizeof(h));
+  return crc32_update(crc, triggers, (size_t)h.trigger_count * sizeof(CacheTrigger));
+}
+
+// Everything but the CRC, against the size of the whole file
+static bool header_ok(const CacheFileHeader *h, size_t size) {
+  return size >= sizeof(*h) && memcmp(h->magic, CACHE_MAGIC, sizeof(h->magic)) == 0 &&
+         h->version == CACHE_VERSION && h->byte_order == CACHE_BYTE_ORDER &&
+         h->record_size == sizeof(CacheTrigger) &&
+         size == sizeof(*h) + (size_t)h->trigger_count * sizeof(CacheTrigger) &&
+         h->trigger_count <= INT_MAX / sizeof(CacheTrigger) &&
+         memchr(h->date, '\0', sizeof(h->date)) != NULL;
+}
+
+const CacheFileHeader *cache_file_check(const void *data, size_t size) {
+  const CacheFileHeader *h = data;
+  if (!data || !header_ok(h, size))
     return NULL;
-  }
+  if (cache_file_crc(h, (const CacheTrigger *)(h + 1)) != h->crc)
+    return NULL;
+  return h;
+}
 
-  size_t n = fread(content, 1, (size_t)size, f);
+// Newest (largest) due time in the fired log; a torn last record is ignored
+static bool read_fired_log(time_t *fired_through) {
+  FILE *f = platform_file_open(cache_get_fired_path(), "rb");
+  if (!f)
+    return false;
+
+  bool found = false;
+  int64_t records[64];
+  size_t n;
+  while ((n = fread(records, sizeof(records[0]), 64, f)) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      if (!found || records[i] > (int64_t)*fired_through)
+        *fired_through = (time_t)records[i];
+      found = true;
+    }
+  }
   fclose(f);
-  if (n > (size_t)size)
-    n = (size_t)size;
-  // NOLINTNEXTLINE(clang-analyzer-security.ArrayBound) -- n <= size by fread contract
-  content[n] = '\0';
-  return content;
+  return found;
 }
 
-int cache_load(PrayerCache *cache) {
-  if (!cache)
+static long open_file_size(FILE *f) {
+  if (fseek(f, 0, SEEK_END) != 0)
     return -1;
+  long size = ftell(f);
+  return fseek(f, 0, SEEK_SET) == 0 ? size : -1;
+}
 
-  const char *path = cache_get_path();
-  char *content = read_file(path);
-  if (!content)
+int cache_load(PrayerCache *cache) {
+  if (!cache)
     return -1;
 
-  JsonContext *ctx = json_begin();
-  if (!ctx) {
-    free(content);
+  FILE *f = platform_file_open(cache_get_path(), "rb");
+  if (!f)
     return -1;
-  }
 
-  memset(cache, 0, sizeof(*cache));
-
-  char *date_str = get_value(ctx, "date", content);
-  if (!date_str) {
-    json_end(ctx);
-    free(content);
-    return -1;
-  }
-  if (!copy_string(cache->date, sizeof(cache->date), date_str)) {
-    cache_log_trunc("date");
-  }
+  // The size is checked against the header before anything is allocated
+  CacheFileHeader h;
+  long size = open_file_size(f);
+  bool ok = size >= 0 && fread(&h, sizeof(h), 1, f) == 1 && header_ok(&h, (size_t)size) &&
+            cache_reserve(cache, (int)h.trigger_count) == 0 &&
+            fread(cache->triggers, sizeof(CacheTrigger), h.trigger_count, f) == h.trigger_count;
+  fclose(f);
+  if (ok)
+    ok = cache_file_crc(&h, cache->triggers) == h.crc;
 
-  char *triggers = get_value(ctx, "triggers", content);
-  if (!triggers || triggers[0] != '[') {
-    json_end(ctx);
-    free(content);
+  cache->head = 0;
+  if (!ok) {
+    cache->trigger_count = 0;
     return -1;
   }
 
-  // Parse trigger array manually
-  // Format: [{"prayer":"X","minute":N,"minutes_before":N,"prayer_time":F}, ...]
-  char *p = triggers + 1; // skip '['
-  cache->trigger_count = 0;
-
-  while (*p && *p != ']' && cache->trigger_count < MAX_TRIGGERS) {
-    // Find next '{'
-    while (*p && *p != '{')
-      p++;
-    if (!*p)
-      break;
-
-    // Find matching '}'
-    char *obj_start = p;
-    int depth = 0;
-    char *obj_end = NULL;
-    for (char *q = p; *q; q++) {
-      if (*q == '{')
-        depth++;
-      else if (*q == '}') {
-        depth--;
-        if (depth == 0) {
-          obj_end = q;
-          break;
-        }
-      }
-    }
-    if (!obj_end)
-      break;
+  memcpy(cache->date, h.date, sizeof(cache->date));
+  cache->days = (int)h.days;
+  cache->config_hash = h.config_hash;
+  cache->trigger_count = (int)h.trigger_count;
 
-    // Null-terminate the object temporarily
-    char saved = *(obj_end + 1);
-    *(obj_end + 1) = '\0';
+  time_t fired_through;
+  if (read_fired_log(&fired_through))
+    cache->head = cache_first_due_after(cache, fired_through);
+  return 0;
+}
 
-    CacheTrigger *t = &cache->triggers[cache->trigger_count];
+int cache_save(const PrayerCache *cache) {
+  if (!cache || cache->trigger_count < 0 || cache->head < 0 ||
+      cache->head > cache->trigger_count || cache->days < 0)
+    return -1;
+  if (ensure_cache_dir() != 0)
+    return -1;
 
-    char *prayer = get_value(ctx, "prayer", obj_start);
-    if (prayer) {
-      if (!copy_string(t->prayer, sizeof(t->prayer), prayer)) {
-        cache_log_trunc("prayer");
-      }
-    }
+  CacheFileHeader h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, CACHE_MAGIC, sizeof(h.magic));
+  h.version = CACHE_VERSION;
+  h.byte_order = CACHE_BYTE_ORDER;
+  h.config_hash = cache->config_hash;
+  if (!copy_string(h.date, sizeof(h.date), cache->date)) {
+    cache_log_trunc("date");
+  }
+  h.record_size = sizeof(CacheTrigger);
+  h.trigger_count = (uint32_t)cache_pending(cache);
+  h.days = (uint32_t)cache->days;
+  const CacheTrigger *pending = cache->triggers + cache->head;
+  h.crc = cache_file_crc(&h, pending);
 
-    char *minute_str = get_value(ctx, "minute", obj_start);
-    if (minute_str)
-      t->minute = (int)strtol(minute_str, NULL, 10);
+  const char *path = cache_get_path();
+  char tmp_path[PLATFORM_PATH_MAX + 4];
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
 
-    char *mb_str = get_value(ctx, "minutes_before", obj_start);
-    if (mb_str)
-      t->minutes_before = (int)strtol(mb_str, NULL, 10);
+  FILE *f = platform_file_open(tmp_path, "wb");
+  if (!f)
+    return -1;
 
-    char *pt_str = get_value(ctx, "prayer_time", obj_start);
-    if (pt_str)
-      t->prayer_time = strtod(pt_str, NULL);
+  fwrite(&h, sizeof(h), 1, f);
+  fwrite(pending, sizeof(CacheTrigger), h.trigger_count, f);
 
-    cache->trigger_count++;
+  int write_err = ferror(f) || fflush(f) != 0;
+  if (fclose(f) != 0 || write_err) {
+    platform_file_delete(tmp_path);
+    return -1;
+  }
 
-    *(obj_end + 1) = saved;
-    p = obj_end + 1;
+  if (platform_atomic_rename(tmp_path, path) != 0) {
+    platform_file_delete(tmp_path);
+    return -1;
   }
 
-  json_end(ctx);
-  free(content);
+  // Left behind by a crash, the log would only skip triggers already fired
+  platform_file_delete(cache_get_fired_path());
   return 0;
 }
 
-int cache_save(const PrayerCache *cache) {
-  if (!cache)
+int cache_save_fired(const PrayerCache *cache) {
+  if (!cache || cache->head < 0 || cache->head > cache->trigger_count)
     return -1;
+  if (cache->head == 0)
+    return 0;
   if (ensure_cache_dir() != 0)
     return -1;
 
-  const char *path = cache_get_path();
-  char tmp_path[PLATFORM_PATH_MAX + 4];
-  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
-
-  FILE *f = platform_file_open(tmp_path, "w");
+  FILE *f = platform_file_open(cache_get_fired_path(), "ab");
   if (!f)
     return -1;
 
-  fprintf(f, "{\n");
-  fprintf(f, "  \"date\": \"%s\",\n", cache->date);
-  fprintf(f, "  \"triggers\": [\n");
+  int64_t record = (int64_t)cache->triggers[cache->head - 1].due;
+  fwrite(&record, sizeof(record), 1, f);
+  int write_err = ferror(f) || fflush(f) != 0;
+  if (fclose(f) != 0 || write_err)
+    return -1;
+  return 0;
+}
+
+int cache_pending(const PrayerCache *cache) {
+  return cache ? cache->trigger_count - cache->head : 0;
+}
 
-  for (int i = 0; i < cache->trigger_count; i++) {
+void cache_export_json(const PrayerCache *cache, FILE *out) {
+  fprintf(out, "{\n");
+  fprintf(out, "  \"date\": \"%s\",\n", cache->date);
+  fprintf(out, "  \"days\": %d,\n", cache->days);
+  fprintf(out, "  \"config_hash\": \"%016llx\",\n", (unsigned long long)cache->config_hash);
+  fprintf(out, "  \"triggers\": [\n");
+
+  for (int i = cache->head; i < cache->trigger_count; i++) {
     const CacheTrigger *t = &cache->triggers[i];
-    fprintf(f,
+    fprintf(out,
             "    {\"prayer\": \"%s\", \"minute\": %d, "
-            "\"minutes_before\": %d, \"prayer_time\": %.4f}%s\n",
-            t->prayer, t->minute, t->minutes_before, t->prayer_time,
+            "\"minutes_before\": %d, \"prayer_time\": %.4f, \"due\": %lld}%s\n",
+            t->prayer, t->minute, t->minutes_before, t->prayer_time, (long long)t->due,
             i < cache->trigger_count - 1 ? "," : "");
   }
 
-  fprintf(f, "  ]\n");
-  fprintf(f, "}\n");
+  fprintf(out, "  ]\n");
+  fprintf(out, "}\n");
+}
 
-  int write_err = ferror(f) || fflush(f) != 0;
-  if (fclose(f) != 0 || write_err) {
-    platform_file_delete(tmp_path);
-    return -1;
-  }
+// Local noon of date, so adding whole days never crosses a DST change into the wrong day
+static bool parse_day(const char *date, struct tm *day) {
+  int year = 0, month = 0, mday = 0;
+  if (!date || sscanf(date, "%d-%d-%d", &year, &month, &mday) != 3)
+    return false;
+  memset(day, 0, sizeof(*day));
+  day->tm_year = year - 1900;
+  day->tm_mon = month - 1;
+  day->tm_mday = mday;
+  day->tm_hour = 12;
+  day->tm_isdst = -1;
+  return true;
+}
 
-  if (platform_atomic_rename(tmp_path, path) != 0) {
-    platform_file_delete(tmp_path);
+static struct tm day_after(const struct tm *day, int days) {
+  struct tm next = *day;
+  next.tm_mday += days;
+  next.tm_hour = 12;
+  next.tm_min = 0;
+  next.tm_sec = 0;
+  next.tm_isdst = -1;
+  mktime(&next); // Normalizes the date
+  return next;
+}
+
+// Days since 1970-01-01 of a civil date, independent of the time zone
+static long day_number(const struct tm *day) {
+  long y = day->tm_year + 1900L - (day->tm_mon < 2);
+  long era = (y >= 0 ? y : y - 399) / 400;
+  long yoe = y - era * 400;
+  long m = day->tm_mon + 1;
+  long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + day->tm_mday - 1;
+  long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+int cache_day_index(const PrayerCache *cache, const char *date) {
+  struct tm first, day;
+  if (!cache || !parse_day(cache->date, &first) || !parse_day(date, &day))
     return -1;
-  }
+  long index = day_number(&day) - day_number(&first);
+  return index >= 0 && index < cache->days ? (int)index : -1;
+}
 
-  return 0;
+bool cache_is_current(const PrayerCache *cache, const Config *cfg, const char *date) {
+  return cache && cfg && cache_day_index(cache, date) >= 0 &&
+         cache->config_hash == config_schedule_hash(cfg);
 }
 
 void cache_invalidate(void) {
   const char *path = cache_get_path();
   platform_file_delete(path);
+  platform_file_delete(cache_get_fired_path());
 }
 
 void cache_reset_path(void) {
   cache_path_buf[0] = '\0';
+  fired_path_buf[0] = '\0';
   platform_reset_cached_paths();
 }
 
 static int compare_triggers(const void *a, const void *b) {
   const CacheTrigger *ta = (const CacheTrigger *)a;
   const CacheTrigger *tb = (const CacheTrigger *)b;
-  return ta->minute - tb->minute;
+  return (ta->due > tb->due) - (ta->due < tb->due);
+}
+
+void cache_day_times(const Config *cfg, const struct tm *day, double times[PRAYER_NONE]) {
+  MethodParams params = method_params_from_config(cfg);
+  struct PrayerTimes t = calculate_prayer_times(day->tm_year + 1900, day->tm_mon + 1, day->tm_mday,
+                                                cfg->latitude, cfg->longitude,
+                                                cfg->timezone_offset, &params);
+  prayer_times_unpack(&t, times);
+}
+
+/* Local midnights around one day, so a trigger's due time is an addition
+ * rather than a mktime() call. */
+typedef struct {
+  struct tm day;
+  time_t midnight[3]; // Start of the previous day, the day and the next day
+} DayClock;
+
+static time_t local_midnight(const struct tm *day, int offset) {
+  struct tm at = *day;
+  at.tm_mday += offset;
+  at.tm_hour = 0;
+  at.tm_min = 0;
+  at.tm_sec = 0;
+  at.tm_isdst = -1;
+  return mktime(&at);
+}
+
+static DayClock day_clock(const struct tm *day) {
+  DayClock c = {.day = *day};
+  for (int k = 0; k < 3; k++)
+    c.midnight[k] = local_midnight(day, k - 1);
+  return c;
+}
+
+// Epoch of minute (may be negative: the evening before) of c's day, and its local minute of day
+static time_t clock_due(const DayClock *c, int minute, int *minute_of_day) {
+  int k = minute < 0 ? 0 : 1;
+  time_t base = c->midnight[k];
+  int m = minute < 0 ? minute + 24 * 60 : minute;
+  if (m >= 0 && m < 24 * 60 && c->midnight[k + 1] - base == 24 * 60 * 60) {
+    *minute_of_day = m;
+    return base + (time_t)m * 60;
+  }
+
+  // A DST change that day: let mktime place the minute
+  struct tm at = c->day;
+  at.tm_hour = 0;
+  at.tm_min = minute;
+  at.tm_sec = 0;
+  at.tm_isdst = -1;
+  time_t due = mktime(&at);
+  *minute_of_day = at.tm_hour * 60 + at.tm_min;
+  return due;
+}
+
+static void add_trigger(PrayerCache *cache, const char *name, const DayClock *c, int minute,
+                        int minutes_before, double pt, time_t from) {
+  int minute_of_day = 0;
+  time_t due = clock_due(c, minute, &minute_of_day);
+  if (due < from || cache->trigger_count >= cache->capacity)
+    return; // Capacity was reserved for the worst case
+
+  CacheTrigger *t = &cache->triggers[cache->trigger_count];
+  memset(t, 0, sizeof(*t));
+  if (!copy_string(t->prayer, sizeof(t->prayer), name)) {
+    cache_log_trunc("prayer");
+  }
+  t->minute = minute_of_day;
+  t->minutes_before = minutes_before;
+  t->prayer_time = pt;
+  t->due = due;
+  cache->trigger_count++;
+}
+
+// Append one prayer's exact-time trigger and reminders on day due at or after from
+static void add_prayer_triggers(PrayerCache *cache, const SchedulePlan *plan,
+                                const double times[PRAYER_NONE], const DayClock *c,
+                                PrayerType type, time_t from) {
+  if (!schedule_plan_enabled(plan, type))
+    return;
+
+  double pt = times[type];
+  int prayer_min = (int)ceil(pt * 60.0);
+  const char *name = prayer_get_name(type);
+
+  // Add exact prayer time
+  add_trigger(cache, name, c, prayer_min, 0, pt, from);
+
+  // Add reminders
+  const int *reminders;
+  int count = schedule_plan_reminders(plan, type, &reminders);
+  for (int j = 0; j < count; j++)
+    add_trigger(cache, name, c, prayer_min - reminders[j], reminders[j], pt, from);
+}
+
+static void add_day(PrayerCache *cache, const SchedulePlan *plan, const double times[PRAYER_NONE],
+                    const DayClock *c, time_t from) {
+  for (int i = 0; i < PRAYER_NONE; i++)
+    add_prayer_triggers(cache, plan, times, c, (PrayerType)i, from);
+}
+
+static void sort_triggers(PrayerCache *cache) {
+  // Sort triggers by due time ascending
+  if (cache->trigger_count > 1) {
+    qsort(cache->triggers, (size_t)cache->trigger_count, sizeof(CacheTrigger), compare_triggers);
+  }
+}
+
+// Drop the consumed triggers before the array is modified and resorted
+static void compact(PrayerCache *cache) {
+  if (cache->head == 0)
+    return;
+  memmove(cache->triggers, cache->triggers + cache->head,
+          (size_t)cache_pending(cache) * sizeof(CacheTrigger));
+  cache->trigger_count -= cache->head;
+  cache->head = 0;
+}
+
+// Worst case a day adds for prayer type (all prayers for PRAYER_NONE)
+static int triggers_per_day(const SchedulePlan *plan, PrayerType type) {
+  int n = 0;
+  for (int i = 0; i < PRAYER_NONE; i++) {
+    const int *reminders;
+    if ((type == PRAYER_NONE || type == (PrayerType)i) && (plan->enabled & (1u << i)))
+      n += 1 + schedule_plan_reminders(plan, (PrayerType)i, &reminders);
+  }
+  return n;
+}
+
+static bool reserve_days(PrayerCache *cache, const SchedulePlan *plan, PrayerType type,
+                         int days) {
+  long long need = cache->trigger_count + (long long)days * triggers_per_day(plan, type);
+  return need <= INT_MAX && cache_reserve(cache, (int)need) == 0;
+}
+
+// Reset everything but the trigger block, which the new window reuses
+static bool begin_window(PrayerCache *cache, const Config *cfg, const SchedulePlan *plan,
+                         const char *date, int days, struct tm *first) {
+  CacheTrigger *triggers = cache->triggers;
+  int capacity = cache->capacity;
+  memset(cache, 0, sizeof(*cache));
+  cache->triggers = triggers;
+  cache->capacity = capacity;
+
+  if (!copy_string(cache->date, sizeof(cache->date), date)) {
+    cache_log_trunc("date");
+  }
+  cache->config_hash = config_schedule_hash(cfg);
+  return parse_day(date, first) && reserve_days(cache, plan, PRAYER_NONE, days);
 }
 
 int cache_build_triggers(PrayerCache *cache, const Config *cfg, const struct PrayerTimes *times,
@@ -235,65 +521,120 @@ int cache_build_triggers(PrayerCache *cache, const Config *cfg, const struct Pra
   if (!cache || !cfg || !times || !date_str)
     return 0;
 
-  memset(cache, 0, sizeof(*cache));
-  if (!copy_string(cache->date, sizeof(cache->date), date_str)) {
-    cache_log_trunc("date");
+  SchedulePlan plan;
+  schedule_plan_build(&plan, cfg);
+  struct tm day;
+  if (!begin_window(cache, cfg, &plan, date_str, 1, &day))
+    return -1;
+
+  DayClock c = day_clock(&day);
+  int start_minute;
+  time_t from = clock_due(&c, current_minute, &start_minute);
+  double t[PRAYER_NONE];
+  prayer_times_unpack(times, t);
+  add_day(cache, &plan, t, &c, from);
+  cache->days = 1;
+
+  sort_triggers(cache);
+  return cache->trigger_count;
+}
+
+int cache_build_window(PrayerCache *cache, const Config *cfg, const char *first_date, int days,
+                       time_t from) {
+  if (!cache || !cfg || !first_date)
+    return 0;
+  if (days < 0)
+    days = 0;
+
+  SchedulePlan plan;
+  schedule_plan_build(&plan, cfg);
+  struct tm first;
+  if (!begin_window(cache, cfg, &plan, first_date, days, &first))
+    return -1;
+
+  for (int k = 0; k < days; k++) {
+    struct tm day = day_after(&first, k);
+    double times[PRAYER_NONE];
+    cache_day_times(cfg, &day, times);
+    DayClock c = day_clock(&day);
+    add_day(cache, &plan, times, &c, from);
   }
+  cache->days = days;
 
-  PrayerType prayer_types[] = {PRAYER_FAJR, PRAYER_SUNRISE, PRAYER_DHUHA, PRAYER_DHUHR,
-                               PRAYER_ASR,  PRAYER_MAGHRIB, PRAYER_ISHA};
-
-  for (int i = 0; i < 7; i++) {
-    PrayerType type = prayer_types[i];
-    if (!prayer_is_enabled(cfg, type))
-      continue;
-
-    double pt = prayer_get_time(times, type);
-    int prayer_min = (int)ceil(pt * 60.0);
-    const char *name = prayer_get_name(type);
-    const PrayerConfig *pcfg = prayer_get_config(cfg, type);
-
-    // Add exact prayer time
-    if (prayer_min >= current_minute && cache->trigger_count < MAX_TRIGGERS) {
-      CacheTrigger *t = &cache->triggers[cache->trigger_count];
-      if (!copy_string(t->prayer, sizeof(t->prayer), name)) {
-        cache_log_trunc("prayer");
-      }
-      t->minute = prayer_min;
-      t->minutes_before = 0;
-      t->prayer_time = pt;
-      cache->trigger_count++;
-    }
+  sort_triggers(cache);
+  return cache->trigger_count;
+}
+
+int cache_extend(PrayerCache *cache, const Config *cfg, const char *today, time_t from) {
+  int index = cache_day_index(cache, today);
+  if (index < 0 || !cfg)
+    return -1;
 
-    // Add reminders
-    for (int j = 0; j < pcfg->reminder_count; j++) {
-      int reminder_min = prayer_min - pcfg->reminders[j];
-      if (reminder_min < 0)
-        reminder_min += 24 * 60;
-
-      if (reminder_min >= current_minute && cache->trigger_count < MAX_TRIGGERS) {
-        CacheTrigger *t = &cache->triggers[cache->trigger_count];
-        if (!copy_string(t->prayer, sizeof(t->prayer), name)) {
-          cache_log_trunc("prayer");
-        }
-        t->minute = reminder_min;
-        t->minutes_before = pcfg->reminders[j];
-        t->prayer_time = pt;
-        cache->trigger_count++;
-      }
+  if (index > 0) {
+    if (!copy_string(cache->date, sizeof(cache->date), today)) {
+      cache_log_trunc("date");
     }
+    cache->days -= index;
   }
+  if (cache->days >= CACHE_WINDOW_DAYS)
+    return 0;
 
-  // Sort triggers by minute ascending
-  if (cache->trigger_count > 1) {
-    qsort(cache->triggers, (size_t)cache->trigger_count, sizeof(CacheTrigger), compare_triggers);
+  compact(cache);
+  SchedulePlan plan;
+  schedule_plan_build(&plan, cfg);
+  if (!reserve_days(cache, &plan, PRAYER_NONE, CACHE_WINDOW_DAYS - cache->days))
+    return -1;
+
+  struct tm first;
+  parse_day(cache->date, &first);
+  int added = 0;
+  for (; cache->days < CACHE_WINDOW_DAYS; cache->days++, added++) {
+    struct tm day = day_after(&first, cache->days);
+    double times[PRAYER_NONE];
+    cache_day_times(cfg, &day, times);
+    DayClock c = day_clock(&day);
+    add_day(cache, &plan, times, &c, from);
+  }
+
+  // A new day's early reminders can fall before the end of the previous day
+  sort_triggers(cache);
+  return added;
+}
+
+int cache_rebuild_prayer(PrayerCache *cache, const Config *cfg, PrayerType type, time_t from) {
+  if (!cache || !cfg || type >= PRAYER_NONE)
+    return 0;
+
+  const char *name = prayer_get_name(type);
+  compact(cache);
+  int kept = 0;
+  for (int i = 0; i < cache->trigger_count; i++) {
+    if (strcmp(cache->triggers[i].prayer, name) != 0)
+      cache->triggers[kept++] = cache->triggers[i];
   }
+  cache->trigger_count = kept;
+  SchedulePlan plan;
+  schedule_plan_build(&plan, cfg);
+  if (!reserve_days(cache, &plan, type, cache->days))
+    return -1;
 
+  struct tm first;
+  if (parse_day(cache->date, &first)) {
+    for (int k = 0; k < cache->days; k++) {
+      struct tm day = day_after(&first, k);
+      double times[PRAYER_NONE];
+      cache_day_times(cfg, &day, times);
+      DayClock c = day_clock(&day);
+      add_prayer_triggers(cache, &plan, times, &c, type, from);
+    }
+  }
+  sort_triggers(cache);
+  cache->config_hash = config_schedule_hash(cfg);
   return cache->trigger_count;
 }
 
 void cache_remove_trigger(PrayerCache *cache, int index) {
-  if (!cache || index < 0 || index >= cache->trigger_count)
+  if (!cache || index < cache->head || index >= cache->trigger_count)
     return;
 
   for (int i = index; i < cache->trigger_count - 1; i++) {
@@ -301,3 +642,26 @@ void cache_remove_trigger(PrayerCache *cache, int index) {
   }
   cache->trigger_count--;
 }
+
+void cache_remove_first(PrayerCache *cache, int count) {
+  if (!cache || count <= 0)
+    return;
+  if (count > cache_pending(cache))
+    count = cache_pending(cache);
+  cache->head += count;
+}
+
+int cache_first_due_after(const PrayerCache *cache, time_t t) {
+  if (!cache)
+    return 0;
+
+  int lo = cache->head, hi = cache->trigger_count;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (cache->triggers[mid].due <= t)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
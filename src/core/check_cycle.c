@@ -12,6 +12,80 @@
 #include <string.h>
 #include <time.h>
 
+static void desktop_notify(const CacheTrigger *trigger, const Config *cfg, void *user) {
+  (void)user;
+  char time_str[16];
+  format_time_hm(trigger->prayer_time, time_str, sizeof(time_str));
+
+  const char *sound_preset = NULL;
+  if (cfg->notification_sound) {
+    sound_preset = (trigger->minutes_before == 0) ? cfg->notification_sound_alarm
+                                                  : cfg->notification_sound_reminder;
+  }
+  notify_prayer(trigger->prayer, time_str, trigger->minutes_before, cfg->notification_urgency,
+                sound_preset);
+}
+
+static int local_minute(time_t now, struct tm *tm_now, char *today, size_t today_size) {
+  platform_localtime(&now, tm_now);
+  snprintf(today, today_size, "%04d-%02d-%02d", tm_now->tm_year + 1900, tm_now->tm_mon + 1,
+           tm_now->tm_mday);
+  return tm_now->tm_hour * 60 + tm_now->tm_min;
+}
+
+/* Deliver the triggers due at or before now and remove them. Triggers due at
+ * or before *fired_through were handled before a backward clock step and are
+ * removed silently; ones more than cfg->notification_catchup minutes late
+ * (suspend, forward step) are dropped. Advances *fired_through.
+ * Returns: number of triggers removed, or -1 if the notification system failed */
+static int fire_due(PrayerCache *cache, const Config *cfg, time_t now, time_t *fired_through,
+                    CheckNotifyFn notify, void *user) {
+  int due = cache_first_due_after(cache, now);
+  time_t oldest = now - (time_t)cfg->notification_catchup * 60;
+  int fired = 0;
+
+  for (int i = cache->head; i < due; i++) {
+    const CacheTrigger *t = &cache->triggers[i];
+    if (t->due <= *fired_through)
+      continue;
+    *fired_through = t->due;
+
+    if (t->due < oldest) {
+      fprintf(stderr, "Skipped %s notification, %ld min late\n", t->prayer,
+              (long)((now - t->due) / 60));
+      continue;
+    }
+
+    if (fired == 0 && !notify) {
+      if (!notify_init_once("Muslimtify")) {
+        fprintf(stderr, "Error: Failed to initialize notification system\n");
+        return -1;
+      }
+    }
+    fired++;
+
+    if (notify)
+      notify(t, cfg, user);
+    else
+      desktop_notify(t, cfg, NULL);
+  }
+
+  if (fired > 0 && !notify)
+    notify_cleanup();
+  int removed = due - cache->head;
+  cache_remove_first(cache, removed);
+  return removed;
+}
+
+/* Persist after a check: a rolled window rewrites the cache file, consumed
+ * triggers alone only append to the fired log. */
+static void persist(const PrayerCache *cache, int removed, int added) {
+  if (added > 0)
+    cache_save(cache);
+  else if (removed > 0)
+    cache_save_fired(cache);
+}
+
 int run_check_cycle(void) {
   Config cfg;
   if (config_load(&cfg) != 0) {
@@ -25,62 +99,160 @@ int run_check_cycle(void) {
   }
 
   time_t now = time(NULL);
-  struct tm tm_buf;
-  platform_localtime(&now, &tm_buf);
-  struct tm *tm_now = &tm_buf;
-
-  int current_min = tm_now->tm_hour * 60 + tm_now->tm_min;
+  struct tm tm_now;
   char today[32];
-  snprintf(today, sizeof(today), "%04d-%02d-%02d", tm_now->tm_year + 1900, tm_now->tm_mon + 1,
-           tm_now->tm_mday);
+  local_minute(now, &tm_now, today, sizeof(today));
+
+  // Rebuilt when today left the window or the schedule-relevant config changed
+  time_t minute_start = now - tm_now.tm_sec;
+  PrayerCache cache = {0};
+  if (cache_load(&cache) != 0 || !cache_is_current(&cache, &cfg, today)) {
+    if (cache_build_window(&cache, &cfg, today, CACHE_WINDOW_DAYS, minute_start) < 0) {
+      cache_free(&cache);
+      return 1;
+    }
+    cache_save(&cache);
+  }
 
-  PrayerCache cache;
-  bool cache_valid =
-      (cache_load(&cache) == 0 && strcmp(cache.date, today) == 0 && cache.trigger_count > 0);
+  // The cache itself records what was fired: whatever is left and due is new
+  time_t fired_through = 0;
+  int removed = fire_due(&cache, &cfg, now, &fired_through, NULL, NULL);
+  if (removed >= 0)
+    persist(&cache, removed, cache_extend(&cache, &cfg, today, minute_start));
 
-  if (!cache_valid) {
-    MethodParams params = method_params_from_config(&cfg);
-    struct PrayerTimes times =
-        calculate_prayer_times(tm_now->tm_year + 1900, tm_now->tm_mon + 1, tm_now->tm_mday,
-                               cfg.latitude, cfg.longitude, cfg.timezone_offset, &params);
+  cache_free(&cache);
+  return removed < 0 ? 1 : 0;
+}
 
-    cache_build_triggers(&cache, &cfg, &times, current_min, today);
-    cache_save(&cache);
+void daemon_state_init(DaemonState *st) {
+  memset(st, 0, sizeof(*st));
+}
+
+void daemon_state_free(DaemonState *st) {
+  cache_free(&st->cache);
+  memset(st, 0, sizeof(*st));
+}
+
+/* Reload config.json if its stamp moved since the last load. A missing file
+ * keeps the loaded config (config_load would only hand back defaults).
+ * Returns: CONFIG_DIFF_* bits against the previous config (all of them on
+ * the first load), 0 if unchanged, -1 on error */
+static int refresh_config(DaemonState *st) {
+  const char *path = config_get_path();
+  PlatformFileStamp stamp;
+  bool exists = platform_file_stamp(path, &stamp) == 0;
+
+  // A missing config.json keeps the loaded config, even when a reload was requested
+  if (st->config_loaded &&
+      (!exists || (!st->reload_requested && stamp.mtime_ns == st->config_stamp.mtime_ns &&
+                   stamp.size == st->config_stamp.size)))
+    return 0;
+
+  // Remember the stamp first so a broken file is retried only after it changes again
+  st->reload_requested = false;
+  if (exists)
+    st->config_stamp = stamp;
+
+  Config cfg;
+  if (config_load(&cfg) != 0) {
+    fprintf(stderr, "Error: Failed to load config\n");
+    return -1;
   }
 
-  bool notified = false;
-  int i = 0;
-  while (i < cache.trigger_count) {
-    if (cache.triggers[i].minute == current_min) {
-      if (!notified) {
-        if (!notify_init_once("Muslimtify")) {
-          fprintf(stderr, "Error: Failed to initialize notification system\n");
-          return 1;
-        }
-        notified = true;
-      }
+  if (location_prepare(&cfg) != 0) {
+    fprintf(stderr, "Error: Failed to detect location\n");
+    return -1;
+  }
 
-      char time_str[16];
-      format_time_hm(cache.triggers[i].prayer_time, time_str, sizeof(time_str));
+  // location_prepare may have saved detected coordinates
+  if (platform_file_stamp(path, &stamp) == 0)
+    st->config_stamp = stamp;
 
-      const char *sound_preset = NULL;
-      if (cfg.notification_sound) {
-        sound_preset = (cache.triggers[i].minutes_before == 0) ? cfg.notification_sound_alarm
-                                                               : cfg.notification_sound_reminder;
-      }
-      notify_prayer(cache.triggers[i].prayer, time_str, cache.triggers[i].minutes_before,
-                    cfg.notification_urgency, sound_preset);
+  unsigned diff = st->config_loaded ? config_diff(&st->cfg, &cfg)
+                                    : CONFIG_DIFF_TIMES | CONFIG_DIFF_PRAYERS | CONFIG_DIFF_OTHER;
+  st->cfg = cfg;
+  st->config_loaded = true;
+  st->last_diff = diff;
+  return (int)diff;
+}
+
+int daemon_state_check(DaemonState *st, time_t now) {
+  bool first = !st->config_loaded;
+  int reload = refresh_config(st);
+  unsigned diff = reload > 0 ? (unsigned)reload : 0;
+  if (!st->config_loaded)
+    return 1;
+
+  struct tm tm_now;
+  char today[32];
+  local_minute(now, &tm_now, today, sizeof(today));
 
-      cache_remove_trigger(&cache, i);
-    } else {
-      i++;
+  // Nothing before the minute the daemon started in is caught up
+  time_t minute_start = now - tm_now.tm_sec;
+  if (first)
+    st->fired_through = minute_start - 1;
+
+  // Start inside the catch-up window so triggers missed across a suspend are
+  // still delivered; fired_through stops repeats
+  time_t from = minute_start - (time_t)st->cfg.notification_catchup * 60;
+
+  if ((diff & CONFIG_DIFF_TIMES) || cache_day_index(&st->cache, today) < 0) {
+    // At startup, keep what `check` or an earlier daemon already fired
+    bool resumed =
+        first && cache_load(&st->cache) == 0 && cache_is_current(&st->cache, &st->cfg, today);
+    if (!resumed) {
+      cache_build_window(&st->cache, &st->cfg, today, CACHE_WINDOW_DAYS, from);
+      cache_save(&st->cache);
     }
+  } else if (diff & CONFIG_DIFF_PRAYERS) {
+    // Same times: only the prayers whose reminders or switch changed
+    for (int i = 0; i < PRAYER_NONE; i++) {
+      if (diff & CONFIG_DIFF_PRAYER(i))
+        cache_rebuild_prayer(&st->cache, &st->cfg, (PrayerType)i, from);
+    }
+    cache_save(&st->cache);
   }
 
-  if (notified) {
-    notify_cleanup();
-    cache_save(&cache);
+  int removed =
+      fire_due(&st->cache, &st->cfg, now, &st->fired_through, st->notify, st->notify_user);
+  if (removed < 0)
+    return 1;
+
+  // Roll the window only after delivering, so a new day is never built
+  // between a trigger and its notification
+  persist(&st->cache, removed, cache_extend(&st->cache, &st->cfg, today, from));
+
+  return reload < 0 ? 1 : 0;
+}
+
+void daemon_state_request_reload(DaemonState *st) {
+  st->reload_requested = true;
+}
+
+bool daemon_state_config_changed(const DaemonState *st) {
+  PlatformFileStamp stamp;
+  if (!st->config_loaded || platform_file_stamp(config_get_path(), &stamp) != 0)
+    return false;
+  return stamp.mtime_ns != st->config_stamp.mtime_ns || stamp.size != st->config_stamp.size;
+}
+
+time_t daemon_state_next_wake(const DaemonState *st, time_t now) {
+  struct tm tm_wake;
+  char today[32];
+  int current_min = local_minute(now, &tm_wake, today, sizeof(today));
+
+  int next_min = current_min + 1;
+  if (st->config_loaded && cache_day_index(&st->cache, today) >= 0) {
+    int next = cache_first_due_after(&st->cache, now);
+    if (next < st->cache.trigger_count)
+      return st->cache.triggers[next].due;
+    next_min = 24 * 60;
   }
 
-  return 0;
+  // mktime normalizes hour 24 to the next day's midnight
+  tm_wake.tm_hour = next_min / 60;
+  tm_wake.tm_min = next_min % 60;
+  tm_wake.tm_sec = 0;
+  tm_wake.tm_isdst = -1;
+  return mktime(&tm_wake);
 }
@@ -1,8 +1,10 @@
 #define JSON_IMPLEMENTATION
 #include "config.h"
+#include "ephemeris.h"
 #include "json.h"
 #include "platform.h"
 #include "string_util.h"
+#include "version.h"
 #include <ctype.h>
 #include <errno.h>
 #include <stdio.h>
@@ -82,6 +84,7 @@ Config config_default(void) {
 
   // Notification defaults
   cfg.notification_timeout = 5000;
+  cfg.notification_catchup = 15;
   if (!copy_string(cfg.notification_urgency, sizeof(cfg.notification_urgency), "critical")) {
     log_truncation("notification_urgency");
   }
@@ -188,6 +191,7 @@ static int write_json_file(FILE *f, const Config *cfg) {
 
   fprintf(f, "  \"notification\": {\n");
   fprintf(f, "    \"timeout\": %d,\n", cfg->notification_timeout);
+  fprintf(f, "    \"catchup\": %d,\n", cfg->notification_catchup);
   fprintf(f, "    \"urgency\": ");
   json_escape_string(f, cfg->notification_urgency);
   fprintf(f, ",\n");
@@ -424,6 +428,7 @@ int config_load(Config *cfg) {
   char *notification = get_value(ctx, "notification", content);
   if (notification) {
     char *timeout_str = get_value(ctx, "timeout", notification);
+    char *catchup_str = get_value(ctx, "catchup", notification);
     char *urgency_str = get_value(ctx, "urgency", notification);
     char *sound_str = get_value(ctx, "sound", notification);
     char *sound_alarm_str = get_value(ctx, "sound_alarm", notification);
@@ -432,6 +437,8 @@ int config_load(Config *cfg) {
 
     if (timeout_str)
       cfg->notification_timeout = (int)strtol(timeout_str, NULL, 10);
+    if (catchup_str)
+      cfg->notification_catchup = (int)strtol(catchup_str, NULL, 10);
     if (urgency_str) {
       if (!copy_string(cfg->notification_urgency, sizeof(cfg->notification_urgency), urgency_str)) {
         log_truncation("notification_urgency");
@@ -500,6 +507,9 @@ bool config_validate(const Config *cfg) {
   if (cfg->timezone_offset < -12.0 || cfg->timezone_offset > 14.0)
     return false;
 
+  if (cfg->notification_catchup < 0 || cfg->notification_catchup > 1440)
+    return false;
+
   // Validate reminders
   const PrayerConfig *prayers[] = {&cfg->fajr, &cfg->sunrise, &cfg->dhuha, &cfg->dhuhr,
                                    &cfg->asr,  &cfg->maghrib, &cfg->isha};
@@ -518,6 +528,91 @@ bool config_validate(const Config *cfg) {
   return true;
 }
 
+static bool prayer_config_equal(const PrayerConfig *a, const PrayerConfig *b) {
+  if (a->enabled != b->enabled || a->reminder_count != b->reminder_count)
+    return false;
+  for (int i = 0; i < a->reminder_count && i < MAX_REMINDERS; i++) {
+    if (a->reminders[i] != b->reminders[i])
+      return false;
+  }
+  return true;
+}
+
+unsigned config_diff(const Config *a, const Config *b) {
+  unsigned diff = 0;
+
+  if (a->latitude != b->latitude || a->longitude != b->longitude ||
+      a->timezone_offset != b->timezone_offset ||
+      strcmp(a->calculation_method, b->calculation_method) != 0 ||
+      strcmp(a->madhab, b->madhab) != 0 || a->fajr_angle != b->fajr_angle ||
+      a->isha_angle != b->isha_angle)
+    diff |= CONFIG_DIFF_TIMES;
+
+  const PrayerConfig *pa[] = {&a->fajr, &a->sunrise, &a->dhuha, &a->dhuhr,
+                              &a->asr,  &a->maghrib, &a->isha};
+  const PrayerConfig *pb[] = {&b->fajr, &b->sunrise, &b->dhuha, &b->dhuhr,
+                              &b->asr,  &b->maghrib, &b->isha};
+  for (int i = 0; i < 7; i++) {
+    if (!prayer_config_equal(pa[i], pb[i]))
+      diff |= CONFIG_DIFF_PRAYER(i);
+  }
+
+  if (a->auto_detect != b->auto_detect || strcmp(a->timezone, b->timezone) != 0 ||
+      strcmp(a->city, b->city) != 0 || strcmp(a->country, b->country) != 0 ||
+      a->notification_timeout != b->notification_timeout ||
+      a->notification_catchup != b->notification_catchup ||
+      strcmp(a->notification_urgency, b->notification_urgency) != 0 ||
+      a->notification_sound != b->notification_sound ||
+      strcmp(a->notification_sound_alarm, b->notification_sound_alarm) != 0 ||
+      strcmp(a->notification_sound_reminder, b->notification_sound_reminder) != 0 ||
+      strcmp(a->notification_icon, b->notification_icon) != 0)
+    diff |= CONFIG_DIFF_OTHER;
+
+  return diff;
+}
+
+#define FNV64_OFFSET 0xcbf29ce484222325ULL
+#define FNV64_PRIME 0x100000001b3ULL
+
+static uint64_t fnv1a(uint64_t h, const void *data, size_t len) {
+  const unsigned char *p = data;
+  for (size_t i = 0; i < len; i++) {
+    h ^= p[i];
+    h *= FNV64_PRIME;
+  }
+  return h;
+}
+
+static uint64_t fnv1a_str(uint64_t h, const char *s) {
+  return fnv1a(h, s, strlen(s) + 1);
+}
+
+uint64_t config_schedule_hash(const Config *cfg) {
+  uint64_t h = fnv1a_str(FNV64_OFFSET, MUSLIMTIFY_VERSION);
+  uint64_t sun_source = ephemeris_installed_id();
+  h = fnv1a(h, &sun_source, sizeof(sun_source));
+
+  const double numbers[] = {cfg->latitude, cfg->longitude, cfg->timezone_offset, cfg->fajr_angle,
+                            cfg->isha_angle};
+  h = fnv1a(h, numbers, sizeof(numbers));
+  h = fnv1a_str(h, cfg->calculation_method);
+  h = fnv1a_str(h, cfg->madhab);
+
+  const PrayerConfig *prayers[] = {&cfg->fajr, &cfg->sunrise, &cfg->dhuha, &cfg->dhuhr,
+                                   &cfg->asr,  &cfg->maghrib, &cfg->isha};
+  for (int i = 0; i < 7; i++) {
+    const PrayerConfig *p = prayers[i];
+    unsigned char enabled = p->enabled ? 1 : 0;
+    int count = p->reminder_count < 0               ? 0
+                : p->reminder_count > MAX_REMINDERS ? MAX_REMINDERS
+                                                    : p->reminder_count;
+    h = fnv1a(h, &enabled, 1);
+    h = fnv1a(h, &count, sizeof(count));
+    h = fnv1a(h, p->reminders, (size_t)count * sizeof(p->reminders[0]));
+  }
+  return h;
+}
+
 PrayerConfig *config_get_prayer(Config *cfg, const char *prayer_name) {
   if (!cfg || !prayer_name)
     return NULL;
@@ -8,47 +8,355 @@ int seconds_until_next_minute(time_t now) {
   return (int)(60 - now % 60);
 }
 
+int wake_counter_tick(WakeCounter *c, time_t now, int *finished_day, unsigned *finished_count) {
+  struct tm tm_now;
+  localtime_r(&now, &tm_now);
+  int day = (tm_now.tm_year + 1900) * 10000 + (tm_now.tm_mon + 1) * 100 + tm_now.tm_mday;
+
+  int rolled = 0;
+  if (c->day != 0 && c->day != day) {
+    *finished_day = c->day;
+    *finished_count = c->count;
+    c->count = 0;
+    rolled = 1;
+  }
+  c->day = day;
+  c->count++;
+  return rolled;
+}
+
+void clock_discontinuity(const ClockSample *prev, const ClockSample *cur, long long *stepped,
+                         long long *suspended) {
+  long long real = cur->realtime - prev->realtime;
+  long long boot = cur->boottime - prev->boottime;
+  long long mono = cur->monotonic - prev->monotonic;
+  *stepped = real - boot;
+  *suspended = boot - mono;
+}
+
 #ifndef MUSLIMTIFY_DAEMON_LOOP_TEST
 
 #include "check_cycle.h"
+#include "config.h"
+#include "platform.h"
+#include "query.h"
+#include "reactor.h"
+#include "snapshot.h"
 
+#include <errno.h>
 #include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
 
-static volatile sig_atomic_t g_stop = 0;
+typedef struct {
+  DaemonState state;
+  WakeCounter wakeups;
+  ClockSample last_clock;
+  int timer_fd;    /* -1: no timerfd, the reactor's poll timeout stands in */
+  int timeout_ms;  /* Poll timeout when timer_fd < 0 */
+  time_t started;
+  unsigned long long queries;
+  LatencyHistogram clients; /* Serve time per query; client sources are removed as served */
+  SnapshotWriter snapshot; /* region NULL: not published */
+  bool stop;
+} Daemon;
 
-static void handle_stop_signal(int signum) {
-  (void)signum;
-  g_stop = 1;
+static ClockSample clock_sample(void) {
+  struct timespec ts;
+  ClockSample c;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  c.realtime = ts.tv_sec;
+  clock_gettime(CLOCK_BOOTTIME, &ts);
+  c.boottime = ts.tv_sec;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  c.monotonic = ts.tv_sec;
+  return c;
 }
 
-/* Sleep until the next wall-clock minute boundary (<=60s), returning early when
- * a signal interrupts the sleep. Bounds each nap so suspend/resume or a clock
- * jump cannot overshoot, and keeps fires aligned to :00 like the old timer. */
-static void sleep_to_next_minute(void) {
-  struct timespec req = {.tv_sec = seconds_until_next_minute(time(NULL)), .tv_nsec = 0};
-  nanosleep(&req, NULL); /* EINTR on signal: return early; loop re-checks g_stop */
+/* Log wall-clock steps and suspends since the previous wake-up. The check
+ * cycle's catch-up policy decides what to deliver; this makes it traceable. */
+static void log_discontinuity(const ClockSample *prev, const ClockSample *cur) {
+  long long stepped, suspended;
+  clock_discontinuity(prev, cur, &stepped, &suspended);
+  if (suspended >= CLOCK_JUMP_THRESHOLD)
+    printf("muslimtify daemon: resumed after %lld s suspended\n", suspended);
+  if (stepped >= CLOCK_JUMP_THRESHOLD || stepped <= -CLOCK_JUMP_THRESHOLD)
+    printf("muslimtify daemon: wall clock stepped %+lld s\n", stepped);
+  fflush(stdout);
 }
 
-int run_daemon_loop(void) {
-  struct sigaction sa;
-  sa.sa_handler = handle_stop_signal;
-  sigemptyset(&sa.sa_mask);
-  sa.sa_flags = 0; /* no SA_RESTART: let nanosleep return on signal */
-  sigaction(SIGTERM, &sa, NULL);
-  sigaction(SIGINT, &sa, NULL);
-
-  printf("muslimtify daemon: started (Ctrl+C or SIGTERM to stop)\n");
+static void log_wakeups(int day, unsigned count) {
+  printf("muslimtify daemon: %u wake-ups on %04d-%02d-%02d\n", count, day / 10000,
+         day / 100 % 100, day % 100);
   fflush(stdout);
+}
+
+static uint64_t monotonic_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void log_histogram(const char *name, const LatencyHistogram *h) {
+  printf("muslimtify daemon: %-7s %llu events, p50 <%llu us, p99 <%llu us, max %llu us\n", name,
+         (unsigned long long)h->count,
+         (unsigned long long)(latency_percentile_ns(h, 0.50) / 1000),
+         (unsigned long long)(latency_percentile_ns(h, 0.99) / 1000),
+         (unsigned long long)(h->max_ns / 1000));
+}
+
+static void log_latency(const Reactor *r, const LatencyHistogram *clients) {
+  for (int i = 0; i < r->count; i++) {
+    const ReactorSource *s = &r->sources[i];
+    if (s->fd >= 0 && strcmp(s->name, QUERY_CLIENT_SOURCE) != 0)
+      log_histogram(s->name, &s->latency);
+  }
+  log_histogram(QUERY_CLIENT_SOURCE, clients);
+  fflush(stdout);
+}
+
+static time_t next_midnight(time_t now) {
+  struct tm tm_next;
+  localtime_r(&now, &tm_next);
+  tm_next.tm_mday++;
+  tm_next.tm_hour = 0;
+  tm_next.tm_min = 0;
+  tm_next.tm_sec = 0;
+  tm_next.tm_isdst = -1;
+  return mktime(&tm_next);
+}
+
+/* Check, then arm the timer for the next wake-up. Both use the same instant,
+ * so a trigger in the minute that began during the check is still ahead. */
+static void daemon_cycle(Daemon *d) {
+  ClockSample clock = clock_sample();
+  log_discontinuity(&d->last_clock, &clock);
+  d->last_clock = clock;
+
+  time_t now = time(NULL);
+  int finished_day;
+  unsigned finished_count;
+  if (wake_counter_tick(&d->wakeups, now, &finished_day, &finished_count))
+    log_wakeups(finished_day, finished_count);
+
+  if (daemon_state_check(&d->state, now) != 0) {
+    fprintf(stderr, "muslimtify daemon: check cycle reported an error, continuing\n");
+  }
+
+  SnapshotData snap;
+  if (snapshot_fill(&snap, &d->state, now) == 0)
+    snapshot_publish(&d->snapshot, &snap);
+
+  time_t wake = daemon_state_next_wake(&d->state, now);
+  if (d->snapshot.region && wake > next_midnight(now))
+    wake = next_midnight(now); /* Readers only trust the snapshot for its own day */
+  if (d->timer_fd >= 0) {
+    /* Absolute CLOCK_REALTIME expiry; CANCEL_ON_SET wakes us if the clock
+     * is set so the next cycle re-plans against the new time */
+    struct itimerspec its = {.it_interval = {0, 0}, .it_value = {.tv_sec = wake, .tv_nsec = 0}};
+    if (timerfd_settime(d->timer_fd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &its, NULL) ==
+        0)
+      return;
+  }
+
+  /* No timer: poll towards wake in steps ending on minute boundaries, so a
+   * suspend or clock jump cannot overshoot by more than a minute */
+  time_t nap = wake > now ? wake - now : 0;
+  if (nap > seconds_until_next_minute(now))
+    nap = seconds_until_next_minute(now);
+  d->timeout_ms = (int)nap * 1000;
+}
+
+static void on_signal(Reactor *r, int fd, uint32_t events, void *user) {
+  (void)events;
+  Daemon *d = user;
+  struct signalfd_siginfo si;
+  while (read(fd, &si, sizeof(si)) == (ssize_t)sizeof(si)) {
+    switch (si.ssi_signo) {
+    case SIGHUP:
+      daemon_state_request_reload(&d->state);
+      daemon_cycle(d);
+      break;
+    case SIGUSR1:
+      log_latency(r, &d->clients);
+      break;
+    default:
+      d->stop = true;
+      break;
+    }
+  }
+}
+
+static void on_timer(Reactor *r, int fd, uint32_t events, void *user) {
+  (void)r;
+  (void)events;
+  uint64_t expirations;
+  /* ECANCELED after a clock change: re-plan like an expiry */
+  if (read(fd, &expirations, sizeof(expirations)) < 0 && errno == EAGAIN)
+    return;
+  daemon_cycle(user);
+}
+
+static void on_config_dir(Reactor *r, int fd, uint32_t events, void *user) {
+  (void)r;
+  (void)events;
+  Daemon *d = user;
+  char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+  bool changed = false;
+  ssize_t len;
+  while ((len = read(fd, buf, sizeof(buf))) > 0) {
+    for (char *p = buf; p < buf + len;) {
+      const struct inotify_event *ev = (const struct inotify_event *)p;
+      /* config_save writes config.json.tmp and renames it over config.json */
+      if (ev->len > 0 && strcmp(ev->name, "config.json") == 0)
+        changed = true;
+      p += sizeof(*ev) + ev->len;
+    }
+  }
+  if (changed) {
+    daemon_state_request_reload(&d->state);
+    daemon_cycle(d);
+  }
+}
+
+/* The reactor cannot time this handler, which removes its own source, so it
+ * records into d->clients itself. */
+static void on_query_client(Reactor *r, int fd, uint32_t events, void *user) {
+  (void)events;
+  Daemon *d = user;
+  uint64_t start = monotonic_ns();
+  /* A save the config watch has not dispatched yet must not be answered
+   * from the old config */
+  if (daemon_state_config_changed(&d->state))
+    daemon_cycle(d);
+
+  QueryContext ctx = {&d->state, r, d->started, d->wakeups.count, ++d->queries, &d->clients};
+  query_serve(fd, &ctx, time(NULL));
+  reactor_remove(r, fd);
+  close(fd);
+  latency_record(&d->clients, monotonic_ns() - start);
+}
+
+static void on_query(Reactor *r, int fd, uint32_t events, void *user) {
+  (void)events;
+  int client;
+  while ((client = query_accept(fd)) >= 0) {
+    if (reactor_add(r, client, QUERY_CLIENT_SOURCE, on_query_client, user) < 0)
+      close(client);
+  }
+}
+
+int run_daemon_loop(void) {
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGTERM);
+  sigaddset(&mask, SIGINT);
+  sigaddset(&mask, SIGHUP);
+  sigaddset(&mask, SIGUSR1);
+  sigprocmask(SIG_BLOCK, &mask, NULL);
+
+  Reactor reactor;
+  int signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+  if (reactor_init(&reactor) != 0 || signal_fd < 0) {
+    fprintf(stderr, "muslimtify daemon: cannot set up epoll/signalfd\n");
+    if (signal_fd >= 0)
+      close(signal_fd);
+    reactor_free(&reactor);
+    sigprocmask(SIG_UNBLOCK, &mask, NULL);
+    return 1;
+  }
+
+  static Daemon d;
+  memset(&d, 0, sizeof(d));
+  daemon_state_init(&d.state);
+  d.last_clock = clock_sample();
+  d.timeout_ms = -1;
+  d.started = time(NULL);
+
+  reactor_add(&reactor, signal_fd, "signal", on_signal, &d);
+
+  d.timer_fd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (d.timer_fd < 0 || reactor_add(&reactor, d.timer_fd, "timer", on_timer, &d) < 0) {
+    fprintf(stderr, "muslimtify daemon: timerfd unavailable, polling each minute\n");
+    if (d.timer_fd >= 0)
+      close(d.timer_fd);
+    d.timer_fd = -1;
+  }
 
-  while (!g_stop) {
-    if (run_check_cycle() != 0) {
-      fprintf(stderr, "muslimtify daemon: check cycle reported an error, continuing\n");
+  /* Watch the directory, not the file: saves replace config.json by rename */
+  int inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  const char *config_dir = platform_config_dir();
+  uint32_t watch_mask = IN_CLOSE_WRITE | IN_MOVED_TO;
+  if (inotify_fd >= 0 && (platform_mkdir_p(config_dir) != 0 ||
+                          inotify_add_watch(inotify_fd, config_dir, watch_mask) < 0 ||
+                          reactor_add(&reactor, inotify_fd, "config", on_config_dir, &d) < 0)) {
+    close(inotify_fd);
+    inotify_fd = -1;
+  }
+  if (inotify_fd < 0)
+    fprintf(stderr, "muslimtify daemon: cannot watch config; use SIGHUP to reload\n");
+
+  char query_path[PLATFORM_PATH_MAX];
+  int query_fd = -1;
+  if (query_socket_path(query_path, sizeof(query_path)) == 0) {
+    query_fd = query_listen(query_path);
+    if (query_fd >= 0 && reactor_add(&reactor, query_fd, "query", on_query, &d) < 0) {
+      close(query_fd);
+      unlink(query_path);
+      query_fd = -1;
     }
-    if (g_stop)
+  }
+  if (query_fd < 0)
+    fprintf(stderr, "muslimtify daemon: no query socket; commands compute locally\n");
+
+  char snapshot_file[PLATFORM_PATH_MAX];
+  if (snapshot_path(snapshot_file, sizeof(snapshot_file)) != 0 ||
+      snapshot_writer_open(&d.snapshot, snapshot_file) != 0)
+    fprintf(stderr, "muslimtify daemon: no schedule snapshot; commands compute locally\n");
+
+  printf("muslimtify daemon: started (Ctrl+C or SIGTERM to stop, SIGHUP to reload, SIGUSR1 for "
+         "stats)\n");
+  fflush(stdout);
+
+  daemon_cycle(&d);
+  while (!d.stop) {
+    int timeout_ms = d.timer_fd >= 0 ? -1 : d.timeout_ms;
+    int handled = reactor_poll(&reactor, timeout_ms);
+    if (handled < 0) {
+      perror("muslimtify daemon: epoll_wait");
       break;
-    sleep_to_next_minute();
+    }
+    if (handled == 0 && d.timer_fd < 0)
+      daemon_cycle(&d);
+  }
+
+  if (d.wakeups.day != 0)
+    log_wakeups(d.wakeups.day, d.wakeups.count);
+  log_latency(&reactor, &d.clients);
+
+  if (query_fd >= 0) {
+    for (int i = 0; i < reactor.count; i++) {
+      if (reactor.sources[i].fd >= 0 && reactor.sources[i].fn == on_query_client)
+        close(reactor.sources[i].fd);
+    }
+    close(query_fd);
+    unlink(query_path);
   }
+  snapshot_writer_close(&d.snapshot);
+  reactor_free(&reactor);
+  daemon_state_free(&d.state);
+  if (inotify_fd >= 0)
+    close(inotify_fd);
+  if (d.timer_fd >= 0)
+    close(d.timer_fd);
+  close(signal_fd);
+  sigprocmask(SIG_UNBLOCK, &mask, NULL);
 
   printf("muslimtify daemon: stopped\n");
   fflush(stdout);
@@ -82,6 +82,21 @@ static void print_horizontal_line(char pos) {
   printf("%s\n", right);
 }
 
+// Index of the next enabled prayer when date is today, else -1
+static int next_index_today(const SchedulePlan *plan, const double times[PRAYER_NONE],
+                            const struct tm *date) {
+  time_t now_t = time(NULL);
+  struct tm now_tm;
+  platform_localtime(&now_t, &now_tm);
+  if (date->tm_year != now_tm.tm_year || date->tm_mon != now_tm.tm_mon ||
+      date->tm_mday != now_tm.tm_mday)
+    return -1;
+
+  int dummy;
+  PrayerType next = prayer_plan_next(plan, times, &now_tm, &dummy);
+  return next == PRAYER_NONE ? -1 : (int)next;
+}
+
 void display_prayer_times_table(const struct PrayerTimes *times, const Config *cfg,
                                 struct tm *date) {
   // Copy the caller's date to avoid clobbering it when platform_localtime() is called below
@@ -104,29 +119,13 @@ void display_prayer_times_table(const struct PrayerTimes *times, const Config *c
     printf("Location: %.4f, %.4f\n\n", cfg->latitude, cfg->longitude);
   }
 
-  const char *prayer_names[] = {"Fajr", "Sunrise", "Dhuha", "Dhuhr", "Asr", "Maghrib", "Isha"};
-  PrayerType types[] = {PRAYER_FAJR, PRAYER_SUNRISE, PRAYER_DHUHA, PRAYER_DHUHR,
-                        PRAYER_ASR,  PRAYER_MAGHRIB, PRAYER_ISHA};
+  SchedulePlan plan;
+  schedule_plan_build(&plan, cfg);
+  double prayer_times[PRAYER_NONE];
+  prayer_times_unpack(times, prayer_times);
 
   // Find the next upcoming prayer for today
-  int next_idx = -1;
-  {
-    time_t now_t = time(NULL);
-    struct tm now_buf;
-    platform_localtime(&now_t, &now_buf);
-    struct tm *now_tm = &now_buf;
-    if (date_copy.tm_year == now_tm->tm_year && date_copy.tm_mon == now_tm->tm_mon &&
-        date_copy.tm_mday == now_tm->tm_mday) {
-      int dummy;
-      PrayerType next = prayer_get_next(cfg, now_tm, (struct PrayerTimes *)times, &dummy);
-      for (int i = 0; i < 7; i++) {
-        if (types[i] == next) {
-          next_idx = i;
-          break;
-        }
-      }
-    }
-  }
+  int next_idx = next_index_today(&plan, prayer_times, &date_copy);
 
   // Table header
   print_horizontal_line('t');
@@ -135,13 +134,14 @@ void display_prayer_times_table(const struct PrayerTimes *times, const Config *c
          C(COL_RESET), BOX_V, C(COL_BOLD), "Reminders", C(COL_RESET), BOX_V);
   print_horizontal_line('m');
 
-  for (int i = 0; i < 7; i++) {
-    double prayer_time = prayer_get_time(times, types[i]);
+  for (int i = 0; i < PRAYER_NONE; i++) {
+    const char *name = prayer_get_name((PrayerType)i);
     char time_str[16];
-    format_time_hm(prayer_time, time_str, sizeof(time_str));
+    format_time_hm(prayer_times[i], time_str, sizeof(time_str));
 
-    const PrayerConfig *pcfg = prayer_get_config(cfg, types[i]);
-    bool enabled = pcfg->enabled;
+    bool enabled = schedule_plan_enabled(&plan, (PrayerType)i);
+    // Reminders as the user wrote them; the plan's copy is in firing order
+    const PrayerConfig *pcfg = prayer_get_config(cfg, (PrayerType)i);
 
     // Buffer sized for: MAX_REMINDERS * "1440, " + " min before" = 10*6+11 = 71
     char reminders[80] = "";
@@ -166,17 +166,17 @@ void display_prayer_times_table(const struct PrayerTimes *times, const Config *c
 
     if (!enabled) {
       // Dim entire row; "Disabled" is exactly 8 chars
-      printf("%s%s %-10s %s %-8s %s Disabled %s %-21s %s%s\n", C(COL_DIM), BOX_V, prayer_names[i],
+      printf("%s%s %-10s %s %-8s %s Disabled %s %-21s %s%s\n", C(COL_DIM), BOX_V, name,
              BOX_V, time_str, BOX_V, BOX_V, "-", BOX_V, C(COL_RESET));
     } else if (is_next) {
       // Next prayer: bold+yellow name, yellow time, > indicator
       printf("%s%s%s%-10s%s %s %s%-8s%s %s %sEnabled %s %s %-21s %s\n", BOX_V,
-             C(COL_BOLD COL_YELLOW), use_colors() ? ">" : " ", prayer_names[i], C(COL_RESET), BOX_V,
+             C(COL_BOLD COL_YELLOW), use_colors() ? ">" : " ", name, C(COL_RESET), BOX_V,
              C(COL_YELLOW), time_str, C(COL_RESET), BOX_V, C(COL_GREEN), C(COL_RESET), BOX_V,
              reminders, BOX_V);
     } else {
       // Normal enabled row; "Enabled " (7+1 space) = 8 chars
-      printf("%s %-10s %s %-8s %s %sEnabled %s %s %-21s %s\n", BOX_V, prayer_names[i], BOX_V,
+      printf("%s %-10s %s %-8s %s %sEnabled %s %s %-21s %s\n", BOX_V, name, BOX_V,
              time_str, BOX_V, C(COL_GREEN), C(COL_RESET), BOX_V, reminders, BOX_V);
     }
   }
@@ -189,44 +189,27 @@ void display_prayer_times_plain(const struct PrayerTimes *times, const Config *c
                                 struct tm *date) {
   struct tm date_copy = *date;
 
-  const char *prayer_names[] = {"Fajr", "Sunrise", "Dhuha", "Dhuhr", "Asr", "Maghrib", "Isha"};
-  PrayerType types[] = {PRAYER_FAJR, PRAYER_SUNRISE, PRAYER_DHUHA, PRAYER_DHUHR,
-                        PRAYER_ASR,  PRAYER_MAGHRIB, PRAYER_ISHA};
+  SchedulePlan plan;
+  schedule_plan_build(&plan, cfg);
+  double prayer_times[PRAYER_NONE];
+  prayer_times_unpack(times, prayer_times);
 
   // Find the next upcoming prayer for today
-  int next_idx = -1;
-  {
-    time_t now_t = time(NULL);
-    struct tm now_buf;
-    platform_localtime(&now_t, &now_buf);
-    struct tm *now_tm = &now_buf;
-    if (date_copy.tm_year == now_tm->tm_year && date_copy.tm_mon == now_tm->tm_mon &&
-        date_copy.tm_mday == now_tm->tm_mday) {
-      int dummy;
-      PrayerType next = prayer_get_next(cfg, now_tm, (struct PrayerTimes *)times, &dummy);
-      for (int i = 0; i < 7; i++) {
-        if (types[i] == next) {
-          next_idx = i;
-          break;
-        }
-      }
-    }
-  }
+  int next_idx = next_index_today(&plan, prayer_times, &date_copy);
 
-  for (int i = 0; i < 7; i++) {
-    const PrayerConfig *pcfg = prayer_get_config(cfg, types[i]);
-    if (!pcfg->enabled)
+  for (int i = 0; i < PRAYER_NONE; i++) {
+    if (!schedule_plan_enabled(&plan, (PrayerType)i))
       continue;
 
-    double prayer_time = prayer_get_time(times, types[i]);
+    const char *name = prayer_get_name((PrayerType)i);
     char time_str[16];
-    format_time_hm(prayer_time, time_str, sizeof(time_str));
+    format_time_hm(prayer_times[i], time_str, sizeof(time_str));
 
     if (i == next_idx) {
-      printf("%s%s%s=%s%s\n", C(COL_BOLD COL_YELLOW), prayer_names[i],
-             C(COL_RESET COL_BOLD COL_YELLOW), time_str, C(COL_RESET));
+      printf("%s%s%s=%s%s\n", C(COL_BOLD COL_YELLOW), name, C(COL_RESET COL_BOLD COL_YELLOW),
+             time_str, C(COL_RESET));
     } else {
-      printf("%s=%s\n", prayer_names[i], time_str);
+      printf("%s=%s\n", name, time_str);
     }
   }
 }
@@ -315,15 +298,22 @@ void display_prayer_times_json(const struct PrayerTimes *times, const Config *cf
 
 void display_next_prayer(const struct PrayerTimes *times, const Config *cfg,
                          struct tm *current_time) {
+  SchedulePlan plan;
+  schedule_plan_build(&plan, cfg);
+  double prayer_times[PRAYER_NONE];
+  prayer_times_unpack(times, prayer_times);
+
   int minutes_until = 0;
-  PrayerType next = prayer_get_next(cfg, current_time, (struct PrayerTimes *)times, &minutes_until);
+  PrayerType next = prayer_plan_next(&plan, prayer_times, current_time, &minutes_until);
+  display_next_prayer_at(next, next == PRAYER_NONE ? 0.0 : prayer_times[next], minutes_until);
+}
 
+void display_next_prayer_at(PrayerType next, double prayer_time, int minutes_until) {
   if (next == PRAYER_NONE) {
     printf("No upcoming prayers enabled.\n");
     return;
   }
 
-  double prayer_time = prayer_get_time(times, next);
   char time_str[16];
   format_time_hm(prayer_time, time_str, sizeof(time_str));
 
@@ -360,6 +350,7 @@ void display_config(const Config *cfg) {
 
   printf("Notification Settings:\n");
   printf("  Timeout: %d ms\n", cfg->notification_timeout);
+  printf("  Catch-up: %d min\n", cfg->notification_catchup);
   printf("  Urgency: %s\n", cfg->notification_urgency);
   printf("  Sound: %s\n", cfg->notification_sound ? "enabled" : "disabled");
   printf("  Icon: %s\n\n", cfg->notification_icon);
@@ -376,18 +367,16 @@ void display_config(const Config *cfg) {
 void display_prayer_list(const Config *cfg) {
   printf("\nPrayer Notifications:\n");
 
-  const char *prayer_names[] = {"Fajr", "Sunrise", "Dhuha", "Dhuhr", "Asr", "Maghrib", "Isha"};
-  PrayerType types[] = {PRAYER_FAJR, PRAYER_SUNRISE, PRAYER_DHUHA, PRAYER_DHUHR,
-                        PRAYER_ASR,  PRAYER_MAGHRIB, PRAYER_ISHA};
+  SchedulePlan plan;
+  schedule_plan_build(&plan, cfg);
 
   int enabled_count = 0;
   printf("  Enabled:  ");
-  for (int i = 0; i < 7; i++) {
-    const PrayerConfig *pcfg = prayer_get_config(cfg, types[i]);
-    if (pcfg->enabled) {
+  for (int i = 0; i < PRAYER_NONE; i++) {
+    if (schedule_plan_enabled(&plan, (PrayerType)i)) {
       if (enabled_count > 0)
         printf(", ");
-      printf("%s", prayer_names[i]);
+      printf("%s", prayer_get_name((PrayerType)i));
       enabled_count++;
     }
   }
@@ -397,12 +386,11 @@ void display_prayer_list(const Config *cfg) {
 
   int disabled_count = 0;
   printf("  Disabled: ");
-  for (int i = 0; i < 7; i++) {
-    const PrayerConfig *pcfg = prayer_get_config(cfg, types[i]);
-    if (!pcfg->enabled) {
+  for (int i = 0; i < PRAYER_NONE; i++) {
+    if (!schedule_plan_enabled(&plan, (PrayerType)i)) {
       if (disabled_count > 0)
         printf(", ");
-      printf("%s", prayer_names[i]);
+      printf("%s", prayer_get_name((PrayerType)i));
       disabled_count++;
     }
   }
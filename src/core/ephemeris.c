@@ -0,0 +1,186 @@
+#include "ephemeris.h"
+#include "platform.h"
+#include "prayertimes.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static char ephemeris_path_buf[PLATFORM_PATH_MAX] = {0};
+static EphemerisTable installed = {0};
+static uint64_t installed_id = 0;
+
+const char *ephemeris_get_path(void) {
+  if (ephemeris_path_buf[0] != '\0')
+    return ephemeris_path_buf;
+
+  const char *dir = platform_cache_dir();
+  if (dir[0] != '\0') {
+    snprintf(ephemeris_path_buf, sizeof(ephemeris_path_buf), "%s%c%s", dir, PLATFORM_PATH_SEP,
+             EPHEMERIS_FILE_NAME);
+  }
+
+  return ephemeris_path_buf;
+}
+
+int ephemeris_write(const char *path, int first_year, int last_year, EphemerisSourceFn source,
+                    const char *source_name) {
+  if (!path || !source || last_year < first_year)
+    return -1;
+
+  EphemerisHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, EPHEMERIS_MAGIC, sizeof(header.magic));
+  header.version = EPHEMERIS_VERSION;
+  header.byte_order = EPHEMERIS_BYTE_ORDER;
+  header.first_jd = julian_day_for_date(first_year, 1, 1);
+  header.count = (uint32_t)(julian_day_for_date(last_year + 1, 1, 1) - header.first_jd);
+  snprintf(header.source, sizeof(header.source), "%s", source_name ? source_name : "");
+
+  char tmp_path[PLATFORM_PATH_MAX + 4];
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+  FILE *f = platform_file_open(tmp_path, "wb");
+  if (!f)
+    return -1;
+
+  fwrite(&header, sizeof(header), 1, f);
+  for (uint32_t i = 0; i < header.count; i++) {
+    double record[2];
+    source(header.first_jd + i, &record[0], &record[1]);
+    fwrite(record, sizeof(record), 1, f);
+  }
+
+  int write_err = ferror(f) || fflush(f) != 0;
+  if (fclose(f) != 0 || write_err) {
+    platform_file_delete(tmp_path);
+    return -1;
+  }
+
+  if (platform_atomic_rename(tmp_path, path) != 0) {
+    platform_file_delete(tmp_path);
+    return -1;
+  }
+
+  return 0;
+}
+
+int ephemeris_open(EphemerisTable *table, const char *path) {
+  if (!table || !path)
+    return -1;
+  memset(table, 0, sizeof(*table));
+
+  size_t size = 0;
+  const void *map = platform_map_file(path, &size);
+  if (!map)
+    return -1;
+
+  const EphemerisHeader *header = map;
+  if (size < sizeof(*header) ||
+      memcmp(header->magic, EPHEMERIS_MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != EPHEMERIS_VERSION || header->byte_order != EPHEMERIS_BYTE_ORDER ||
+      header->count < 4 || size != sizeof(*header) + (size_t)header->count * 2 * sizeof(double)) {
+    platform_unmap_file(map, size);
+    return -1;
+  }
+
+  table->map = map;
+  table->map_size = size;
+  table->header = header;
+  table->records = (const double *)(header + 1);
+  return 0;
+}
+
+void ephemeris_close(EphemerisTable *table) {
+  if (!table || !table->map)
+    return;
+  platform_unmap_file(table->map, table->map_size);
+  memset(table, 0, sizeof(*table));
+}
+
+int ephemeris_lookup(const EphemerisTable *table, double jd, double *declination,
+                     double *equation_of_time) {
+  if (!table || !table->map)
+    return 0;
+
+  uint32_t count = table->header->count;
+  double x = jd - table->header->first_jd;
+  if (!(x >= 0.0) || x > (double)(count - 1))
+    return 0;
+
+  double whole = floor(x);
+  double f = x - whole;
+  uint32_t i = (uint32_t)whole;
+  const double *r = table->records;
+
+  if (f == 0.0) {
+    *declination = r[2 * i];
+    *equation_of_time = r[2 * i + 1];
+    return 1;
+  }
+
+  /* Cubic through days i-1..i+2, shifted inward at the table edges */
+  if (i < 1)
+    i = 1;
+  if (i > count - 3)
+    i = count - 3;
+  f = x - (double)i;
+
+  double w[4] = {
+      -f * (f - 1.0) * (f - 2.0) / 6.0,
+      (f + 1.0) * (f - 1.0) * (f - 2.0) / 2.0,
+      -(f + 1.0) * f * (f - 2.0) / 2.0,
+      (f + 1.0) * f * (f - 1.0) / 6.0,
+  };
+  double decl = 0.0, eqt = 0.0;
+  for (int k = 0; k < 4; k++) {
+    decl += w[k] * r[2 * (i - 1 + k)];
+    eqt += w[k] * r[2 * (i - 1 + k) + 1];
+  }
+  *declination = decl;
+  *equation_of_time = eqt;
+  return 1;
+}
+
+static int installed_source(double jd, double *declination, double *equation_of_time,
+                            void *user) {
+  return ephemeris_lookup(user, jd, declination, equation_of_time);
+}
+
+static uint64_t fnv1a(uint64_t h, const void *data, size_t len) {
+  const unsigned char *p = data;
+  for (size_t i = 0; i < len; i++) {
+    h ^= p[i];
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+int ephemeris_install(const char *path) {
+  // Stamped before mapping: a table replaced in between gets its
+  // predecessor's id, which the next run sees as a change
+  PlatformFileStamp stamp;
+  if (platform_file_stamp(path, &stamp) != 0)
+    return -1;
+  EphemerisTable table;
+  if (ephemeris_open(&table, path) != 0)
+    return -1;
+
+  ephemeris_uninstall();
+  installed = table;
+  uint64_t id = fnv1a(0xcbf29ce484222325ULL, table.header, sizeof(*table.header));
+  id = fnv1a(id, &stamp.mtime_ns, sizeof(stamp.mtime_ns));
+  id = fnv1a(id, &stamp.size, sizeof(stamp.size));
+  installed_id = id ? id : 1;
+  prayer_set_sun_source(installed_source, &installed);
+  return 0;
+}
+
+void ephemeris_uninstall(void) {
+  prayer_set_sun_source(NULL, NULL);
+  ephemeris_close(&installed);
+  installed_id = 0;
+}
+
+uint64_t ephemeris_installed_id(void) {
+  return installed_id;
+}
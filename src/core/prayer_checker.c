@@ -1,26 +1,14 @@
 #include "prayer_checker.h"
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
+
+static const char *const PRAYER_NAMES[PRAYER_NONE] = {
+    "Fajr", "Sunrise", "Dhuha", "Dhuhr", "Asr", "Maghrib", "Isha",
+};
 
 const char *prayer_get_name(PrayerType type) {
-  switch (type) {
-  case PRAYER_FAJR:
-    return "Fajr";
-  case PRAYER_SUNRISE:
-    return "Sunrise";
-  case PRAYER_DHUHA:
-    return "Dhuha";
-  case PRAYER_DHUHR:
-    return "Dhuhr";
-  case PRAYER_ASR:
-    return "Asr";
-  case PRAYER_MAGHRIB:
-    return "Maghrib";
-  case PRAYER_ISHA:
-    return "Isha";
-  default:
-    return "Unknown";
-  }
+  return (unsigned)type < PRAYER_NONE ? PRAYER_NAMES[type] : "Unknown";
 }
 
 double prayer_get_time(const struct PrayerTimes *times, PrayerType type) {
@@ -70,73 +58,221 @@ bool prayer_is_enabled(const Config *cfg, PrayerType type) {
   return pcfg ? pcfg->enabled : false;
 }
 
-PrayerMatch prayer_check_current(const Config *cfg, struct tm *now, struct PrayerTimes *times) {
-  PrayerMatch no_match = {.type = PRAYER_NONE, .minutes_before = -1, .prayer_time = 0.0};
+void schedule_plan_build(SchedulePlan *plan, const Config *cfg) {
+  memset(plan, 0, sizeof(*plan));
+  int n = 0;
+  for (int i = 0; i < PRAYER_NONE; i++) {
+    const PrayerConfig *pcfg = prayer_get_config(cfg, (PrayerType)i);
+    if (pcfg->enabled)
+      plan->enabled |= 1u << i;
+    plan->reminder_first[i] = (uint8_t)n;
 
-  // Compare at integer-minute granularity to avoid double-firing
-  // when a prayer time falls between two minutes (e.g., 19:24:30).
-  int current_min = now->tm_hour * 60 + now->tm_min;
+    // Insertion sort, largest offset first; at most MAX_REMINDERS entries
+    int *r = &plan->reminders[n];
+    int count = 0;
+    for (int j = 0; j < pcfg->reminder_count && j < MAX_REMINDERS; j++) {
+      int k = count++;
+      for (; k > 0 && r[k - 1] < pcfg->reminders[j]; k--)
+        r[k] = r[k - 1];
+      r[k] = pcfg->reminders[j];
+    }
+    n += count;
+  }
+  plan->reminder_first[PRAYER_NONE] = (uint8_t)n;
+}
 
-  // Array of all prayers to check
-  PrayerType prayers[] = {PRAYER_FAJR, PRAYER_SUNRISE, PRAYER_DHUHA, PRAYER_DHUHR,
-                          PRAYER_ASR,  PRAYER_MAGHRIB, PRAYER_ISHA};
+bool schedule_plan_enabled(const SchedulePlan *plan, PrayerType type) {
+  return (unsigned)type < PRAYER_NONE && (plan->enabled >> type) & 1u;
+}
 
-  for (int i = 0; i < 7; i++) {
-    PrayerType type = prayers[i];
+int schedule_plan_reminders(const SchedulePlan *plan, PrayerType type, const int **reminders) {
+  if ((unsigned)type >= PRAYER_NONE)
+    return 0;
+  *reminders = &plan->reminders[plan->reminder_first[type]];
+  return plan->reminder_first[type + 1] - plan->reminder_first[type];
+}
 
-    // Skip if disabled
-    if (!prayer_is_enabled(cfg, type))
-      continue;
+void prayer_times_unpack(const struct PrayerTimes *times, double out[PRAYER_NONE]) {
+  out[PRAYER_FAJR] = times->fajr;
+  out[PRAYER_SUNRISE] = times->sunrise;
+  out[PRAYER_DHUHA] = times->dhuha;
+  out[PRAYER_DHUHR] = times->dhuhr;
+  out[PRAYER_ASR] = times->asr;
+  out[PRAYER_MAGHRIB] = times->maghrib;
+  out[PRAYER_ISHA] = times->isha;
+}
 
-    // Get prayer time and ceil to match display (Kemenag standard)
-    double prayer_time = prayer_get_time(times, type);
-    int prayer_min = (int)ceil(prayer_time * 60.0);
-    const PrayerConfig *pcfg = prayer_get_config(cfg, type);
+static int bit_count(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcount(x);
+#else
+  x = x - ((x >> 1) & 0x55555555u);
+  x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+  return (int)((((x + (x >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24);
+#endif
+}
 
-    // Check exact prayer time (same minute)
-    if (prayer_min == current_min) {
-      PrayerMatch match = {.type = type, .minutes_before = 0, .prayer_time = prayer_time};
-      return match;
-    }
+// x must be non-zero
+static int lowest_bit(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(x);
+#else
+  int n = 0;
+  while (!(x & 1u)) {
+    x >>= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
+// Index of minute's set bit among all set bits (minute's bit must be set)
+static int map_slot(const MinuteMap *map, int minute) {
+  int w = minute / 32;
+  uint32_t below = (1u << (minute % 32)) - 1u;
+  return map->rank[w] + bit_count(map->bits[w] & below);
+}
+
+void prayer_map_build(MinuteMap *map, const SchedulePlan *plan,
+                      const struct PrayerTimes *times) {
+  memset(map, 0, sizeof(*map));
+  prayer_times_unpack(times, map->prayer_time);
 
-    // Check reminders
-    for (int j = 0; j < pcfg->reminder_count; j++) {
-      int reminder_offset = pcfg->reminders[j];
-      int reminder_min = prayer_min - reminder_offset;
+  // Gather in check order: prayers in sequence, exact time before reminders
+  int minutes[MINUTE_MAP_SLOTS];
+  MinuteTrigger found[MINUTE_MAP_SLOTS];
+  int count = 0;
+  for (int i = 0; i < PRAYER_NONE; i++) {
+    if (!(plan->enabled & (1u << i)))
+      continue;
+
+    // Ceil to match display (Kemenag standard)
+    double prayer_min = ceil(map->prayer_time[i] * 60.0);
+    if (!(prayer_min > -MINUTES_PER_DAY && prayer_min < 2 * MINUTES_PER_DAY))
+      continue; // Polar day or night: no usable time
+    const int *reminders;
+    int reminder_count = schedule_plan_reminders(plan, (PrayerType)i, &reminders);
+    for (int j = -1; j < reminder_count; j++) {
+      int offset = j < 0 ? 0 : reminders[j];
+      int minute = (int)prayer_min - offset;
       // Normalize for midnight crossover
-      if (reminder_min < 0)
-        reminder_min += 24 * 60;
-
-      if (reminder_min == current_min) {
-        PrayerMatch match = {
-            .type = type, .minutes_before = reminder_offset, .prayer_time = prayer_time};
-        return match;
-      }
+      if (minute < 0)
+        minute += MINUTES_PER_DAY;
+      if (minute < 0 || minute >= MINUTES_PER_DAY)
+        continue;
+      minutes[count] = minute;
+      found[count].type = (uint8_t)i;
+      found[count].minutes_before = (int16_t)offset;
+      count++;
+      map->bits[minute / 32] |= 1u << (minute % 32);
     }
   }
 
-  return no_match;
+  int set = 0;
+  for (int w = 0; w < MINUTE_MAP_WORDS; w++) {
+    map->rank[w] = (uint8_t)set;
+    set += bit_count(map->bits[w]);
+  }
+
+  // Counting sort by minute; stable, so each minute keeps check order
+  int fill[MINUTE_MAP_SLOTS + 1] = {0};
+  for (int i = 0; i < count; i++)
+    fill[map_slot(map, minutes[i]) + 1]++;
+  for (int k = 0; k < set; k++)
+    fill[k + 1] += fill[k];
+  for (int k = 0; k <= set; k++)
+    map->first[k] = (uint8_t)fill[k];
+  for (int i = 0; i < count; i++)
+    map->triggers[fill[map_slot(map, minutes[i])]++] = found[i];
+}
+
+bool prayer_map_due(const MinuteMap *map, int minute) {
+  if (minute < 0 || minute >= MINUTES_PER_DAY)
+    return false;
+  return (map->bits[minute / 32] >> (minute % 32)) & 1u;
+}
+
+int prayer_map_next(const MinuteMap *map, int minute) {
+  if (minute < 0)
+    minute = 0;
+  if (minute >= MINUTES_PER_DAY)
+    return -1;
+
+  int w = minute / 32;
+  uint32_t word = map->bits[w] & (~0u << (minute % 32));
+  while (!word) {
+    if (++w == MINUTE_MAP_WORDS)
+      return -1;
+    word = map->bits[w];
+  }
+  return w * 32 + lowest_bit(word);
+}
+
+int prayer_map_lookup(const MinuteMap *map, int minute, const MinuteTrigger **triggers) {
+  if (!prayer_map_due(map, minute))
+    return 0;
+  int k = map_slot(map, minute);
+  *triggers = &map->triggers[map->first[k]];
+  return map->first[k + 1] - map->first[k];
+}
+
+PrayerMatch prayer_map_check(const MinuteMap *map, int minute) {
+  PrayerMatch match = {.type = PRAYER_NONE, .minutes_before = -1, .prayer_time = 0.0};
+  const MinuteTrigger *t;
+  if (prayer_map_lookup(map, minute, &t) > 0) {
+    match.type = (PrayerType)t->type;
+    match.minutes_before = t->minutes_before;
+    match.prayer_time = map->prayer_time[t->type];
+  }
+  return match;
+}
+
+PrayerMatch prayer_check_cached(PrayerCheckCache *cache, const Config *cfg,
+                                const struct tm *now, const struct PrayerTimes *times) {
+  // A caller polling the same day compiles the map once; the plan is cheap
+  // to build and compares with memcmp
+  SchedulePlan plan;
+  schedule_plan_build(&plan, cfg);
+  if (!cache->valid || memcmp(&plan, &cache->plan, sizeof(plan)) != 0 ||
+      memcmp(times, &cache->times, sizeof(*times)) != 0) {
+    prayer_map_build(&cache->map, &plan, times);
+    cache->plan = plan;
+    cache->times = *times;
+    cache->valid = true;
+  }
+
+  // Compare at integer-minute granularity to avoid double-firing
+  // when a prayer time falls between two minutes (e.g., 19:24:30).
+  return prayer_map_check(&cache->map, now->tm_hour * 60 + now->tm_min);
+}
+
+PrayerMatch prayer_check_current(const Config *cfg, struct tm *now, struct PrayerTimes *times) {
+  static PrayerCheckCache cache;
+  return prayer_check_cached(&cache, cfg, now, times);
 }
 
 PrayerType prayer_get_next(const Config *cfg, struct tm *now, struct PrayerTimes *times,
                            int *minutes_until) {
-  double current_time = now->tm_hour + now->tm_min / 60.0;
+  SchedulePlan plan;
+  schedule_plan_build(&plan, cfg);
+  double t[PRAYER_NONE];
+  prayer_times_unpack(times, t);
+  return prayer_plan_next(&plan, t, now, minutes_until);
+}
 
-  PrayerType prayers[] = {PRAYER_FAJR, PRAYER_SUNRISE, PRAYER_DHUHA, PRAYER_DHUHR,
-                          PRAYER_ASR,  PRAYER_MAGHRIB, PRAYER_ISHA};
+PrayerType prayer_plan_next(const SchedulePlan *plan, const double times[PRAYER_NONE],
+                            const struct tm *now, int *minutes_until) {
+  double current_time = now->tm_hour + now->tm_min / 60.0;
 
   PrayerType next_prayer = PRAYER_NONE;
   double min_diff = 24.0 * 60.0; // Max minutes in a day
 
-  for (int i = 0; i < 7; i++) {
-    PrayerType type = prayers[i];
-
+  for (int i = 0; i < PRAYER_NONE; i++) {
     // Skip if disabled
-    if (!prayer_is_enabled(cfg, type))
+    if (!(plan->enabled & (1u << i)))
       continue;
 
-    double prayer_time = prayer_get_time(times, type);
-    double diff_hours = prayer_time - current_time;
+    double diff_hours = times[i] - current_time;
 
     // Handle prayers that are tomorrow (negative diff means passed today)
     if (diff_hours < 0) {
@@ -147,7 +283,7 @@ PrayerType prayer_get_next(const Config *cfg, struct tm *now, struct PrayerTimes
 
     if (diff_minutes < min_diff) {
       min_diff = diff_minutes;
-      next_prayer = type;
+      next_prayer = (PrayerType)i;
     }
   }
 
@@ -0,0 +1,212 @@
+#include "prayertimes_soa.h"
+
+#include <math.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) ||         \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PT_SOA_X86 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+/* -- SSE2 instantiation (baseline on x86-64, no runtime check needed) ---- */
+
+#ifdef PT_SOA_X86
+
+#define V __m128d
+#define V_WIDTH 2
+#define V_SET1 _mm_set1_pd
+#define V_LOAD _mm_loadu_pd
+#define V_STORE _mm_storeu_pd
+#define V_ADD _mm_add_pd
+#define V_SUB _mm_sub_pd
+#define V_MUL _mm_mul_pd
+#define V_DIV _mm_div_pd
+#define V_SQRT _mm_sqrt_pd
+#define V_AND _mm_and_pd
+#define V_OR _mm_or_pd
+#define V_XOR _mm_xor_pd
+#define V_ANDNOT _mm_andnot_pd
+#define V_LT _mm_cmplt_pd
+#define V_GT _mm_cmpgt_pd
+#define V_EQ _mm_cmpeq_pd
+#define PT_SOA_TARGET
+#define PT_SOA_FN(name) pt_soa_sse2_##name
+#include "prayertimes_soa_kernel.h"
+#undef V
+#undef V_WIDTH
+#undef V_SET1
+#undef V_LOAD
+#undef V_STORE
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_DIV
+#undef V_SQRT
+#undef V_AND
+#undef V_OR
+#undef V_XOR
+#undef V_ANDNOT
+#undef V_LT
+#undef V_GT
+#undef V_EQ
+#undef PT_SOA_TARGET
+#undef PT_SOA_FN
+
+/* -- AVX2 instantiation (enabled per function, selected at run time) ----- */
+
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define PT_SOA_HAVE_AVX2 1
+
+#define V __m256d
+#define V_WIDTH 4
+#define V_SET1 _mm256_set1_pd
+#define V_LOAD _mm256_loadu_pd
+#define V_STORE _mm256_storeu_pd
+#define V_ADD _mm256_add_pd
+#define V_SUB _mm256_sub_pd
+#define V_MUL _mm256_mul_pd
+#define V_DIV _mm256_div_pd
+#define V_SQRT _mm256_sqrt_pd
+#define V_AND _mm256_and_pd
+#define V_OR _mm256_or_pd
+#define V_XOR _mm256_xor_pd
+#define V_ANDNOT _mm256_andnot_pd
+#define V_LT(a, b) _mm256_cmp_pd((a), (b), _CMP_LT_OQ)
+#define V_GT(a, b) _mm256_cmp_pd((a), (b), _CMP_GT_OQ)
+#define V_EQ(a, b) _mm256_cmp_pd((a), (b), _CMP_EQ_OQ)
+#ifdef _MSC_VER
+#define PT_SOA_TARGET
+#else
+#define PT_SOA_TARGET __attribute__((target("avx2")))
+#endif
+#define PT_SOA_FN(name) pt_soa_avx2_##name
+#include "prayertimes_soa_kernel.h"
+#undef V
+#undef V_WIDTH
+#undef V_SET1
+#undef V_LOAD
+#undef V_STORE
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_DIV
+#undef V_SQRT
+#undef V_AND
+#undef V_OR
+#undef V_XOR
+#undef V_ANDNOT
+#undef V_LT
+#undef V_GT
+#undef V_EQ
+#undef PT_SOA_TARGET
+#undef PT_SOA_FN
+#endif
+
+#endif /* PT_SOA_X86 */
+
+/* -- Runtime dispatch ---------------------------------------------------- */
+
+#ifdef PT_SOA_HAVE_AVX2
+static int cpu_has_avx2(void) {
+#ifdef _MSC_VER
+  int regs[4];
+  __cpuid(regs, 0);
+  if (regs[0] < 7)
+    return 0;
+  __cpuid(regs, 1);
+  int osxsave = (regs[2] >> 27) & 1;
+  int avx = (regs[2] >> 28) & 1;
+  if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+    return 0;
+  __cpuidex(regs, 7, 0);
+  return (regs[1] >> 5) & 1;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+PrayerSimdIsa prayer_simd_detect(void) {
+  static int detected = -1;
+  if (detected < 0) {
+    PrayerSimdIsa isa = PRAYER_SIMD_SCALAR;
+#ifdef PT_SOA_X86
+    isa = PRAYER_SIMD_SSE2;
+#endif
+#ifdef PT_SOA_HAVE_AVX2
+    if (cpu_has_avx2())
+      isa = PRAYER_SIMD_AVX2;
+#endif
+    detected = (int)isa;
+  }
+  return (PrayerSimdIsa)detected;
+}
+
+const char *prayer_simd_isa_name(PrayerSimdIsa isa) {
+  switch (isa) {
+  case PRAYER_SIMD_SSE2:
+    return "sse2";
+  case PRAYER_SIMD_AVX2:
+    return "avx2";
+  default:
+    return "scalar";
+  }
+}
+
+static void run_scalar(const PrayerLocationCtx *m, const SunState *sun, size_t n,
+                       const double *lat, const double *lon, const double *tz,
+                       const PrayerTimesSoA *out) {
+  for (size_t i = 0; i < n; i++) {
+    PrayerLocationCtx ctx;
+    prayer_location_ctx_init(&ctx, lat[i], lon[i], tz[i], &m->params);
+    struct PrayerTimes t = prayer_times_from_ctx(sun, &ctx);
+    out->fajr[i] = t.fajr;
+    out->sunrise[i] = t.sunrise;
+    out->dhuha[i] = t.dhuha;
+    out->dhuhr[i] = t.dhuhr;
+    out->asr[i] = t.asr;
+    out->maghrib[i] = t.maghrib;
+    out->isha[i] = t.isha;
+  }
+}
+
+void prayer_times_soa_isa(PrayerSimdIsa isa, const SunState *sun, const MethodParams *params,
+                          size_t n, const double *lat, const double *lon, const double *tz,
+                          const PrayerTimesSoA *out) {
+  if (!sun || !params || !lat || !lon || !tz || !out || n == 0)
+    return;
+
+  /* Method constants (altitude sines) are exact libm values shared by all lanes */
+  PrayerLocationCtx method;
+  prayer_location_ctx_init(&method, 0.0, 0.0, 0.0, params);
+
+  if (isa > prayer_simd_detect())
+    isa = PRAYER_SIMD_SCALAR;
+
+  switch (isa) {
+#ifdef PT_SOA_HAVE_AVX2
+  case PRAYER_SIMD_AVX2:
+    pt_soa_avx2_run(sun, &method, n, lat, lon, tz, out);
+    return;
+#endif
+#ifdef PT_SOA_X86
+  case PRAYER_SIMD_SSE2:
+    pt_soa_sse2_run(sun, &method, n, lat, lon, tz, out);
+    return;
+#endif
+  default:
+    run_scalar(&method, sun, n, lat, lon, tz, out);
+    return;
+  }
+}
+
+void prayer_times_soa(const SunState *sun, const MethodParams *params, size_t n,
+                      const double *lat, const double *lon, const double *tz,
+                      const PrayerTimesSoA *out) {
+  prayer_times_soa_isa(prayer_simd_detect(), sun, params, n, lat, lon, tz, out);
+}
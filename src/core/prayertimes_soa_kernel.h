@@ -0,0 +1,191 @@
+/* Vector prayer-time kernel, instantiated once per instruction set by
+ * prayertimes_soa.c. The includer defines:
+ *
+ *   V, V_WIDTH                       vector type and lane count
+ *   V_SET1 V_LOAD V_STORE            broadcast / unaligned load / store
+ *   V_ADD V_SUB V_MUL V_DIV V_SQRT   arithmetic
+ *   V_AND V_OR V_XOR V_ANDNOT        bitwise (V_ANDNOT(a, b) = ~a & b)
+ *   V_LT V_GT V_EQ                   comparisons yielding all-ones lane masks
+ *   PT_SOA_TARGET                    function attribute enabling the ISA
+ *   PT_SOA_FN(name)                  per-ISA name mangling
+ *
+ * Math follows prayer_times_generic() in prayertimes.h lane for lane; only
+ * sin/cos/tan/acos are replaced by the polynomials below. */
+
+#define PT_VFN static inline PT_SOA_TARGET
+
+/* Cody-Waite split of pi/2 (fdlibm pio2_1 / pio2_1t) */
+#define PT_PIO2_HI 1.57079632673412561417e+00
+#define PT_PIO2_LO 6.07710050650619224932e-11
+
+PT_VFN V PT_SOA_FN(blend)(V mask, V a, V b) {
+  return V_OR(V_AND(mask, b), V_ANDNOT(mask, a));
+}
+
+/* Round to nearest integer; valid for |x| < 2^51 */
+PT_VFN V PT_SOA_FN(round)(V x) {
+  const V magic = V_SET1(6755399441055744.0);
+  return V_SUB(V_ADD(x, magic), magic);
+}
+
+/* sin and cos of x (radians, |x| < 1e6). Reduces to [-pi/4, pi/4] and uses
+ * the Cephes minimax polynomials, accurate to about 1 ulp on that interval. */
+PT_VFN void PT_SOA_FN(sincos)(V x, V *s_out, V *c_out) {
+  V n = PT_SOA_FN(round)(V_MUL(x, V_SET1(2.0 / M_PI)));
+  V r = V_SUB(V_SUB(x, V_MUL(n, V_SET1(PT_PIO2_HI))), V_MUL(n, V_SET1(PT_PIO2_LO)));
+  V z = V_MUL(r, r);
+
+  V sp = V_SET1(1.58962301576546568060e-10);
+  sp = V_ADD(V_MUL(sp, z), V_SET1(-2.50507477628578072866e-8));
+  sp = V_ADD(V_MUL(sp, z), V_SET1(2.75573136213857245213e-6));
+  sp = V_ADD(V_MUL(sp, z), V_SET1(-1.98412698295895385996e-4));
+  sp = V_ADD(V_MUL(sp, z), V_SET1(8.33333333332211858878e-3));
+  sp = V_ADD(V_MUL(sp, z), V_SET1(-1.66666666666666307295e-1));
+  V sr = V_ADD(r, V_MUL(V_MUL(r, z), sp));
+
+  V cp = V_SET1(-1.13585365213876817300e-11);
+  cp = V_ADD(V_MUL(cp, z), V_SET1(2.08757008419747316778e-9));
+  cp = V_ADD(V_MUL(cp, z), V_SET1(-2.75573141792967388112e-7));
+  cp = V_ADD(V_MUL(cp, z), V_SET1(2.48015872888517045348e-5));
+  cp = V_ADD(V_MUL(cp, z), V_SET1(-1.38888888888730564116e-3));
+  cp = V_ADD(V_MUL(cp, z), V_SET1(4.16666666666665929218e-2));
+  V cr = V_ADD(V_SUB(V_SET1(1.0), V_MUL(V_SET1(0.5), z)), V_MUL(V_MUL(z, z), cp));
+
+  /* Quadrant q = n mod 4; for integer n, floor(n / 4) = round((n - 1.5) / 4) */
+  V q = V_SUB(n, V_MUL(V_SET1(4.0), PT_SOA_FN(round)(V_MUL(V_SUB(n, V_SET1(1.5)), V_SET1(0.25)))));
+  V q1 = V_EQ(q, V_SET1(1.0));
+  V q2 = V_EQ(q, V_SET1(2.0));
+  V q3 = V_EQ(q, V_SET1(3.0));
+  V odd = V_OR(q1, q3);
+  V sign = V_SET1(-0.0);
+
+  V s = PT_SOA_FN(blend)(odd, sr, cr);
+  V c = PT_SOA_FN(blend)(odd, cr, sr);
+  *s_out = V_XOR(s, V_AND(V_OR(q2, q3), sign));
+  *c_out = V_XOR(c, V_AND(V_OR(q1, q2), sign));
+}
+
+/* acos(x) for |x| <= 1 via Abramowitz & Stegun 4.4.46:
+ * acos(|x|) = sqrt(1 - |x|) * P(|x|), |error| <= 2e-8 rad (0.3 ms of time).
+ * Lanes with |x| > 1 yield NaN, like libm. */
+PT_VFN V PT_SOA_FN(acos)(V x) {
+  V ax = V_ANDNOT(V_SET1(-0.0), x);
+  V p = V_SET1(-0.0012624911);
+  p = V_ADD(V_MUL(p, ax), V_SET1(0.0066700901));
+  p = V_ADD(V_MUL(p, ax), V_SET1(-0.0170881256));
+  p = V_ADD(V_MUL(p, ax), V_SET1(0.0308918810));
+  p = V_ADD(V_MUL(p, ax), V_SET1(-0.0501743046));
+  p = V_ADD(V_MUL(p, ax), V_SET1(0.0889789874));
+  p = V_ADD(V_MUL(p, ax), V_SET1(-0.2145988016));
+  p = V_ADD(V_MUL(p, ax), V_SET1(1.5707963050));
+  V r = V_MUL(V_SQRT(V_SUB(V_SET1(1.0), ax)), p);
+  return PT_SOA_FN(blend)(V_LT(x, V_SET1(0.0)), r, V_SUB(V_SET1(M_PI), r));
+}
+
+/* One block of V_WIDTH locations starting at index i */
+PT_VFN void PT_SOA_FN(block)(const SunState *sun, const PrayerLocationCtx *m, const double *lat,
+                             const double *lon, const double *tz, size_t i,
+                             const PrayerTimesSoA *out) {
+  const MethodParams *params = &m->params;
+  const V one = V_SET1(1.0);
+  const V ha_scale = V_SET1(RAD_TO_DEG / 15.0);
+
+  V vlat = V_LOAD(lat + i);
+  V sin_lat, cos_lat;
+  PT_SOA_FN(sincos)(V_MUL(vlat, V_SET1(DEG_TO_RAD)), &sin_lat, &cos_lat);
+
+  V noon = V_SUB(V_SUB(V_ADD(V_SET1(12.0), V_LOAD(tz + i)), V_DIV(V_LOAD(lon + i), V_SET1(15.0))),
+                 V_SET1(sun->equation_of_time));
+  V base = V_MUL(sin_lat, V_SET1(sun->sin_decl));
+  V denom = V_MUL(cos_lat, V_SET1(sun->cos_decl));
+
+  /* Sunrise & sunset */
+  V ha_sunrise =
+      V_MUL(PT_SOA_FN(acos)(V_DIV(V_SUB(V_SET1(m->sin_alt_sunrise), base), denom)), ha_scale);
+  V sunrise = V_SUB(noon, ha_sunrise);
+  V sunset = V_ADD(noon, ha_sunrise);
+  V night = V_ADD(V_SUB(V_SET1(24.0), sunset), sunrise);
+
+  /* Fajr, with the angle-based fallback where the sun never gets that low */
+  V cos_fajr = V_DIV(V_SUB(V_SET1(m->sin_alt_fajr), base), denom);
+  V fajr_failed = V_OR(V_LT(cos_fajr, V_SET1(-1.0)), V_GT(cos_fajr, one));
+  V fajr = V_SUB(noon, V_MUL(PT_SOA_FN(acos)(cos_fajr), ha_scale));
+  V fajr_fallback = V_SUB(sunrise, V_MUL(V_SET1(params->fajr_angle / 60.0), night));
+  fajr = PT_SOA_FN(blend)(fajr_failed, fajr, fajr_fallback);
+
+  /* Maghrib */
+  V maghrib = sunset;
+  if (params->maghrib_interval > 0)
+    maghrib = V_ADD(sunset, V_SET1((double)params->maghrib_interval / 60.0));
+
+  /* Isha */
+  V isha;
+  if (params->isha_angle > 0.0) {
+    V cos_isha = V_DIV(V_SUB(V_SET1(m->sin_alt_isha), base), denom);
+    V isha_failed = V_OR(V_LT(cos_isha, V_SET1(-1.0)), V_GT(cos_isha, one));
+    isha = V_ADD(noon, V_MUL(PT_SOA_FN(acos)(cos_isha), ha_scale));
+    V isha_fallback = V_ADD(sunset, V_MUL(V_SET1(params->isha_angle / 60.0), night));
+    isha = PT_SOA_FN(blend)(isha_failed, isha, isha_fallback);
+  } else {
+    isha = V_ADD(maghrib, V_SET1((double)params->isha_interval / 60.0));
+  }
+
+  /* Asr: cot(h) = shadow + tan|lat - decl|, sin(h) = 1 / sqrt(1 + cot^2) */
+  V zenith = V_ANDNOT(V_SET1(-0.0), V_SUB(vlat, V_SET1(sun->declination)));
+  V sz, cz;
+  PT_SOA_FN(sincos)(V_MUL(zenith, V_SET1(DEG_TO_RAD)), &sz, &cz);
+  V cot_asr = V_ADD(V_SET1((double)params->asr_shadow), V_DIV(sz, cz));
+  V sin_asr = V_DIV(one, V_SQRT(V_ADD(one, V_MUL(cot_asr, cot_asr))));
+  V asr = V_ADD(noon, V_MUL(PT_SOA_FN(acos)(V_DIV(V_SUB(sin_asr, base), denom)), ha_scale));
+
+  /* Dhuha */
+  V dhuha = V_SUB(
+      noon,
+      V_MUL(PT_SOA_FN(acos)(V_DIV(V_SUB(V_SET1(m->sin_alt_dhuha), base), denom)), ha_scale));
+
+  /* Ihtiyat (sunrise inverted, none for dhuha) */
+  V iht = V_SET1((double)params->ihtiyat / 60.0);
+  V_STORE(out->fajr + i, V_ADD(fajr, iht));
+  V_STORE(out->sunrise + i, V_SUB(sunrise, iht));
+  V_STORE(out->dhuha + i, dhuha);
+  V_STORE(out->dhuhr + i, V_ADD(noon, iht));
+  V_STORE(out->asr + i, V_ADD(asr, iht));
+  V_STORE(out->maghrib + i, V_ADD(maghrib, iht));
+  V_STORE(out->isha + i, V_ADD(isha, iht));
+}
+
+PT_SOA_TARGET static void PT_SOA_FN(run)(const SunState *sun, const PrayerLocationCtx *m,
+                                         size_t n, const double *lat, const double *lon,
+                                         const double *tz, const PrayerTimesSoA *out) {
+  size_t i = 0;
+  for (; i + V_WIDTH <= n; i += V_WIDTH)
+    PT_SOA_FN(block)(sun, m, lat, lon, tz, i, out);
+
+  size_t rem = n - i;
+  if (rem == 0)
+    return;
+
+  /* Pad the tail to a full vector so it takes the same code path */
+  double t_lat[V_WIDTH] = {0}, t_lon[V_WIDTH] = {0}, t_tz[V_WIDTH] = {0};
+  double t_out[7][V_WIDTH];
+  for (size_t k = 0; k < rem; k++) {
+    t_lat[k] = lat[i + k];
+    t_lon[k] = lon[i + k];
+    t_tz[k] = tz[i + k];
+  }
+  PrayerTimesSoA tail = {t_out[0], t_out[1], t_out[2], t_out[3], t_out[4], t_out[5], t_out[6]};
+  PT_SOA_FN(block)(sun, m, t_lat, t_lon, t_tz, 0, &tail);
+  for (size_t k = 0; k < rem; k++) {
+    out->fajr[i + k] = t_out[0][k];
+    out->sunrise[i + k] = t_out[1][k];
+    out->dhuha[i + k] = t_out[2][k];
+    out->dhuhr[i + k] = t_out[3][k];
+    out->asr[i + k] = t_out[4][k];
+    out->maghrib[i + k] = t_out[5][k];
+    out->isha[i + k] = t_out[6][k];
+  }
+}
+
+#undef PT_VFN
+#undef PT_PIO2_HI
+#undef PT_PIO2_LO
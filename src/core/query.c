@@ -0,0 +1,361 @@
+#define _GNU_SOURCE
+
+#include "query.h"
+
+#include "cache.h"
+#include "config.h"
+#include "prayer_checker.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+int query_socket_path(char *buf, size_t size) {
+  const char *dir = getenv("XDG_RUNTIME_DIR");
+  if (!dir || dir[0] != '/')
+    return -1;
+
+  int n = snprintf(buf, size, "%s/%s", dir, QUERY_SOCKET_NAME);
+  if (n < 0 || (size_t)n >= size || (size_t)n >= sizeof(((struct sockaddr_un *)0)->sun_path))
+    return -1;
+  return 0;
+}
+
+static int socket_address(const char *path, struct sockaddr_un *addr) {
+  memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(addr->sun_path))
+    return -1;
+  strcpy(addr->sun_path, path);
+  return 0;
+}
+
+static void set_timeouts(int fd, int timeout_ms) {
+  struct timeval tv = {.tv_sec = timeout_ms / 1000, .tv_usec = (timeout_ms % 1000) * 1000};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+/* A socket file nobody accepts on was left by a daemon that died. */
+static bool socket_is_stale(const struct sockaddr_un *addr) {
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    return false;
+  bool stale = connect(fd, (const struct sockaddr *)addr, sizeof(*addr)) != 0 &&
+               errno == ECONNREFUSED;
+  close(fd);
+  return stale;
+}
+
+int query_listen(const char *path) {
+  struct sockaddr_un addr;
+  if (socket_address(path, &addr) != 0)
+    return -1;
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    return -1;
+
+  int rc = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+  if (rc != 0 && errno == EADDRINUSE) {
+    if (!socket_is_stale(&addr)) {
+      close(fd);
+      errno = EADDRINUSE;
+      return -1;
+    }
+    unlink(path);
+    rc = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+  }
+  if (rc != 0 || chmod(path, 0600) != 0 || listen(fd, 16) != 0) {
+    int saved = errno;
+    if (rc == 0)
+      unlink(path);
+    close(fd);
+    errno = saved;
+    return -1;
+  }
+  return fd;
+}
+
+int query_accept(int listen_fd) {
+  return accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+}
+
+// -- answers -----------------------------------------------------------------
+
+typedef struct {
+  char *buf;
+  size_t size;
+  size_t len;
+  bool overflow;
+} Reply;
+
+static void reply_printf(Reply *r, const char *fmt, ...) {
+  if (r->overflow)
+    return;
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(r->buf + r->len, r->size - r->len, fmt, ap);
+  va_end(ap);
+  if (n < 0 || (size_t)n >= r->size - r->len) {
+    r->overflow = true;
+    return;
+  }
+  r->len += (size_t)n;
+}
+
+static void reply_day(Reply *r, const Config *cfg, const struct tm *day) {
+  double times[PRAYER_NONE];
+  cache_day_times(cfg, day, times);
+  reply_printf(r, "day %04d-%02d-%02d", day->tm_year + 1900, day->tm_mon + 1, day->tm_mday);
+  for (int i = 0; i < PRAYER_NONE; i++)
+    reply_printf(r, " %.17g", times[i]);
+  reply_printf(r, "\n");
+}
+
+static void reply_enabled(Reply *r, const SchedulePlan *plan) {
+  reply_printf(r, "enabled %u\n", plan->enabled);
+}
+
+static void answer_next(Reply *r, const Config *cfg, const struct tm *now) {
+  SchedulePlan plan;
+  schedule_plan_build(&plan, cfg);
+  double times[PRAYER_NONE];
+  cache_day_times(cfg, now, times);
+
+  int minutes_until = 0;
+  PrayerType next = prayer_plan_next(&plan, times, now, &minutes_until);
+  if (next == PRAYER_NONE)
+    reply_printf(r, "none\n");
+  else
+    reply_printf(r, "next %d %.17g %d\n", (int)next, times[next], minutes_until);
+}
+
+static void answer_range(Reply *r, const Config *cfg, const char *args, const struct tm *now) {
+  struct tm day = *now;
+  int days = 1;
+  if (args) {
+    int y, m, d;
+    char extra;
+    if (sscanf(args, "%d-%d-%d %d %c", &y, &m, &d, &days, &extra) != 4 || m < 1 || m > 12 ||
+        d < 1 || d > 31 || days < 1 || days > QUERY_RANGE_MAX) {
+      reply_printf(r, "error usage: range <YYYY-MM-DD> <1-%d>\n", QUERY_RANGE_MAX);
+      return;
+    }
+    memset(&day, 0, sizeof(day));
+    day.tm_year = y - 1900;
+    day.tm_mon = m - 1;
+    day.tm_mday = d;
+  }
+
+  SchedulePlan plan;
+  schedule_plan_build(&plan, cfg);
+  reply_enabled(r, &plan);
+  for (int i = 0; i < days; i++) {
+    // Noon keeps mktime's normalization clear of DST transitions
+    struct tm t = day;
+    t.tm_mday += i;
+    t.tm_hour = 12;
+    t.tm_min = 0;
+    t.tm_sec = 0;
+    t.tm_isdst = -1;
+    mktime(&t);
+    reply_day(r, cfg, &t);
+  }
+}
+
+static void reply_latency(Reply *r, const char *name, const LatencyHistogram *h) {
+  reply_printf(r, "latency %s %llu %llu %llu %llu\n", name, (unsigned long long)h->count,
+               (unsigned long long)(latency_percentile_ns(h, 0.50) / 1000),
+               (unsigned long long)(latency_percentile_ns(h, 0.99) / 1000),
+               (unsigned long long)(h->max_ns / 1000));
+}
+
+static void answer_stats(Reply *r, const QueryContext *ctx, time_t now) {
+  const DaemonState *st = ctx->state;
+  reply_printf(r, "uptime %lld\n", (long long)(now - ctx->started));
+  reply_printf(r, "wakeups_today %u\n", ctx->wakeups_today);
+  reply_printf(r, "queries %llu\n", ctx->queries);
+  reply_printf(r, "pending_triggers %d\n", st->cache.trigger_count - st->cache.head);
+  reply_printf(r, "window %s %d\n", st->cache.date[0] ? st->cache.date : "-", st->cache.days);
+  if (ctx->reactor) {
+    for (int i = 0; i < ctx->reactor->count; i++) {
+      const ReactorSource *s = &ctx->reactor->sources[i];
+      // A client's source lives for one request and never records its own
+      if (s->fd >= 0 && strcmp(s->name, QUERY_CLIENT_SOURCE) != 0)
+        reply_latency(r, s->name, &s->latency);
+    }
+  }
+  if (ctx->clients)
+    reply_latency(r, QUERY_CLIENT_SOURCE, ctx->clients);
+}
+
+int query_answer(const QueryContext *ctx, const char *request, time_t now, char *out,
+                 size_t size) {
+  if (size == 0)
+    return -1;
+  Reply r = {out, size, 0, false};
+  out[0] = '\0';
+  reply_printf(&r, "config %s\n", config_get_path());
+
+  const DaemonState *st = ctx->state;
+  struct tm tm_now;
+  localtime_r(&now, &tm_now);
+
+  const char *args = strchr(request, ' ');
+  size_t verb = args ? (size_t)(args - request) : strlen(request);
+  if (args)
+    args++;
+
+  if (verb == 5 && strncmp(request, "stats", verb) == 0) {
+    answer_stats(&r, ctx, now);
+  } else if (!st->config_loaded) {
+    reply_printf(&r, "error config not loaded\n");
+  } else if (verb == 4 && strncmp(request, "next", verb) == 0 && !args) {
+    answer_next(&r, &st->cfg, &tm_now);
+  } else if (verb == 5 && strncmp(request, "today", verb) == 0 && !args) {
+    answer_range(&r, &st->cfg, NULL, &tm_now);
+  } else if (verb == 5 && strncmp(request, "range", verb) == 0) {
+    answer_range(&r, &st->cfg, args ? args : "", &tm_now);
+  } else {
+    reply_printf(&r, "error unknown request\n");
+  }
+
+  return r.overflow ? -1 : (int)r.len;
+}
+
+// -- transport ---------------------------------------------------------------
+
+static long long monotonic_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Wait for events on fd until deadline (monotonic_ms()). A per-call socket
+ * timeout alone would let a peer trickling one byte at a time stretch an
+ * exchange to QUERY_REQUEST_MAX timeouts.
+ * Returns: 0 when ready, -1 on timeout or error */
+static int wait_ready(int fd, short events, long long deadline) {
+  for (;;) {
+    long long left = deadline - monotonic_ms();
+    if (left <= 0)
+      break;
+    struct pollfd p = {.fd = fd, .events = events};
+    int n = poll(&p, 1, (int)left);
+    if (n > 0)
+      return 0;
+    if (n < 0 && errno != EINTR)
+      return -1;
+  }
+  errno = ETIMEDOUT;
+  return -1;
+}
+
+static int write_all(int fd, const char *buf, size_t len, long long deadline) {
+  while (len > 0) {
+    if (wait_ready(fd, POLLOUT, deadline) != 0)
+      return -1;
+    ssize_t n = send(fd, buf, len, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n < 0) {
+      if (errno == EINTR || errno == EAGAIN)
+        continue;
+      return -1;
+    }
+    buf += n;
+    len -= (size_t)n;
+  }
+  return 0;
+}
+
+/* Read up to size - 1 bytes, stopping at EOF or, if stop is non-zero, after
+ * the byte stop. Returns: bytes read, -1 on error or when deadline passes */
+static ssize_t read_until(int fd, char *buf, size_t size, char stop, long long deadline) {
+  size_t len = 0;
+  while (len < size - 1) {
+    if (wait_ready(fd, POLLIN, deadline) != 0)
+      return -1;
+    ssize_t n = recv(fd, buf + len, size - 1 - len, MSG_DONTWAIT);
+    if (n < 0) {
+      if (errno == EINTR || errno == EAGAIN)
+        continue;
+      return -1;
+    }
+    if (n == 0)
+      break;
+    len += (size_t)n;
+    if (stop && memchr(buf + len - n, stop, (size_t)n))
+      break;
+  }
+  buf[len] = '\0';
+  return (ssize_t)len;
+}
+
+int query_serve(int client_fd, const QueryContext *ctx, time_t now) {
+  long long deadline = monotonic_ms() + QUERY_TIMEOUT_MS;
+  char request[QUERY_REQUEST_MAX];
+  if (read_until(client_fd, request, sizeof(request), '\n', deadline) <= 0)
+    return -1;
+  request[strcspn(request, "\r\n")] = '\0';
+
+  static char reply[QUERY_REPLY_MAX];
+  int len = query_answer(ctx, request, now, reply, sizeof(reply));
+  if (len < 0)
+    len = snprintf(reply, sizeof(reply), "config %s\nerror reply too large\n", config_get_path());
+  return write_all(client_fd, reply, (size_t)len, deadline);
+}
+
+const char *query_reply_body(const char *reply) {
+  const char *nl = strchr(reply, '\n');
+  return nl ? nl + 1 : reply + strlen(reply);
+}
+
+int query_request_at(const char *path, const char *request, char *reply, size_t size,
+                     int timeout_ms) {
+  struct sockaddr_un addr;
+  if (size == 0 || socket_address(path, &addr) != 0)
+    return -1;
+
+  long long deadline = monotonic_ms() + timeout_ms;
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    return -1;
+  set_timeouts(fd, timeout_ms); // Bounds connect() to a daemon with a full backlog
+
+  char line[QUERY_REQUEST_MAX];
+  int n = snprintf(line, sizeof(line), "%s\n", request);
+  ssize_t got = -1;
+  if (n > 0 && (size_t)n < sizeof(line) &&
+      connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+      write_all(fd, line, (size_t)n, deadline) == 0)
+    got = read_until(fd, reply, size, 0, deadline);
+  close(fd);
+  if (got <= 0)
+    return -1;
+
+  // Only a complete reply (the daemon closes after the last line) computed
+  // from this user's config.json counts
+  const char *config = config_get_path();
+  size_t config_len = strlen(config);
+  const char *body = query_reply_body(reply);
+  if (reply[got - 1] != '\n' || strncmp(reply, "config ", 7) != 0 ||
+      (size_t)(body - reply) != 7 + config_len + 1 || strncmp(reply + 7, config, config_len) != 0 ||
+      strncmp(body, "error", 5) == 0)
+    return -1;
+  return 0;
+}
+
+int query_request(const char *request, char *reply, size_t size, int timeout_ms) {
+  char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+  if (query_socket_path(path, sizeof(path)) != 0)
+    return -1;
+  return query_request_at(path, request, reply, size, timeout_ms);
+}
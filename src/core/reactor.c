@@ -0,0 +1,141 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "reactor.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
+#define REACTOR_MAX_EVENTS 64
+
+void latency_record(LatencyHistogram *h, uint64_t ns) {
+  uint64_t us = ns / 1000;
+  int bucket = 0;
+  while (us > 0 && bucket < LATENCY_BUCKETS - 1) {
+    us >>= 1;
+    bucket++;
+  }
+  h->buckets[bucket]++;
+  h->count++;
+  h->total_ns += ns;
+  if (ns > h->max_ns)
+    h->max_ns = ns;
+}
+
+uint64_t latency_percentile_ns(const LatencyHistogram *h, double p) {
+  if (h->count == 0)
+    return 0;
+
+  uint64_t rank = (uint64_t)(p * (double)h->count);
+  if (rank >= h->count)
+    rank = h->count - 1;
+
+  uint64_t seen = 0;
+  for (int i = 0; i < LATENCY_BUCKETS; i++) {
+    seen += h->buckets[i];
+    if (seen > rank)
+      return i == LATENCY_BUCKETS - 1 ? h->max_ns : (1000ULL << i);
+  }
+  return h->max_ns;
+}
+
+static uint64_t monotonic_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int reactor_init(Reactor *r) {
+  memset(r, 0, sizeof(*r));
+  r->epfd = epoll_create1(EPOLL_CLOEXEC);
+  return r->epfd < 0 ? -1 : 0;
+}
+
+void reactor_free(Reactor *r) {
+  if (r->epfd >= 0)
+    close(r->epfd);
+  free(r->sources);
+  memset(r, 0, sizeof(*r));
+  r->epfd = -1;
+}
+
+int reactor_add(Reactor *r, int fd, const char *name, ReactorFn fn, void *user) {
+  if (fd < 0 || !fn)
+    return -1;
+
+  int index = -1;
+  for (int i = 0; i < r->count; i++) {
+    if (r->sources[i].fd < 0) {
+      index = i;
+      break;
+    }
+  }
+  if (index < 0) {
+    if (r->count == r->capacity) {
+      int capacity = r->capacity ? r->capacity * 2 : 8;
+      ReactorSource *grown = realloc(r->sources, (size_t)capacity * sizeof(*grown));
+      if (!grown)
+        return -1;
+      r->sources = grown;
+      r->capacity = capacity;
+    }
+    index = r->count++;
+  }
+
+  // Tag events with both slot and fd so a slot freed mid-batch is recognized
+  struct epoll_event ev = {.events = EPOLLIN,
+                           .data.u64 = ((uint64_t)(uint32_t)fd << 32) | (uint32_t)index};
+  if (epoll_ctl(r->epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+    if (index == r->count - 1)
+      r->count--;
+    return -1;
+  }
+
+  ReactorSource *s = &r->sources[index];
+  memset(s, 0, sizeof(*s));
+  s->fd = fd;
+  snprintf(s->name, sizeof(s->name), "%s", name ? name : "");
+  s->fn = fn;
+  s->user = user;
+  return index;
+}
+
+int reactor_remove(Reactor *r, int fd) {
+  for (int i = 0; i < r->count; i++) {
+    if (r->sources[i].fd == fd) {
+      epoll_ctl(r->epfd, EPOLL_CTL_DEL, fd, NULL);
+      r->sources[i].fd = -1;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+int reactor_poll(Reactor *r, int timeout_ms) {
+  struct epoll_event events[REACTOR_MAX_EVENTS];
+  int n = epoll_wait(r->epfd, events, REACTOR_MAX_EVENTS, timeout_ms);
+  if (n < 0)
+    return errno == EINTR ? 0 : -1;
+
+  uint64_t woke = monotonic_ns();
+  int handled = 0;
+  for (int i = 0; i < n; i++) {
+    int index = (int)(uint32_t)events[i].data.u64;
+    int fd = (int)(events[i].data.u64 >> 32);
+    if (index >= r->count || r->sources[index].fd != fd)
+      continue; // Removed by an earlier handler in this batch
+
+    ReactorSource s = r->sources[index];
+    s.fn(r, fd, events[i].events, s.user);
+    handled++;
+
+    // The handler may have grown (moved) the table or removed itself
+    if (r->sources[index].fd == fd)
+      latency_record(&r->sources[index].latency, monotonic_ns() - woke);
+  }
+  return handled;
+}
@@ -0,0 +1,208 @@
+#define _GNU_SOURCE
+
+#include "snapshot.h"
+
+#include "cache.h"
+#include "config.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int snapshot_path(char *buf, size_t size) {
+  const char *dir = getenv("XDG_RUNTIME_DIR");
+  if (!dir || dir[0] != '/')
+    return -1;
+
+  int n = snprintf(buf, size, "%s/%s", dir, SNAPSHOT_FILE_NAME);
+  return n < 0 || (size_t)n >= size ? -1 : 0;
+}
+
+uint64_t snapshot_config_key(const char *config_path) {
+  // FNV-1a
+  uint64_t h = 1469598103934665603ULL;
+  for (const unsigned char *p = (const unsigned char *)config_path; *p; p++) {
+    h ^= *p;
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+static void publish(SnapshotRegion *region, const SnapshotData *data, uint64_t generation);
+
+/* Publish an empty schedule into a region left by a daemon that died, so a
+ * reader still mapping it stops trusting it and maps the new file. */
+static void retire_region(const char *path) {
+  int fd = open(path, O_RDWR | O_CLOEXEC);
+  if (fd < 0)
+    return;
+  struct stat sb;
+  void *map = MAP_FAILED;
+  if (fstat(fd, &sb) == 0 && sb.st_size == (off_t)sizeof(SnapshotRegion))
+    map = mmap(NULL, sizeof(SnapshotRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return;
+
+  SnapshotRegion *region = map;
+  if (region->magic == SNAPSHOT_MAGIC && region->version == SNAPSHOT_VERSION &&
+      region->size == sizeof(SnapshotRegion)) {
+    SnapshotData empty;
+    memset(&empty, 0, sizeof(empty));
+    publish(region, &empty, 0);
+  }
+  munmap(map, sizeof(SnapshotRegion));
+}
+
+int snapshot_writer_open(SnapshotWriter *w, const char *path) {
+  memset(w, 0, sizeof(*w));
+  char tmp_path[PLATFORM_PATH_MAX + 4];
+  int n = snprintf(w->path, sizeof(w->path), "%s", path);
+  if (n < 0 || (size_t)n >= sizeof(w->path))
+    return -1;
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+  int fd = open(tmp_path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (fd < 0)
+    return -1;
+  void *map = MAP_FAILED;
+  if (ftruncate(fd, sizeof(SnapshotRegion)) == 0)
+    map = mmap(NULL, sizeof(SnapshotRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    unlink(tmp_path);
+    return -1;
+  }
+
+  // The file is zero-filled: an even seq and generation 0, i.e. no schedule yet
+  SnapshotRegion *region = map;
+  region->magic = SNAPSHOT_MAGIC;
+  region->version = SNAPSHOT_VERSION;
+  region->size = sizeof(SnapshotRegion);
+  retire_region(path);
+  if (rename(tmp_path, path) != 0) {
+    munmap(map, sizeof(SnapshotRegion));
+    unlink(tmp_path);
+    return -1;
+  }
+  w->region = region;
+  return 0;
+}
+
+/* Only the daemon writes, so the counter needs no read-modify-write. The
+ * release fence orders the odd store before the data stores; the final
+ * release store orders the data before the even one. */
+static void publish(SnapshotRegion *region, const SnapshotData *data, uint64_t generation) {
+  uint32_t seq = region->seq;
+  __atomic_store_n(&region->seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  region->data = *data;
+  region->data.generation = generation;
+  __atomic_store_n(&region->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+void snapshot_publish(SnapshotWriter *w, const SnapshotData *data) {
+  if (w->region)
+    publish(w->region, data, w->region->data.generation + 1);
+}
+
+void snapshot_writer_close(SnapshotWriter *w) {
+  if (!w->region)
+    return;
+  SnapshotData empty;
+  memset(&empty, 0, sizeof(empty));
+  publish(w->region, &empty, 0);
+  munmap(w->region, sizeof(SnapshotRegion));
+  unlink(w->path);
+  memset(w, 0, sizeof(*w));
+}
+
+int snapshot_fill(SnapshotData *data, const DaemonState *st, time_t now) {
+  memset(data, 0, sizeof(*data));
+  if (!st->config_loaded)
+    return -1;
+
+  struct tm tm_now;
+  platform_localtime(&now, &tm_now);
+  data->config_key = snapshot_config_key(config_get_path());
+  data->config_stamp = st->config_stamp;
+  data->date = (tm_now.tm_year + 1900) * 10000 + (tm_now.tm_mon + 1) * 100 + tm_now.tm_mday;
+
+  SchedulePlan plan;
+  schedule_plan_build(&plan, &st->cfg);
+  data->enabled = plan.enabled;
+  cache_day_times(&st->cfg, &tm_now, data->times);
+
+  int next = cache_first_due_after(&st->cache, now);
+  if (next < st->cache.trigger_count) {
+    const CacheTrigger *t = &st->cache.triggers[next];
+    data->next_due = (int64_t)t->due;
+    data->next_prayer_time = t->prayer_time;
+    data->next_minutes_before = t->minutes_before;
+    memcpy(data->next_prayer, t->prayer, sizeof(data->next_prayer));
+  }
+  return 0;
+}
+
+const SnapshotRegion *snapshot_map(const char *path) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return NULL;
+  struct stat sb;
+  void *map = MAP_FAILED;
+  if (fstat(fd, &sb) == 0 && sb.st_size == (off_t)sizeof(SnapshotRegion))
+    map = mmap(NULL, sizeof(SnapshotRegion), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return NULL;
+
+  const SnapshotRegion *region = map;
+  if (region->magic != SNAPSHOT_MAGIC || region->version != SNAPSHOT_VERSION ||
+      region->size != sizeof(SnapshotRegion)) {
+    munmap(map, sizeof(SnapshotRegion));
+    return NULL;
+  }
+  return region;
+}
+
+void snapshot_unmap(const SnapshotRegion *region) {
+  if (region)
+    munmap((void *)region, sizeof(SnapshotRegion));
+}
+
+int snapshot_read(const SnapshotRegion *region, SnapshotData *out) {
+  for (int i = 0; i < SNAPSHOT_READ_RETRIES; i++) {
+    uint32_t seq = __atomic_load_n(&region->seq, __ATOMIC_ACQUIRE);
+    if (seq & 1)
+      continue; // Writer mid-update
+    memcpy(out, (const void *)&region->data, sizeof(*out));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&region->seq, __ATOMIC_RELAXED) == seq)
+      return out->generation != 0 ? 0 : -1;
+  }
+  return -1;
+}
+
+bool snapshot_is_current(const SnapshotData *data, const struct tm *now,
+                         const char *config_path) {
+  int date = (now->tm_year + 1900) * 10000 + (now->tm_mon + 1) * 100 + now->tm_mday;
+  return data->date == date && data->config_key == snapshot_config_key(config_path);
+}
+
+bool snapshot_config_unchanged(const SnapshotData *data, const char *config_path) {
+  PlatformFileStamp stamp;
+  return platform_file_stamp(config_path, &stamp) == 0 &&
+         stamp.mtime_ns == data->config_stamp.mtime_ns && stamp.size == data->config_stamp.size;
+}
+
+PrayerType snapshot_next_prayer(const SnapshotData *data, const struct tm *now,
+                                int *minutes_until) {
+  SchedulePlan plan;
+  memset(&plan, 0, sizeof(plan));
+  plan.enabled = data->enabled;
+  return prayer_plan_next(&plan, data->times, now, minutes_until);
+}
@@ -0,0 +1,42 @@
+#include "sun_chebyshev.h"
+#include "prayertimes.h"
+#include "sun_chebyshev_table.h"
+
+// c[0] + c[1] T1(x) + ... by Clenshaw's recurrence
+static double clenshaw(const double *c, double x) {
+  double b1 = 0.0, b2 = 0.0, x2 = 2.0 * x;
+  for (int j = SUN_CHEBYSHEV_COEFFS - 1; j >= 1; j--) {
+    double t = x2 * b1 - b2 + c[j];
+    b2 = b1;
+    b1 = t;
+  }
+  return x * b1 - b2 + c[0];
+}
+
+int sun_chebyshev(double jd, double *declination, double *equation_of_time) {
+  double d = jd - SUN_CHEBYSHEV_FIRST_JD;
+  if (!(d >= 0.0 && d < SUN_CHEBYSHEV_DAYS))
+    return 0;
+
+  int seg = (int)(d * (1.0 / SUN_CHEBYSHEV_SEGMENT_DAYS));
+  double x = (d - (double)seg * SUN_CHEBYSHEV_SEGMENT_DAYS) * (2.0 / SUN_CHEBYSHEV_SEGMENT_DAYS) -
+             1.0;
+  *declination = clenshaw(sun_chebyshev_table[seg][0], x);
+  *equation_of_time = clenshaw(sun_chebyshev_table[seg][1], x);
+  return 1;
+}
+
+void sun_chebyshev_range(double *first_jd, double *last_jd) {
+  *first_jd = SUN_CHEBYSHEV_FIRST_JD;
+  *last_jd = SUN_CHEBYSHEV_FIRST_JD + SUN_CHEBYSHEV_DAYS;
+}
+
+static int chebyshev_source(double jd, double *declination, double *equation_of_time,
+                            void *user) {
+  (void)user;
+  return sun_chebyshev(jd, declination, equation_of_time);
+}
+
+void sun_chebyshev_install(void) {
+  prayer_set_sun_source(chebyshev_source, NULL);
+}
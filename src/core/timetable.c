@@ -0,0 +1,435 @@
+#include "timetable.h"
+#include "platform.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Chunks formatted between two writes to the output; bounds buffer memory to
+// roughly EXPORT_BATCH_CHUNKS * 31 rows
+#define EXPORT_BATCH_CHUNKS 4096
+
+// Every time is "HH:MM" or "--:--", see append_time()
+#define EXPORT_TIME_LEN 5
+#define EXPORT_DATE_LEN 10 // YYYY-MM-DD
+
+// Longest row: name, date and 7 times, each after a comma, then a newline
+#define EXPORT_ROW_MAX                                                                             \
+  ((TIMETABLE_NAME_MAX - 1) + 1 + EXPORT_DATE_LEN + 7 * (1 + EXPORT_TIME_LEN) + 1)
+
+// --- CSV input -----------------------
+
+static bool is_leap(int y) {
+  return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+static int days_in_month(int y, int m) {
+  static const int dim[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  return dim[m - 1] + (m == 2 && is_leap(y));
+}
+
+int timetable_parse_date(const char *str, TimetableDate *date) {
+  int y, m, d, end = 0;
+  if (!str || sscanf(str, "%4d-%2d-%2d%n", &y, &m, &d, &end) != 3 || str[end] != '\0')
+    return -1;
+  if (m < 1 || m > 12 || d < 1 || d > days_in_month(y, m))
+    return -1;
+  date->year = y;
+  date->month = m;
+  date->day = d;
+  return 0;
+}
+
+static void trim_right(char *s) {
+  size_t n = strlen(s);
+  while (n > 0 && (s[n - 1] == '\n' || s[n - 1] == '\r' || s[n - 1] == ' ' || s[n - 1] == '\t'))
+    s[--n] = '\0';
+}
+
+int timetable_load_locations(const char *path, TimetableLocation **locations, size_t *count) {
+  FILE *f = platform_file_open(path, "r");
+  if (!f) {
+    fprintf(stderr, "Error: cannot open %s\n", path);
+    return -1;
+  }
+
+  TimetableLocation *list = NULL;
+  size_t n = 0, cap = 0;
+  char line[512];
+  int line_no = 0;
+  int rc = 0;
+
+  while (fgets(line, sizeof(line), f)) {
+    line_no++;
+    trim_right(line);
+    if (line[0] == '\0' || line[0] == '#')
+      continue;
+
+    TimetableLocation loc;
+    memset(&loc, 0, sizeof(loc));
+    char method[32];
+    const char *comma = strchr(line, ',');
+    size_t name_len = comma ? (size_t)(comma - line) : 0;
+    if (!comma || name_len == 0 || name_len >= sizeof(loc.name) ||
+        sscanf(comma + 1, "%lf,%lf,%lf,%31s", &loc.latitude, &loc.longitude, &loc.timezone,
+               method) != 4) {
+      fprintf(stderr, "Error: %s:%d: expected name,lat,lon,tz,method\n", path, line_no);
+      rc = -1;
+      break;
+    }
+    memcpy(loc.name, line, name_len);
+
+    loc.method = method_from_string(method);
+    if (loc.method == CALC_CUSTOM) {
+      fprintf(stderr, "Error: %s:%d: unknown method '%s'\n", path, line_no, method);
+      rc = -1;
+      break;
+    }
+    if (fabs(loc.latitude) > 90.0 || fabs(loc.longitude) > 180.0 || fabs(loc.timezone) > 14.0) {
+      fprintf(stderr, "Error: %s:%d: coordinates or timezone out of range\n", path, line_no);
+      rc = -1;
+      break;
+    }
+
+    if (n == cap) {
+      size_t new_cap = cap ? cap * 2 : 64;
+      TimetableLocation *grown = realloc(list, new_cap * sizeof(*list));
+      if (!grown) {
+        fprintf(stderr, "Error: out of memory\n");
+        rc = -1;
+        break;
+      }
+      list = grown;
+      cap = new_cap;
+    }
+    list[n++] = loc;
+  }
+  fclose(f);
+
+  if (rc != 0) {
+    free(list);
+    return -1;
+  }
+  *locations = list;
+  *count = n;
+  return 0;
+}
+
+// --- work-stealing chunk ranges -----------------------
+//
+// Each thread owns a contiguous range of chunk indices packed as lo << 32 | hi.
+// The owner takes from lo; an idle thread steals the upper half of a victim's
+// range and makes it its own. Both sides claim with a compare-and-swap, and
+// a given (lo, hi) state never recurs, so there is no ABA.
+
+static uint64_t range_pack(uint32_t lo, uint32_t hi) {
+  return (uint64_t)lo << 32 | hi;
+}
+
+#ifdef _MSC_VER
+static uint64_t range_load(volatile uint64_t *r) {
+  return (uint64_t)_InterlockedOr64((volatile long long *)r, 0);
+}
+
+static bool range_cas(volatile uint64_t *r, uint64_t expected, uint64_t desired) {
+  return (uint64_t)_InterlockedCompareExchange64((volatile long long *)r, (long long)desired,
+                                                 (long long)expected) == expected;
+}
+
+static void range_store(volatile uint64_t *r, uint64_t v) {
+  _InterlockedExchange64((volatile long long *)r, (long long)v);
+}
+#else
+static uint64_t range_load(volatile uint64_t *r) {
+  return __atomic_load_n(r, __ATOMIC_ACQUIRE);
+}
+
+static bool range_cas(volatile uint64_t *r, uint64_t expected, uint64_t desired) {
+  return __atomic_compare_exchange_n(r, &expected, desired, false, __ATOMIC_ACQ_REL,
+                                     __ATOMIC_ACQUIRE);
+}
+
+static void range_store(volatile uint64_t *r, uint64_t v) {
+  __atomic_store_n(r, v, __ATOMIC_RELEASE);
+}
+#endif
+
+static long long range_take_own(volatile uint64_t *r) {
+  for (;;) {
+    uint64_t s = range_load(r);
+    uint32_t lo = (uint32_t)(s >> 32), hi = (uint32_t)s;
+    if (lo >= hi)
+      return -1;
+    if (range_cas(r, s, range_pack(lo + 1, hi)))
+      return lo;
+  }
+}
+
+static long long range_steal(volatile uint64_t *ranges, int nthreads, int self) {
+  for (int k = 1; k < nthreads; k++) {
+    volatile uint64_t *victim = &ranges[(self + k) % nthreads];
+    for (;;) {
+      uint64_t s = range_load(victim);
+      uint32_t lo = (uint32_t)(s >> 32), hi = (uint32_t)s;
+      if (lo >= hi)
+        break;
+      uint32_t mid = hi - (hi - lo + 1) / 2;
+      if (range_cas(victim, s, range_pack(lo, mid))) {
+        // Keep [mid + 1, hi) for later and run mid now
+        range_store(&ranges[self], range_pack(mid + 1, hi));
+        return mid;
+      }
+    }
+  }
+  return -1;
+}
+
+// --- export -----------------------
+
+typedef struct {
+  SunState sun;
+  char date[EXPORT_DATE_LEN]; // Not NUL-terminated
+} ExportDay;
+
+typedef struct {
+  char *data;
+  size_t len;
+  size_t cap;
+  bool failed;
+} ExportBuf;
+
+typedef struct {
+  const TimetableLocation *locations;
+  const ExportDay *days;
+  const int *month_first; // nmonths + 1 offsets into days
+  size_t nmonths;
+  size_t batch_first; // global index of chunk 0 of the batch
+  int nthreads;
+  volatile uint64_t *ranges;
+  ExportBuf *bufs;      // one per thread
+  int *chunk_thread;    // per chunk of the batch: buffer holding its rows
+  size_t *chunk_offset; // ... and their position in it
+  size_t *chunk_len;
+} ExportJob;
+
+static bool buf_reserve(ExportBuf *b, size_t extra) {
+  if (b->len + extra <= b->cap)
+    return true;
+  size_t cap = b->cap ? b->cap : 1 << 16;
+  while (cap < b->len + extra)
+    cap *= 2;
+  char *grown = realloc(b->data, cap);
+  if (!grown)
+    return false;
+  b->data = grown;
+  b->cap = cap;
+  return true;
+}
+
+static char *append_2d(char *p, int v) {
+  *p++ = (char)('0' + v / 10);
+  *p++ = (char)('0' + v % 10);
+  return p;
+}
+
+// Same text as format_time_hm(), which rounds up to the minute, for times in
+// [0, 24). Others wrap to the local clock time (a location whose timezone is
+// far from its longitude can have Fajr before midnight), so the field is
+// always EXPORT_TIME_LEN characters.
+static char *append_time(char *p, double t) {
+  if (!isfinite(t)) {
+    memcpy(p, "--:--", EXPORT_TIME_LEN);
+    return p + EXPORT_TIME_LEN;
+  }
+  t = fmod(t, 24.0);
+  if (t < 0.0)
+    t += 24.0;
+  int hours = (int)t;
+  int minutes = (int)ceil((t - hours) * 60.0);
+  if (minutes >= 60) {
+    hours += 1;
+    minutes -= 60;
+  }
+  hours %= 24;
+  p = append_2d(p, hours);
+  *p++ = ':';
+  return append_2d(p, minutes);
+}
+
+static void run_chunk(ExportJob *job, int self, size_t c) {
+  size_t global = job->batch_first + c;
+  const TimetableLocation *loc = &job->locations[global / job->nmonths];
+  size_t month = global % job->nmonths;
+  int first = job->month_first[month], last = job->month_first[month + 1];
+  ExportBuf *b = &job->bufs[self];
+
+  job->chunk_thread[c] = self;
+  job->chunk_offset[c] = b->len;
+  job->chunk_len[c] = 0;
+  if (b->failed || !buf_reserve(b, (size_t)(last - first) * EXPORT_ROW_MAX)) {
+    b->failed = true;
+    return;
+  }
+
+  PrayerLocationCtx ctx;
+  prayer_location_ctx_init(&ctx, loc->latitude, loc->longitude, loc->timezone,
+                           method_params_get(loc->method));
+  size_t name_len = strlen(loc->name);
+
+  char *p = b->data + b->len;
+  for (int d = first; d < last; d++) {
+    struct PrayerTimes t = prayer_times_from_ctx(&job->days[d].sun, &ctx);
+    const double v[7] = {t.fajr, t.sunrise, t.dhuha, t.dhuhr, t.asr, t.maghrib, t.isha};
+    memcpy(p, loc->name, name_len);
+    p += name_len;
+    *p++ = ',';
+    memcpy(p, job->days[d].date, EXPORT_DATE_LEN);
+    p += EXPORT_DATE_LEN;
+    for (int e = 0; e < 7; e++) {
+      *p++ = ',';
+      p = append_time(p, v[e]);
+    }
+    *p++ = '\n';
+  }
+  job->chunk_len[c] = (size_t)(p - (b->data + b->len));
+  b->len += job->chunk_len[c];
+}
+
+static void export_worker(void *arg, int self) {
+  ExportJob *job = arg;
+  for (;;) {
+    long long c = range_take_own(&job->ranges[self]);
+    if (c < 0)
+      c = range_steal(job->ranges, job->nthreads, self);
+    if (c < 0)
+      return;
+    run_chunk(job, self, (size_t)c);
+  }
+}
+
+// Days of [from, to] with their sun state, and the first day of each month
+static int build_days(TimetableDate from, TimetableDate to, ExportDay **days_out,
+                      int **month_first_out, size_t *nmonths_out) {
+  int ndays = (int)(julian_day_for_date(to.year, to.month, to.day) -
+                    julian_day_for_date(from.year, from.month, from.day)) +
+              1;
+  size_t nmonths = (size_t)((to.year - from.year) * 12 + (to.month - from.month) + 1);
+  ExportDay *days = malloc((size_t)ndays * sizeof(*days));
+  int *month_first = malloc((nmonths + 1) * sizeof(*month_first));
+  if (!days || !month_first) {
+    free(days);
+    free(month_first);
+    return -1;
+  }
+
+  int y = from.year, m = from.month, d = from.day;
+  size_t month = 0;
+  month_first[0] = 0;
+  for (int i = 0; i < ndays; i++) {
+    days[i].sun = sun_state_for_date(y, m, d);
+    char *p = append_2d(append_2d(days[i].date, y / 100), y % 100);
+    *p++ = '-';
+    p = append_2d(p, m);
+    *p++ = '-';
+    append_2d(p, d);
+    if (++d > days_in_month(y, m)) {
+      d = 1;
+      if (++m > 12) {
+        m = 1;
+        y++;
+      }
+      month_first[++month] = i + 1;
+    }
+  }
+  month_first[nmonths] = ndays;
+
+  *days_out = days;
+  *month_first_out = month_first;
+  *nmonths_out = nmonths;
+  return 0;
+}
+
+int timetable_check_range(TimetableDate from, TimetableDate to) {
+  if (from.year < 1 || from.year > 9999 || to.year < 1 || to.year > 9999 ||
+      (from.year * 10000 + from.month * 100 + from.day) >
+          (to.year * 10000 + to.month * 100 + to.day))
+    return -1;
+  return 0;
+}
+
+int timetable_export(FILE *out, const TimetableLocation *locations, size_t count,
+                     TimetableDate from, TimetableDate to, int nthreads) {
+  if (timetable_check_range(from, to) != 0)
+    return -1;
+  if (count == 0)
+    return 0;
+  if (nthreads <= 0)
+    nthreads = platform_cpu_count();
+
+  ExportJob job;
+  memset(&job, 0, sizeof(job));
+  ExportDay *days = NULL;
+  int *month_first = NULL;
+  if (build_days(from, to, &days, &month_first, &job.nmonths) != 0)
+    return -1;
+
+  size_t total = count * job.nmonths;
+  size_t batch_max = total < EXPORT_BATCH_CHUNKS ? total : EXPORT_BATCH_CHUNKS;
+  if ((size_t)nthreads > batch_max)
+    nthreads = (int)batch_max;
+
+  job.locations = locations;
+  job.days = days;
+  job.month_first = month_first;
+  job.nthreads = nthreads;
+  job.ranges = calloc((size_t)nthreads, sizeof(*job.ranges));
+  job.bufs = calloc((size_t)nthreads, sizeof(*job.bufs));
+  job.chunk_thread = malloc(batch_max * sizeof(*job.chunk_thread));
+  job.chunk_offset = malloc(batch_max * sizeof(*job.chunk_offset));
+  job.chunk_len = malloc(batch_max * sizeof(*job.chunk_len));
+
+  int rc = 0;
+  if (!job.ranges || !job.bufs || !job.chunk_thread || !job.chunk_offset || !job.chunk_len)
+    rc = -1;
+
+  for (size_t first = 0; rc == 0 && first < total; first += batch_max) {
+    size_t n = total - first < batch_max ? total - first : batch_max;
+    job.batch_first = first;
+    for (int t = 0; t < nthreads; t++) {
+      job.bufs[t].len = 0;
+      range_store(&job.ranges[t], range_pack((uint32_t)(n * (size_t)t / (size_t)nthreads),
+                                             (uint32_t)(n * (size_t)(t + 1) / (size_t)nthreads)));
+    }
+
+    platform_run_threads(nthreads, export_worker, &job);
+
+    for (int t = 0; t < nthreads; t++) {
+      if (job.bufs[t].failed)
+        rc = -1;
+    }
+    for (size_t c = 0; rc == 0 && c < n; c++) {
+      const ExportBuf *b = &job.bufs[job.chunk_thread[c]];
+      if (fwrite(b->data + job.chunk_offset[c], 1, job.chunk_len[c], out) != job.chunk_len[c])
+        rc = -1;
+    }
+  }
+
+  if (rc == 0 && fflush(out) != 0)
+    rc = -1;
+
+  for (int t = 0; job.bufs && t < nthreads; t++)
+    free(job.bufs[t].data);
+  free((void *)job.ranges);
+  free(job.bufs);
+  free(job.chunk_thread);
+  free(job.chunk_offset);
+  free(job.chunk_len);
+  free(days);
+  free(month_first);
+  return rc;
+}
@@ -1,4 +1,5 @@
 #include "cli.h"
+#include "ephemeris.h"
 #include <curl/curl.h>
 
 int main(int argc, char **argv) {
@@ -6,6 +7,7 @@ int main(int argc, char **argv) {
 
   int result = cli_run(argc, argv);
 
+  ephemeris_uninstall(); // Installed by commands that compute times
   curl_global_cleanup();
 
   return result;
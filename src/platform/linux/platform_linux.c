@@ -3,10 +3,14 @@
 
 #include "platform.h"
 #include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <pwd.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -131,6 +135,16 @@ int platform_file_exists(const char *path) {
   return access(path, F_OK) == 0 ? 1 : 0;
 }
 
+int platform_file_stamp(const char *path, PlatformFileStamp *stamp) {
+  struct stat st;
+  if (stat(path, &st) != 0)
+    return -1;
+
+  stamp->mtime_ns = (long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+  stamp->size = (long long)st.st_size;
+  return 0;
+}
+
 FILE *platform_file_open(const char *path, const char *mode) {
   return fopen(path, mode);
 }
@@ -143,10 +157,93 @@ int platform_atomic_rename(const char *src, const char *dst) {
   return rename(src, dst) == 0 ? 0 : -1;
 }
 
+const void *platform_map_file(const char *path, size_t *size) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return NULL;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return NULL;
+  }
+
+  void *addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED)
+    return NULL;
+
+  *size = (size_t)st.st_size;
+  return addr;
+}
+
+void platform_unmap_file(const void *addr, size_t size) {
+  if (addr)
+    munmap((void *)addr, size);
+}
+
+int platform_cpu_count(void) {
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (int)n : 1;
+}
+
+typedef struct {
+  PlatformThreadFn fn;
+  void *arg;
+  int index;
+} ThreadStart;
+
+static void *thread_entry(void *p) {
+  ThreadStart *start = p;
+  start->fn(start->arg, start->index);
+  return NULL;
+}
+
+void platform_run_threads(int nthreads, PlatformThreadFn fn, void *arg) {
+  if (nthreads <= 1) {
+    fn(arg, 0);
+    return;
+  }
+
+  pthread_t *threads = calloc((size_t)nthreads, sizeof(*threads));
+  ThreadStart *starts = calloc((size_t)nthreads, sizeof(*starts));
+  bool *started = calloc((size_t)nthreads, sizeof(*started));
+  if (!threads || !starts || !started) {
+    for (int i = 0; i < nthreads; i++)
+      fn(arg, i);
+  } else {
+    for (int i = 1; i < nthreads; i++) {
+      starts[i] = (ThreadStart){fn, arg, i};
+      started[i] = pthread_create(&threads[i], NULL, thread_entry, &starts[i]) == 0;
+    }
+    fn(arg, 0);
+    for (int i = 1; i < nthreads; i++) {
+      if (started[i])
+        pthread_join(threads[i], NULL);
+      else
+        fn(arg, i);
+    }
+  }
+  free(threads);
+  free(starts);
+  free(started);
+}
+
 void platform_localtime(const time_t *t, struct tm *result) {
   localtime_r(t, result);
 }
 
+void platform_sleep_until(time_t t) {
+  struct timespec deadline = {.tv_sec = t, .tv_nsec = 0};
+  while (time(NULL) < t) {
+    // time() reads a coarse clock that can trail CLOCK_REALTIME by a tick:
+    // once the deadline has passed, nap a millisecond at a time until it agrees
+    if (clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &deadline, NULL) == 0 &&
+        deadline.tv_nsec < 999000000)
+      deadline.tv_nsec += 1000000;
+  }
+}
+
 int platform_isatty(FILE *stream) {
   return isatty(fileno(stream));
 }
@@ -262,6 +262,26 @@ int platform_file_exists(const char *path) {
   return attrs != INVALID_FILE_ATTRIBUTES ? 1 : 0;
 }
 
+int platform_file_stamp(const char *path, PlatformFileStamp *stamp) {
+  wchar_t *wide_path = utf8_to_wide(path);
+  if (!wide_path)
+    return -1;
+
+  WIN32_FILE_ATTRIBUTE_DATA data;
+  BOOL ok = GetFileAttributesExW(wide_path, GetFileExInfoStandard, &data);
+  free(wide_path);
+  if (!ok)
+    return -1;
+
+  /* FILETIME counts 100 ns intervals */
+  ULARGE_INTEGER t;
+  t.LowPart = data.ftLastWriteTime.dwLowDateTime;
+  t.HighPart = data.ftLastWriteTime.dwHighDateTime;
+  stamp->mtime_ns = (long long)t.QuadPart * 100;
+  stamp->size = ((long long)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+  return 0;
+}
+
 FILE *platform_file_open(const char *path, const char *mode) {
   wchar_t *wide_path = utf8_to_wide(path);
   wchar_t *wide_mode = utf8_to_wide(mode);
@@ -302,10 +322,111 @@ int platform_atomic_rename(const char *src, const char *dst) {
   return result;
 }
 
+const void *platform_map_file(const char *path, size_t *size) {
+  wchar_t *wide_path = utf8_to_wide(path);
+  if (!wide_path)
+    return NULL;
+
+  HANDLE file = CreateFileW(wide_path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  free(wide_path);
+  if (file == INVALID_HANDLE_VALUE)
+    return NULL;
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0) {
+    CloseHandle(file);
+    return NULL;
+  }
+
+  HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  CloseHandle(file);
+  if (!mapping)
+    return NULL;
+
+  /* The view keeps the mapping alive after its handle is closed */
+  const void *addr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (!addr)
+    return NULL;
+
+  *size = (size_t)file_size.QuadPart;
+  return addr;
+}
+
+void platform_unmap_file(const void *addr, size_t size) {
+  (void)size;
+  if (addr)
+    UnmapViewOfFile(addr);
+}
+
+int platform_cpu_count(void) {
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+}
+
+typedef struct {
+  PlatformThreadFn fn;
+  void *arg;
+  int index;
+} ThreadStart;
+
+static DWORD WINAPI thread_entry(LPVOID p) {
+  ThreadStart *start = p;
+  start->fn(start->arg, start->index);
+  return 0;
+}
+
+void platform_run_threads(int nthreads, PlatformThreadFn fn, void *arg) {
+  if (nthreads <= 1) {
+    fn(arg, 0);
+    return;
+  }
+
+  HANDLE *threads = calloc((size_t)nthreads, sizeof(*threads));
+  ThreadStart *starts = calloc((size_t)nthreads, sizeof(*starts));
+  if (!threads || !starts) {
+    for (int i = 0; i < nthreads; i++)
+      fn(arg, i);
+  } else {
+    for (int i = 1; i < nthreads; i++) {
+      starts[i] = (ThreadStart){fn, arg, i};
+      threads[i] = CreateThread(NULL, 0, thread_entry, &starts[i], 0, NULL);
+    }
+    fn(arg, 0);
+    for (int i = 1; i < nthreads; i++) {
+      if (threads[i]) {
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+      } else {
+        fn(arg, i);
+      }
+    }
+  }
+  free(threads);
+  free(starts);
+}
+
 void platform_localtime(const time_t *t, struct tm *result) {
   localtime_s(result, t);
 }
 
+void platform_sleep_until(time_t t) {
+  // Re-read the wall clock after each nap, at most a minute long: Sleep()
+  // counts elapsed time and would miss a clock step
+  const long long unix_epoch = 116444736000000000LL; // 1970-01-01 in FILETIME ticks
+  for (;;) {
+    FILETIME ft;
+    GetSystemTimeAsFileTime(&ft);
+    long long now = ((long long)ft.dwHighDateTime << 32 | ft.dwLowDateTime) - unix_epoch;
+    long long left_ms = ((long long)t * 10000000LL - now) / 10000;
+    if (left_ms <= 0)
+      return;
+    Sleep((DWORD)(left_ms > 60000 ? 60000 : left_ms));
+  }
+}
+
 int platform_isatty(FILE *stream) {
   return _isatty(_fileno(stream));
 }
@@ -0,0 +1,37 @@
+// The prayer-time engine built with PRAYERTIMES_FAST_TRIG, with internal
+// linkage so it can sit next to the default build in the same program.
+
+#define PRAYERTIMES_STATIC
+#define PRAYERTIMES_FAST_TRIG
+#define PRAYERTIMES_IMPLEMENTATION
+#include "prayertimes_fast_trig.h"
+
+struct PrayerTimes fast_calculate_prayer_times(int year, int month, int day, double latitude,
+                                               double longitude, double timezone,
+                                               const MethodParams *params) {
+  return calculate_prayer_times(year, month, day, latitude, longitude, timezone, params);
+}
+
+double fast_sin(double x) {
+  return pt_sin(x);
+}
+
+double fast_cos(double x) {
+  return pt_cos(x);
+}
+
+double fast_tan(double x) {
+  return pt_tan(x);
+}
+
+double fast_asin(double x) {
+  return pt_asin(x);
+}
+
+double fast_acos(double x) {
+  return pt_acos(x);
+}
+
+double fast_atan2(double y, double x) {
+  return pt_atan2(y, x);
+}
@@ -0,0 +1,20 @@
+#ifndef PRAYERTIMES_FAST_TRIG_H
+#define PRAYERTIMES_FAST_TRIG_H
+
+#include "prayertimes.h"
+
+/* Entry points into a PRAYERTIMES_FAST_TRIG copy of the engine (see
+ * prayertimes_fast_trig.c), for comparing against the default libm build. */
+
+struct PrayerTimes fast_calculate_prayer_times(int year, int month, int day, double latitude,
+                                               double longitude, double timezone,
+                                               const MethodParams *params);
+
+double fast_sin(double x);
+double fast_cos(double x);
+double fast_tan(double x);
+double fast_asin(double x);
+double fast_acos(double x);
+double fast_atan2(double y, double x);
+
+#endif /* PRAYERTIMES_FAST_TRIG_H */
@@ -68,6 +68,7 @@ static void test_build_triggers_includes_future(void) {
     }
   }
   check_bool("includes dhuhr exact", found_dhuhr);
+  cache_free(&cache);
 }
 
 static void test_build_triggers_sorted(void) {
@@ -81,6 +82,7 @@ static void test_build_triggers_sorted(void) {
   for (int i = 1; i < cache.trigger_count; i++) {
     check_bool("sorted ascending", cache.triggers[i].minute >= cache.triggers[i - 1].minute);
   }
+  cache_free(&cache);
 }
 
 static void test_build_triggers_skips_disabled(void) {
@@ -95,6 +97,7 @@ static void test_build_triggers_skips_disabled(void) {
   for (int i = 0; i < cache.trigger_count; i++) {
     check_bool("no fajr trigger", strcmp(cache.triggers[i].prayer, "Fajr") != 0);
   }
+  cache_free(&cache);
 }
 
 static void test_build_triggers_includes_reminders(void) {
@@ -113,12 +116,14 @@ static void test_build_triggers_includes_reminders(void) {
     }
   }
   check_bool("fajr has 3 reminders", fajr_reminder_count == 3);
+  cache_free(&cache);
 }
 
 static void test_remove_trigger(void) {
   printf("  remove trigger...\n");
   PrayerCache cache = {0};
   strcpy(cache.date, "2026-03-22");
+  cache_reserve(&cache, 3);
   cache.trigger_count = 3;
   strcpy(cache.triggers[0].prayer, "Fajr");
   cache.triggers[0].minute = 236;
@@ -132,6 +137,219 @@ static void test_remove_trigger(void) {
   check_bool("count decremented", cache.trigger_count == 2);
   check_bool("shifted correctly",
              strcmp(cache.triggers[0].prayer, "Fajr") == 0 && cache.triggers[0].minute == 251);
+  cache_free(&cache);
+}
+
+static void test_window_dst(void) {
+  printf("  window across a DST change...\n");
+  setenv("TZ", "Europe/Berlin", 1); // Clocks go forward 2026-03-29 02:00
+  tzset();
+
+  Config cfg = test_config();
+  cfg.fajr.reminder_count = 1;
+  cfg.fajr.reminders[0] = 300;
+  PrayerCache cache = {0};
+  cache_build_window(&cache, &cfg, "2026-03-27", CACHE_WINDOW_DAYS, 0);
+
+  // Every due time reads back as the trigger's local minute, before and after the change
+  bool local = cache.trigger_count > 0;
+  int on_28th = 0, on_29th = 0;
+  for (int i = 0; i < cache.trigger_count; i++) {
+    struct tm tm_due;
+    localtime_r(&cache.triggers[i].due, &tm_due);
+    local = local && tm_due.tm_hour * 60 + tm_due.tm_min == cache.triggers[i].minute &&
+            tm_due.tm_sec == 0;
+    on_28th += tm_due.tm_mday == 28;
+    on_29th += tm_due.tm_mday == 29;
+  }
+  check_bool("due times are local minutes", local);
+  check_bool("short day keeps every trigger", on_29th == on_28th && on_28th > 0);
+  cache_free(&cache);
+
+  unsetenv("TZ");
+  tzset();
+}
+
+static void test_is_current(void) {
+  printf("  cache keyed by date and config hash...\n");
+  Config cfg = test_config();
+  struct PrayerTimes times = jakarta_times();
+  PrayerCache cache = {0};
+  cache_build_triggers(&cache, &cfg, &times, 0, "2026-03-22");
+
+  check_bool("fresh cache is current", cache_is_current(&cache, &cfg, "2026-03-22"));
+  check_bool("other date is stale", !cache_is_current(&cache, &cfg, "2026-03-23"));
+
+  Config edited = cfg;
+  edited.maghrib.reminders[0] = 7;
+  check_bool("reminder edit is stale", !cache_is_current(&cache, &edited, "2026-03-22"));
+  edited = cfg;
+  strcpy(edited.calculation_method, "mwl");
+  check_bool("method edit is stale", !cache_is_current(&cache, &edited, "2026-03-22"));
+  edited = cfg;
+  edited.notification_sound = !cfg.notification_sound;
+  strcpy(edited.notification_urgency, "low");
+  check_bool("notification edit keeps cache", cache_is_current(&cache, &edited, "2026-03-22"));
+
+  // Emptied by firing everything is still a valid cache for the day
+  cache.trigger_count = 0;
+  check_bool("empty cache is current", cache_is_current(&cache, &cfg, "2026-03-22"));
+  cache_free(&cache);
+}
+
+static void test_rebuild_prayer(void) {
+  printf("  rebuild one prayer...\n");
+  Config cfg = test_config();
+  struct PrayerTimes times = jakarta_times();
+  PrayerCache cache = {0};
+  cache_build_triggers(&cache, &cfg, &times, 0, "2026-03-22");
+  PrayerCache before = {0};
+  cache_copy(&before, &cache);
+
+  cfg.asr.reminder_count = 1;
+  cfg.asr.reminders[0] = 45;
+  cache_rebuild_prayer(&cache, &cfg, PRAYER_ASR, 0);
+
+  int asr = 0, others = 0, others_before = 0;
+  bool asr_ok = true, sorted = true;
+  for (int i = 0; i < cache.trigger_count; i++) {
+    if (strcmp(cache.triggers[i].prayer, "Asr") == 0) {
+      asr++;
+      asr_ok = asr_ok && (cache.triggers[i].minutes_before == 0 ||
+                          cache.triggers[i].minutes_before == 45);
+    } else {
+      others++;
+    }
+    if (i > 0)
+      sorted = sorted && cache.triggers[i - 1].due <= cache.triggers[i].due;
+  }
+  for (int i = 0; i < before.trigger_count; i++)
+    others_before += strcmp(before.triggers[i].prayer, "Asr") != 0;
+  check_bool("asr has exact time and new reminder", asr == 2 && asr_ok);
+  check_bool("other prayers untouched", others == others_before);
+  check_bool("still sorted", sorted);
+  check_bool("date kept", strcmp(cache.date, "2026-03-22") == 0);
+
+  cfg.asr.enabled = false;
+  cache_rebuild_prayer(&cache, &cfg, PRAYER_ASR, 0);
+  check_bool("disabled prayer removed", cache.trigger_count == others_before);
+  cache_free(&before);
+  cache_free(&cache);
+}
+
+static void test_due_times(void) {
+  printf("  due times and binary search...\n");
+  setenv("TZ", "UTC", 1);
+  tzset();
+
+  Config cfg = test_config();
+  struct PrayerTimes times = jakarta_times();
+  PrayerCache cache = {0};
+  cache_build_triggers(&cache, &cfg, &times, 0, "2026-03-22");
+
+  const time_t day0 = 1774137600; // 2026-03-22 00:00 UTC
+  bool exact = true;
+  for (int i = 0; i < cache.trigger_count; i++)
+    exact = exact && cache.triggers[i].due == day0 + cache.triggers[i].minute * 60;
+  check_bool("due is date + minute", exact);
+
+  check_bool("before all -> 0", cache_first_due_after(&cache, day0) == 0);
+  check_bool("after all -> count",
+             cache_first_due_after(&cache, day0 + 86400) == cache.trigger_count);
+  time_t t = cache.triggers[3].due;
+  int k = cache_first_due_after(&cache, t);
+  check_bool("first due after is strictly later", cache.triggers[k].due > t);
+  check_bool("everything before is due", cache.triggers[k - 1].due <= t);
+
+  int count = cache.trigger_count;
+  time_t third = cache.triggers[2].due;
+  cache_remove_first(&cache, 2);
+  check_bool("remove first advances head", cache_pending(&cache) == count - 2 &&
+                                               cache.triggers[cache.head].due == third);
+  check_bool("search skips consumed", cache_first_due_after(&cache, day0) == cache.head);
+  cache_remove_first(&cache, 1000);
+  check_bool("remove first clamps", cache_pending(&cache) == 0);
+  cache_free(&cache);
+  unsetenv("TZ");
+  tzset();
+}
+
+static int count_due_on(const PrayerCache *cache, time_t day_start) {
+  int n = 0;
+  for (int i = 0; i < cache->trigger_count; i++)
+    n += cache->triggers[i].due >= day_start && cache->triggers[i].due < day_start + 86400;
+  return n;
+}
+
+static void test_window(void) {
+  printf("  rolling multi-day window...\n");
+  setenv("TZ", "UTC", 1);
+  tzset();
+  const time_t day0 = 1774137600; // 2026-03-22 00:00 UTC
+
+  // A reminder far enough ahead of Fajr to fall on the evening before
+  Config cfg = test_config();
+  cfg.fajr.reminder_count = 1;
+  cfg.fajr.reminders[0] = 300;
+  PrayerCache cache = {0};
+  int count = cache_build_window(&cache, &cfg, "2026-03-22", CACHE_WINDOW_DAYS, day0);
+  check_bool("window spans the days", cache.days == CACHE_WINDOW_DAYS && count > 0);
+  check_bool("every day scheduled", count_due_on(&cache, day0) > 0 &&
+                                        count_due_on(&cache, day0 + 6 * 86400) > 0);
+  bool sorted = true;
+  for (int i = 1; i < cache.trigger_count; i++)
+    sorted = sorted && cache.triggers[i - 1].due <= cache.triggers[i].due;
+  check_bool("window sorted by due", sorted);
+
+  // Exactly 300 minutes before the next day's Fajr, not 24 hours off
+  const CacheTrigger *early = NULL;
+  for (int i = 0; i < cache.trigger_count && !early; i++) {
+    const CacheTrigger *t = &cache.triggers[i];
+    if (strcmp(t->prayer, "Fajr") == 0 && t->minutes_before == 300 && t->due >= day0 + 86400 / 2)
+      early = t;
+  }
+  time_t fajr1 = day0 + 86400 + (time_t)ceil(early ? early->prayer_time * 60.0 : 0) * 60;
+  check_bool("cross-midnight reminder exact", early && early->due == fajr1 - 300 * 60 &&
+                                                  early->due < day0 + 86400 &&
+                                                  early->minute == (early->due - day0) / 60);
+  check_bool("first day's own early reminder excluded", cache.triggers[0].due >= day0);
+
+  check_bool("covered day indexed", cache_day_index(&cache, "2026-03-28") == 6);
+  check_bool("day past the window", cache_day_index(&cache, "2026-03-29") == -1);
+  check_bool("day before the window", cache_day_index(&cache, "2026-03-21") == -1);
+  check_bool("window current mid-week", cache_is_current(&cache, &cfg, "2026-03-25"));
+
+  // Rolling forward two days keeps the later days and appends new ones
+  PrayerCache full = {0};
+  cache_copy(&full, &cache);
+  cache_remove_first(&cache, cache_first_due_after(&cache, day0 + 2 * 86400 - 1));
+  check_bool("full window not extended", cache_extend(&full, &cfg, "2026-03-22", day0) == 0);
+  check_bool("rolled two days", cache_extend(&cache, &cfg, "2026-03-24", day0 + 2 * 86400) == 2);
+  check_bool("window starts today",
+             strcmp(cache.date, "2026-03-24") == 0 && cache.days == CACHE_WINDOW_DAYS);
+  PrayerCache fresh = {0};
+  cache_build_window(&fresh, &cfg, "2026-03-24", CACHE_WINDOW_DAYS, day0 + 2 * 86400);
+  bool same = fresh.trigger_count == cache.trigger_count;
+  for (int i = 0; same && i < fresh.trigger_count; i++)
+    same = fresh.triggers[i].due == cache.triggers[i].due &&
+           fresh.triggers[i].minutes_before == cache.triggers[i].minutes_before;
+  check_bool("rolled window equals a fresh build", same);
+  check_bool("day outside the window not extended",
+             cache_extend(&cache, &cfg, "2026-04-05", day0) == -1);
+
+  // Rebuilding a prayer covers every day of the window
+  cfg.isha.reminder_count = 0;
+  cache_rebuild_prayer(&cache, &cfg, PRAYER_ISHA, day0);
+  int isha = 0;
+  for (int i = 0; i < cache.trigger_count; i++)
+    isha += strcmp(cache.triggers[i].prayer, "Isha") == 0;
+  check_bool("prayer rebuilt across the window", isha == CACHE_WINDOW_DAYS);
+  cache_free(&full);
+  cache_free(&fresh);
+  cache_free(&cache);
+
+  unsetenv("TZ");
+  tzset();
 }
 
 static void test_save_load_roundtrip(void) {
@@ -148,11 +366,13 @@ static void test_save_load_roundtrip(void) {
   cache_reset_path();
   check_bool("cache path starts in tmpdir", strncmp(cache_get_path(), tmpdir, strlen(tmpdir)) == 0);
   check_bool("cache path includes muslimtify dir",
-             strstr(cache_get_path(), "/muslimtify/next_prayer.json") != NULL);
+             strstr(cache_get_path(), "/muslimtify/next_prayer.bin") != NULL);
 
   // Build a cache
   PrayerCache original = {0};
   strcpy(original.date, "2026-03-22");
+  original.config_hash = 0xfedcba9876543210ULL;
+  cache_reserve(&original, 2);
   original.trigger_count = 2;
   strcpy(original.triggers[0].prayer, "Fajr");
   original.triggers[0].minute = 266;
@@ -172,12 +392,58 @@ static void test_save_load_roundtrip(void) {
   int load_ok = cache_load(&loaded);
   check_bool("load succeeds", load_ok == 0);
   check_bool("date matches", strcmp(loaded.date, "2026-03-22") == 0);
+  check_bool("config hash matches", loaded.config_hash == 0xfedcba9876543210ULL);
   check_bool("count matches", loaded.trigger_count == 2);
   check_bool("prayer[0] matches", strcmp(loaded.triggers[0].prayer, "Fajr") == 0);
   check_bool("minute[0] matches", loaded.triggers[0].minute == 266);
   check_bool("prayer[1] matches", strcmp(loaded.triggers[1].prayer, "Dhuhr") == 0);
   check_bool("prayer_time[1] close", fabs(loaded.triggers[1].prayer_time - 12.0667) < 0.01);
 
+  // Whole file image validates in place
+  size_t size = 0;
+  const void *map = platform_map_file(cache_get_path(), &size);
+  const CacheFileHeader *h = cache_file_check(map, size);
+  check_bool("mapped file validates", h != NULL && h->trigger_count == 2);
+  check_bool("records follow the header",
+             h && strcmp(((const CacheTrigger *)(h + 1))[1].prayer, "Dhuhr") == 0);
+  check_bool("truncated image rejected", cache_file_check(map, size - 1) == NULL);
+  if (map)
+    platform_unmap_file(map, size);
+
+  // Flip one bit in the records
+  FILE *f = fopen(cache_get_path(), "r+b");
+  if (f) {
+    fseek(f, (long)sizeof(CacheFileHeader) + 17, SEEK_SET);
+    int c = fgetc(f);
+    fseek(f, (long)sizeof(CacheFileHeader) + 17, SEEK_SET);
+    fputc(c ^ 1, f);
+    fclose(f);
+  }
+  check_bool("corrupt record fails CRC", cache_load(&loaded) == -1);
+
+  // A pre-binary JSON cache is not a cache
+  f = fopen(cache_get_path(), "w");
+  if (f) {
+    fputs("{\"date\": \"2026-03-22\", \"triggers\": []}\n", f);
+    fclose(f);
+  }
+  check_bool("legacy JSON cache rejected", cache_load(&loaded) == -1);
+
+  // Debug export
+  char json[1024] = {0};
+  f = tmpfile();
+  if (f) {
+    cache_export_json(&original, f);
+    rewind(f);
+    size_t n = fread(json, 1, sizeof(json) - 1, f);
+    json[n] = '\0';
+    fclose(f);
+  }
+  check_bool("JSON export has date", strstr(json, "\"date\": \"2026-03-22\"") != NULL);
+  check_bool("JSON export has hash", strstr(json, "\"config_hash\": \"fedcba9876543210\"") != NULL);
+  check_bool("JSON export has triggers",
+             strstr(json, "\"prayer\": \"Dhuhr\", \"minute\": 724") != NULL);
+
   cache_invalidate();
   check_bool("cache file removed", platform_file_exists(cache_get_path()) == 0);
 
@@ -186,6 +452,8 @@ static void test_save_load_roundtrip(void) {
     fprintf(stderr, "FAIL [mkdtemp reset]\n");
     failed++;
     unsetenv("XDG_CACHE_HOME");
+    cache_free(&original);
+    cache_free(&loaded);
     return;
   }
   setenv("XDG_CACHE_HOME", tmpdir2, 1);
@@ -193,7 +461,7 @@ static void test_save_load_roundtrip(void) {
   check_bool("cache path resets to new tmpdir",
              strncmp(cache_get_path(), tmpdir2, strlen(tmpdir2)) == 0);
   check_bool("cache path still includes muslimtify dir",
-             strstr(cache_get_path(), "/muslimtify/next_prayer.json") != NULL);
+             strstr(cache_get_path(), "/muslimtify/next_prayer.bin") != NULL);
 
   check_bool("save after reset succeeds", cache_save(&original) == 0);
   PrayerCache reloaded = {0};
@@ -201,6 +469,9 @@ static void test_save_load_roundtrip(void) {
   check_bool("reset date matches", strcmp(reloaded.date, "2026-03-22") == 0);
   check_bool("reset count matches", reloaded.trigger_count == 2);
   check_bool("reset prayer matches", strcmp(reloaded.triggers[0].prayer, "Fajr") == 0);
+  cache_free(&original);
+  cache_free(&loaded);
+  cache_free(&reloaded);
 
   // Cleanup
   cache_invalidate();
@@ -216,6 +487,120 @@ static void test_save_load_roundtrip(void) {
   unsetenv("XDG_CACHE_HOME");
 }
 
+static long file_size(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return -1;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fclose(f);
+  return size;
+}
+
+static void test_fired_log(void) {
+  printf("  consumption through the fired log...\n");
+  char tmpdir[] = "/tmp/mt_cache_fired_XXXXXX";
+  if (!mkdtemp(tmpdir)) {
+    fprintf(stderr, "FAIL [mkdtemp]\n");
+    failed++;
+    return;
+  }
+  setenv("XDG_CACHE_HOME", tmpdir, 1);
+  cache_reset_path();
+
+  Config cfg = test_config();
+  PrayerCache cache = {0};
+  int count = cache_build_window(&cache, &cfg, "2026-03-22", CACHE_WINDOW_DAYS, 0);
+  cache_save(&cache);
+  long cache_size = file_size(cache_get_path());
+  check_bool("nothing consumed, nothing logged",
+             cache_save_fired(&cache) == 0 && file_size(cache_get_fired_path()) == -1);
+
+  cache_remove_first(&cache, 3);
+  check_bool("log append succeeds", cache_save_fired(&cache) == 0);
+  check_bool("one record logged", file_size(cache_get_fired_path()) == 8);
+  check_bool("cache file untouched", file_size(cache_get_path()) == cache_size);
+
+  PrayerCache loaded = {0};
+  check_bool("load applies the log",
+             cache_load(&loaded) == 0 && loaded.head == 3 && cache_pending(&loaded) == count - 3);
+
+  cache_remove_first(&cache, 2);
+  cache_save_fired(&cache);
+  FILE *f = fopen(cache_get_fired_path(), "ab");
+  if (f) {
+    fputs("xyz", f); // Torn write
+    fclose(f);
+  }
+  check_bool("newest record wins, torn tail ignored",
+             cache_load(&loaded) == 0 && cache_pending(&loaded) == count - 5);
+
+  check_bool("save compacts", cache_save(&loaded) == 0 &&
+                                  file_size(cache_get_fired_path()) == -1 &&
+                                  file_size(cache_get_path()) < cache_size);
+  check_bool("compacted cache reloads", cache_load(&loaded) == 0 && loaded.head == 0 &&
+                                            loaded.trigger_count == count - 5 &&
+                                            loaded.triggers[0].due == cache.triggers[5].due);
+  cache_free(&loaded);
+  cache_free(&cache);
+
+  cache_invalidate();
+  cache_reset_path();
+  char dir[PLATFORM_PATH_MAX];
+  snprintf(dir, sizeof(dir), "%s/muslimtify", tmpdir);
+  (void)rmdir(dir);
+  (void)rmdir(tmpdir);
+  unsetenv("XDG_CACHE_HOME");
+}
+
+static void test_large_window(void) {
+  printf("  large window keeps every trigger...\n");
+  char tmpdir[] = "/tmp/mt_cache_large_XXXXXX";
+  if (!mkdtemp(tmpdir)) {
+    fprintf(stderr, "FAIL [mkdtemp]\n");
+    failed++;
+    return;
+  }
+  setenv("XDG_CACHE_HOME", tmpdir, 1);
+  cache_reset_path();
+
+  // Every prayer with the most reminders the config allows, for a month
+  Config cfg = test_config();
+  PrayerConfig *prayers[] = {&cfg.fajr, &cfg.sunrise, &cfg.dhuha, &cfg.dhuhr,
+                             &cfg.asr,  &cfg.maghrib, &cfg.isha};
+  for (size_t i = 0; i < sizeof(prayers) / sizeof(prayers[0]); i++) {
+    prayers[i]->enabled = true;
+    prayers[i]->reminder_count = MAX_REMINDERS;
+    for (int k = 0; k < MAX_REMINDERS; k++)
+      prayers[i]->reminders[k] = 5 * (k + 1);
+  }
+  const int days = 30;
+  int expected = days * 7 * (1 + MAX_REMINDERS);
+
+  PrayerCache cache = {0};
+  int count = cache_build_window(&cache, &cfg, "2026-03-22", days, 0);
+  check_bool("nothing dropped", count == expected && cache.days == days);
+  check_bool("block reserved once", cache.capacity == expected);
+
+  PrayerCache loaded = {0};
+  check_bool("large cache round-trips", cache_save(&cache) == 0 && cache_load(&loaded) == 0 &&
+                                            loaded.trigger_count == expected &&
+                                            loaded.triggers[expected - 1].due ==
+                                                cache.triggers[expected - 1].due);
+
+  cache_free(&cache);
+  cache_free(&loaded);
+  check_bool("freed cache is empty", cache.triggers == NULL && cache.capacity == 0);
+
+  cache_invalidate();
+  cache_reset_path();
+  char dir[PLATFORM_PATH_MAX];
+  snprintf(dir, sizeof(dir), "%s/muslimtify", tmpdir);
+  (void)rmdir(dir);
+  (void)rmdir(tmpdir);
+  unsetenv("XDG_CACHE_HOME");
+}
+
 int main(void) {
   printf("Running cache tests...\n");
 
@@ -224,6 +609,13 @@ int main(void) {
   test_build_triggers_skips_disabled();
   test_build_triggers_includes_reminders();
   test_remove_trigger();
+  test_is_current();
+  test_window();
+  test_window_dst();
+  test_fired_log();
+  test_large_window();
+  test_rebuild_prayer();
+  test_due_times();
   test_save_load_roundtrip();
 
   printf("\nResults: %d passed, %d failed\n", passed, failed);
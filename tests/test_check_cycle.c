@@ -0,0 +1,365 @@
+#define _GNU_SOURCE
+#include "cache.h"
+#include "check_cycle.h"
+#include "config.h"
+#include "platform.h"
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+static int passed = 0;
+static int failed = 0;
+
+static void check_bool(const char *test, bool cond) {
+  if (cond) {
+    passed++;
+  } else {
+    failed++;
+    fprintf(stderr, "FAIL [%s]\n", test);
+  }
+}
+
+static char tmpdir[] = "/tmp/mt_check_cycle_XXXXXX";
+static int notified = 0;
+static time_t notified_due[256];
+
+static void count_notify(const CacheTrigger *trigger, const Config *cfg, void *user) {
+  (void)cfg;
+  (void)user;
+  if (notified < 256)
+    notified_due[notified] = trigger->due;
+  notified++;
+}
+
+static bool was_notified(int from, time_t due) {
+  for (int i = from; i < notified && i < 256; i++) {
+    if (notified_due[i] == due)
+      return true;
+  }
+  return false;
+}
+
+// 2026-03-22 00:00 UTC; the test runs with TZ=UTC
+static const time_t DAY0 = 1774137600;
+
+static time_t at_minute(int minute) {
+  return DAY0 + (time_t)minute * 60;
+}
+
+// Rewrite config.json with one latitude digit changed: same size, and the old
+// mtime is put back unless touch is set
+static void edit_config_latitude(const char *from, const char *to, bool touch) {
+  const char *path = config_get_path();
+  struct stat before;
+  stat(path, &before);
+
+  FILE *f = fopen(path, "r");
+  char buf[8192];
+  size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+  fclose(f);
+  buf[n] = '\0';
+  char *p = strstr(buf, from);
+  if (p)
+    memcpy(p, to, strlen(to));
+
+  f = fopen(path, "w");
+  fwrite(buf, 1, n, f);
+  fclose(f);
+
+  struct timespec times[2] = {before.st_atim, before.st_mtim};
+  if (touch)
+    times[1].tv_sec += 5;
+  utimensat(AT_FDCWD, path, times, 0);
+}
+
+static const CacheTrigger *next_trigger(const DaemonState *st) {
+  return &st->cache.triggers[st->cache.head];
+}
+
+static void test_resident_state(void) {
+  printf("  resident daemon state...\n");
+  DaemonState st;
+  daemon_state_init(&st);
+  st.notify = count_notify;
+
+  check_bool("first check succeeds", daemon_state_check(&st, at_minute(0)) == 0);
+  check_bool("config loaded", st.config_loaded && st.cfg.latitude < -6.2);
+  check_bool("schedule for today", strcmp(st.cache.date, "2026-03-22") == 0);
+  check_bool("schedule has triggers", cache_pending(&st.cache) > 0);
+  check_bool("schedule persisted", platform_file_exists(cache_get_path()) == 1);
+
+  // Steady state: the cache is neither read nor rewritten, and a config whose
+  // stamp did not move is not re-read
+  int pending = cache_pending(&st.cache);
+  int first_minute = next_trigger(&st)->minute;
+  cache_invalidate();
+  edit_config_latitude("-6.2088", "-6.2099", false);
+  for (int m = 1; m < first_minute; m++)
+    daemon_state_check(&st, at_minute(m));
+  check_bool("no notifications before first trigger", notified == 0);
+  check_bool("triggers kept in memory", cache_pending(&st.cache) == pending);
+  check_bool("cache file not rewritten", platform_file_exists(cache_get_path()) == 0);
+  check_bool("config not re-read", st.cfg.latitude < -6.2087 && st.cfg.latitude > -6.2089);
+
+  // A due trigger fires from memory and is persisted
+  check_bool("trigger minute succeeds", daemon_state_check(&st, at_minute(first_minute)) == 0);
+  check_bool("trigger notified", notified > 0);
+  check_bool("fired trigger removed", cache_pending(&st.cache) == pending - notified);
+  check_bool("firing appends to the fired log",
+             platform_file_exists(cache_get_fired_path()) == 1 &&
+                 platform_file_exists(cache_get_path()) == 0);
+
+  // A changed stamp reloads the config and rebuilds the schedule
+  edit_config_latitude("-6.2099", "-6.2111", true);
+  check_bool("reload succeeds", daemon_state_check(&st, at_minute(first_minute + 1)) == 0);
+  check_bool("config reloaded", st.cfg.latitude < -6.2110 && st.cfg.latitude > -6.2112);
+  check_bool("rebuilt from current minute", cache_pending(&st.cache) > 0 &&
+                                                next_trigger(&st)->minute > first_minute);
+
+  // A deleted config keeps the loaded one
+  platform_file_delete(config_get_path());
+  check_bool("missing config tolerated", daemon_state_check(&st, at_minute(first_minute + 2)) == 0);
+  check_bool("loaded config kept", st.cfg.latitude < -6.2110);
+  daemon_state_request_reload(&st);
+  check_bool("reload without config tolerated",
+             daemon_state_check(&st, at_minute(first_minute + 3)) == 0);
+  check_bool("loaded config kept on reload", st.cfg.latitude < -6.2110);
+
+  // A new day rebuilds the schedule
+  check_bool("next day succeeds", daemon_state_check(&st, at_minute(24 * 60)) == 0);
+  check_bool("schedule for next day", strcmp(st.cache.date, "2026-03-23") == 0);
+  check_bool("full day scheduled", cache_pending(&st.cache) >= pending);
+  daemon_state_free(&st);
+}
+
+static void test_next_wake(const Config *cfg) {
+  printf("  next wake-up follows pending triggers...\n");
+  config_save(cfg);
+  DaemonState st;
+  daemon_state_init(&st);
+  st.notify = count_notify;
+
+  check_bool("no schedule: retry next minute", daemon_state_next_wake(&st, at_minute(5) + 30) ==
+                                                   at_minute(6));
+
+  daemon_state_check(&st, at_minute(0));
+  int first = next_trigger(&st)->minute;
+  check_bool("sleeps until first trigger", daemon_state_next_wake(&st, at_minute(0)) ==
+                                               at_minute(first));
+  check_bool("mid-minute plans the same", daemon_state_next_wake(&st, at_minute(0) + 42) ==
+                                              at_minute(first));
+
+  // Walking the day wake-up to wake-up fires every trigger once
+  int pending = 0;
+  for (int i = st.cache.head; i < st.cache.trigger_count; i++)
+    pending += st.cache.triggers[i].due < at_minute(24 * 60);
+  int wakeups = 0;
+  int before = notified;
+  time_t now = at_minute(0);
+  time_t next;
+  while ((next = daemon_state_next_wake(&st, now)) < at_minute(24 * 60)) {
+    now = next;
+    daemon_state_check(&st, now);
+    wakeups++;
+  }
+  check_bool("every trigger fired", notified - before == pending);
+  check_bool("at most one wake-up per trigger", wakeups <= pending);
+
+  // The window already holds tomorrow: no midnight wake-up, the day rolls at its first trigger
+  check_bool("next wake-up is tomorrow's first trigger",
+             next > at_minute(24 * 60) && next == next_trigger(&st)->due);
+  daemon_state_check(&st, next);
+  check_bool("window rolled to the next day", strcmp(st.cache.date, "2026-03-23") == 0 &&
+                                                  st.cache.days == CACHE_WINDOW_DAYS);
+  daemon_state_free(&st);
+}
+
+static void test_catch_up(const Config *cfg) {
+  printf("  catch-up after suspend and clock steps...\n");
+  config_save(cfg);
+  DaemonState st;
+  daemon_state_init(&st);
+  st.notify = count_notify;
+  daemon_state_check(&st, at_minute(0));
+
+  // Resume 3 minutes after the first trigger: within the window, fires late
+  int first = next_trigger(&st)->minute;
+  int before = notified;
+  daemon_state_check(&st, at_minute(first + 3) + 20);
+  check_bool("late trigger within window fires", notified > before);
+
+  // Resume well past the next trigger: dropped, not shown an hour late
+  int pending = cache_pending(&st.cache);
+  int second = next_trigger(&st)->minute;
+  before = notified;
+  daemon_state_check(&st, at_minute(second + cfg->notification_catchup + 1));
+  check_bool("trigger past the window dropped", !was_notified(before, at_minute(second)));
+  check_bool("dropped trigger removed",
+             cache_pending(&st.cache) < pending && next_trigger(&st)->minute > second);
+
+  // Clock steps back over fired triggers: nothing fires twice
+  before = notified;
+  for (int m = first - 1; m <= second + 1; m++)
+    daemon_state_check(&st, at_minute(m));
+  check_bool("backward step does not re-fire", notified == before);
+
+  // Step back across midnight into a rebuilt schedule: still no repeats
+  daemon_state_check(&st, at_minute(24 * 60 + 1));
+  before = notified;
+  daemon_state_check(&st, at_minute(first + 1));
+  check_bool("rebuilt earlier day does not re-fire", notified == before);
+  daemon_state_free(&st);
+}
+
+static int count_prayer(const PrayerCache *cache, const char *prayer) {
+  int n = 0;
+  for (int i = cache->head; i < cache->trigger_count; i++)
+    n += strcmp(cache->triggers[i].prayer, prayer) == 0;
+  return n;
+}
+
+static const CacheTrigger *first_exact(const PrayerCache *cache, const char *prayer) {
+  for (int i = cache->head; i < cache->trigger_count; i++) {
+    if (strcmp(cache->triggers[i].prayer, prayer) == 0 && cache->triggers[i].minutes_before == 0)
+      return &cache->triggers[i];
+  }
+  return NULL;
+}
+
+static void test_incremental_reload(const Config *cfg) {
+  printf("  reload rebuilds only what changed...\n");
+  config_save(cfg);
+  DaemonState st;
+  daemon_state_init(&st);
+  st.notify = count_notify;
+  daemon_state_check(&st, at_minute(0));
+  PrayerCache before = {0};
+  cache_copy(&before, &st.cache);
+
+  // Notification settings only: nothing rebuilt, nothing written
+  Config edit = *cfg;
+  strcpy(edit.notification_urgency, "low");
+  config_save(&edit);
+  cache_invalidate();
+  daemon_state_request_reload(&st);
+  daemon_state_check(&st, at_minute(1));
+  check_bool("notification edit detected", st.last_diff == CONFIG_DIFF_OTHER);
+  check_bool("new urgency in use", strcmp(st.cfg.notification_urgency, "low") == 0);
+  check_bool("schedule untouched",
+             st.cache.head == before.head && st.cache.trigger_count == before.trigger_count &&
+                 memcmp(st.cache.triggers, before.triggers,
+                        (size_t)before.trigger_count * sizeof(CacheTrigger)) == 0);
+  check_bool("cache not rewritten", platform_file_exists(cache_get_path()) == 0);
+
+  // One prayer's reminders: only that prayer's triggers change
+  edit.isha.reminder_count = 1;
+  edit.isha.reminders[0] = 60;
+  config_save(&edit);
+  daemon_state_request_reload(&st);
+  daemon_state_check(&st, at_minute(2));
+  check_bool("reminder edit detected", st.last_diff == CONFIG_DIFF_PRAYER(PRAYER_ISHA));
+  check_bool("isha rebuilt", count_prayer(&st.cache, "Isha") == 2 * CACHE_WINDOW_DAYS);
+  check_bool("fajr kept", count_prayer(&st.cache, "Fajr") == count_prayer(&before, "Fajr"));
+  check_bool("asr kept", count_prayer(&st.cache, "Asr") == count_prayer(&before, "Asr"));
+  bool due_ok = true;
+  for (int i = st.cache.head; i < st.cache.trigger_count; i++) {
+    const CacheTrigger *t = &st.cache.triggers[i];
+    due_ok = due_ok && (t->due - DAY0) / 60 % (24 * 60) == t->minute;
+  }
+  check_bool("rebuilt triggers have due times", due_ok);
+  check_bool("incremental rebuild persisted", platform_file_exists(cache_get_path()) == 1);
+
+  // Location: every time moves, full rebuild
+  edit.longitude += 1.0;
+  config_save(&edit);
+  daemon_state_request_reload(&st);
+  daemon_state_check(&st, at_minute(3));
+  check_bool("location edit detected", st.last_diff == CONFIG_DIFF_TIMES);
+  const CacheTrigger *dhuhr_before = first_exact(&before, "Dhuhr");
+  const CacheTrigger *dhuhr_after = first_exact(&st.cache, "Dhuhr");
+  double shift = 0;
+  if (dhuhr_before && dhuhr_after)
+    shift = dhuhr_before->prayer_time - dhuhr_after->prayer_time;
+  check_bool("times recomputed", fabs(shift * 60.0 - 4.0) < 0.1);
+  cache_free(&before);
+  daemon_state_free(&st);
+}
+
+static void test_resume_from_cache(const Config *cfg) {
+  printf("  startup resumes today's cache...\n");
+  config_save(cfg);
+  PrayerCache cache = {0};
+  strcpy(cache.date, "2026-03-23");
+  cache.days = 1;
+  cache_reserve(&cache, 1);
+  cache.trigger_count = 1;
+  strcpy(cache.triggers[0].prayer, "Isha");
+  cache.triggers[0].minute = 1200;
+  cache.triggers[0].prayer_time = 20.0;
+  cache.triggers[0].due = at_minute(24 * 60 + 1200);
+
+  // Built under another config: recomputed
+  cache.config_hash = config_schedule_hash(cfg) ^ 1;
+  cache_save(&cache);
+  DaemonState st;
+  daemon_state_init(&st);
+  st.notify = count_notify;
+  daemon_state_check(&st, at_minute(24 * 60 + 10));
+  check_bool("stale config hash rebuilt", first_exact(&st.cache, "Fajr") != NULL);
+
+  cache.config_hash = config_schedule_hash(cfg);
+  cache_save(&cache);
+  daemon_state_free(&st);
+  daemon_state_init(&st);
+  st.notify = count_notify;
+  daemon_state_check(&st, at_minute(24 * 60 + 10));
+  // Only the added days bring Fajr back
+  const CacheTrigger *fajr = first_exact(&st.cache, "Fajr");
+  check_bool("resumed cached triggers", next_trigger(&st)->minute == 1200 && fajr &&
+                                            fajr->due > at_minute(48 * 60));
+  check_bool("resumed window extended", st.cache.days == CACHE_WINDOW_DAYS);
+  cache_free(&cache);
+  daemon_state_free(&st);
+}
+
+int main(void) {
+  printf("Running check cycle tests...\n");
+
+  if (!mkdtemp(tmpdir)) {
+    fprintf(stderr, "FATAL: mkdtemp failed\n");
+    return 1;
+  }
+  setenv("XDG_CONFIG_HOME", tmpdir, 1);
+  setenv("XDG_CACHE_HOME", tmpdir, 1);
+  setenv("TZ", "UTC", 1);
+  tzset();
+  platform_reset_cached_paths();
+  cache_reset_path();
+
+  // Jakarta, fixed location so no network lookup happens
+  Config cfg = config_default();
+  cfg.latitude = -6.2088;
+  cfg.longitude = 106.8456;
+  cfg.timezone_offset = 7.0;
+  cfg.auto_detect = false;
+  check_bool("config saved", config_save(&cfg) == 0);
+
+  test_resident_state();
+  test_next_wake(&cfg);
+  test_catch_up(&cfg);
+  test_incremental_reload(&cfg);
+  test_resume_from_cache(&cfg);
+
+  char cmd[128];
+  snprintf(cmd, sizeof(cmd), "rm -rf %s", tmpdir);
+  if (system(cmd) != 0) { /* best-effort cleanup */
+  }
+
+  printf("\nResults: %d passed, %d failed\n", passed, failed);
+  return failed > 0 ? 1 : 0;
+}
@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
 // -- test infrastructure -----------------------------------------------------
@@ -531,6 +532,12 @@ static void test_show(void) {
   run(2, (char *[]){"m", "show", NULL});
   check_ret("show explicit ret", 0);
 
+  // show lists reminders in the order they were configured
+  run(4, (char *[]){"m", "reminder", "fajr", "5,60,15", NULL});
+  run(2, (char *[]){"m", "show", NULL});
+  check_contains("show reminders as configured", "5, 60, 15 min before");
+  reset_config();
+
   // show --format json
   run(4, (char *[]){"m", "show", "--format", "json", NULL});
   check_ret("show json ret", 0);
@@ -581,6 +588,36 @@ static void test_next(void) {
   run(3, (char *[]){"m", "next", "remaining", NULL});
   check_ret("next remaining ret", 0);
   check_not_empty("next remaining out");
+
+  // next --follow runs until stdout closes; only its argument errors return
+  run(4, (char *[]){"m", "next", "--format", "json", NULL});
+  check_ret("next format without follow ret", 1);
+  check_contains("next format without follow", "--follow");
+  run(5, (char *[]){"m", "next", "--follow", "--format", "xml", NULL});
+  check_ret("next follow bad format ret", 1);
+  check_contains("next follow bad format", "Unknown format");
+  run(3, (char *[]){"m", "next", "--forever", NULL});
+  check_ret("next unknown option ret", 1);
+
+  // ...and when the status bar goes away it exits cleanly. The pipe has no
+  // reader from the start, so the first line already fails to write.
+  int fds[2];
+  check_bool("follow pipe", pipe(fds) == 0);
+  close(fds[0]);
+  fflush(stdout);
+  fflush(stderr);
+  pid_t pid = fork();
+  if (pid == 0) {
+    alarm(10); // A follow that keeps running fails the test rather than hang it
+    dup2(fds[1], STDOUT_FILENO);
+    close(fds[1]);
+    _exit(cli_run(3, (char *[]){"m", "next", "--follow", NULL}));
+  }
+  close(fds[1]);
+  int status = 0;
+  check_bool("follow exits when stdout closes",
+             pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) &&
+                 WEXITSTATUS(status) == 0);
 }
 
 static void test_check(void) {
@@ -802,6 +839,38 @@ static void test_daemon_errors(void) {
   check_ret("daemon unknown ret", 1);
 }
 
+static void test_export(void) {
+  printf("  export...\n");
+  char csv[600], out[600];
+  snprintf(csv, sizeof(csv), "%s/mosques.csv", tmpdir);
+  snprintf(out, sizeof(out), "%s/timetables.csv", tmpdir);
+  FILE *f = fopen(csv, "w");
+  if (f) {
+    fputs("Istiqlal,-6.1702,106.8310,7,kemenag\n", f);
+    fclose(f);
+  }
+
+  char output_opt[620];
+  snprintf(output_opt, sizeof(output_opt), "--output=%s", out);
+  run(5, (char *[]){"m", "export", csv, "--from=2026-03-01", output_opt, NULL});
+  check_ret("export ret", 0);
+
+  // A bad range is rejected before the previous output is touched
+  run(6, (char *[]){"m", "export", csv, "--from=2026-03-01", "--to=2026-02-01", output_opt, NULL});
+  check_ret("export reversed range ret", 1);
+  check_contains("export reversed range", "invalid date range");
+  struct stat sb;
+  check_bool("export reversed range keeps output", stat(out, &sb) == 0 && sb.st_size > 1000);
+
+  // A bare --output is an error, not a silent switch to stdout
+  run(4, (char *[]){"m", "export", csv, "--output", NULL});
+  check_ret("export missing output ret", 1);
+  check_contains("export missing output", "missing value for --output");
+  run(4, (char *[]){"m", "export", csv, "--threads=", NULL});
+  check_ret("export empty threads ret", 1);
+  check_contains("export empty threads", "missing value for --threads");
+}
+
 // -- main ---------------------------------------------------------------------
 
 int main(void) {
@@ -820,6 +889,7 @@ int main(void) {
   test_method();
   test_sound();
   test_daemon_errors();
+  test_export();
 
   printf("\nResults: %d passed, %d failed\n", passed, failed);
   teardown();
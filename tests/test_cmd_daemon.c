@@ -25,6 +25,8 @@ static void test_build_service_unit(void) {
   report_result("unit is a simple (long-running) service", strstr(unit, "Type=simple") != NULL);
   report_result("unit runs the loop",
                 strstr(unit, "ExecStart=/usr/local/bin/muslimtify daemon run") != NULL);
+  report_result("unit reloads with SIGHUP",
+                strstr(unit, "ExecReload=/bin/kill -HUP $MAINPID") != NULL);
   report_result("unit installs into the user target",
                 strstr(unit, "WantedBy=default.target") != NULL);
   report_result("unit is not a timer", strstr(unit, "OnCalendar") == NULL);
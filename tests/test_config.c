@@ -1,6 +1,8 @@
 #define _GNU_SOURCE
 #include "config.h"
+#include "ephemeris.h"
 #include "platform.h"
+#include "prayertimes.h"
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -86,6 +88,78 @@ static void test_parse_reminders(void) {
   check_bool("parse 1441 rejected", n == 0);
 }
 
+// -- config_diff tests -------------------------------------------------------
+
+static void test_diff(void) {
+  printf("  diff...\n");
+  Config a = config_default();
+  Config b = a;
+  check_bool("diff equal", config_diff(&a, &b) == 0);
+
+  b.latitude += 0.5;
+  check_bool("diff location -> times", config_diff(&a, &b) == CONFIG_DIFF_TIMES);
+  b = a;
+  strcpy(b.madhab, "hanafi");
+  check_bool("diff madhab -> times", config_diff(&a, &b) == CONFIG_DIFF_TIMES);
+
+  b = a;
+  b.asr.reminders[0] = 25;
+  check_bool("diff asr reminder", config_diff(&a, &b) == CONFIG_DIFF_PRAYER(4));
+  b.sunrise.enabled = !a.sunrise.enabled;
+  check_bool("diff two prayers",
+             config_diff(&a, &b) == (CONFIG_DIFF_PRAYER(1) | CONFIG_DIFF_PRAYER(4)));
+
+  b = a;
+  b.fajr.reminders[MAX_REMINDERS - 1] = 99; // beyond reminder_count: ignored
+  check_bool("diff ignores unused reminder slots", config_diff(&a, &b) == 0);
+
+  b = a;
+  strcpy(b.notification_urgency, "low");
+  b.notification_catchup = 1;
+  check_bool("diff notification -> other", config_diff(&a, &b) == CONFIG_DIFF_OTHER);
+}
+
+static void test_schedule_hash(void) {
+  printf("  schedule hash...\n");
+  Config a = config_default();
+  Config b = a;
+  check_bool("hash deterministic", config_schedule_hash(&a) == config_schedule_hash(&b));
+
+  b.latitude += 1e-6;
+  check_bool("hash covers location", config_schedule_hash(&a) != config_schedule_hash(&b));
+  b = a;
+  b.isha.reminder_count--;
+  check_bool("hash covers reminders", config_schedule_hash(&a) != config_schedule_hash(&b));
+  b = a;
+  b.dhuha.enabled = !a.dhuha.enabled;
+  check_bool("hash covers enabled", config_schedule_hash(&a) != config_schedule_hash(&b));
+  b = a;
+  strcpy(b.madhab, "hanafi");
+  check_bool("hash covers madhab", config_schedule_hash(&a) != config_schedule_hash(&b));
+
+  b = a;
+  b.notification_timeout = 1;
+  strcpy(b.city, "Elsewhere");
+  b.fajr.reminders[MAX_REMINDERS - 1] = 99;
+  check_bool("hash ignores display fields", config_schedule_hash(&a) == config_schedule_hash(&b));
+
+  // The installed sun table moves every time, so it is part of the schedule
+  char table[512];
+  snprintf(table, sizeof(table), "%s/sun_ephemeris.bin", tmpdir);
+  uint64_t analytic = config_schedule_hash(&a);
+  check_bool("table written",
+             ephemeris_write(table, 2020, 2030, sun_position_analytic, "analytic") == 0);
+  check_bool("table installed", ephemeris_install(table) == 0);
+  uint64_t first = config_schedule_hash(&a);
+  check_bool("hash covers sun table", first != analytic);
+  check_bool("table rewritten",
+             ephemeris_write(table, 2020, 2031, sun_position_analytic, "analytic") == 0);
+  check_bool("table reinstalled", ephemeris_install(table) == 0);
+  check_bool("hash covers replaced table", config_schedule_hash(&a) != first);
+  ephemeris_uninstall();
+  check_bool("hash back to analytic", config_schedule_hash(&a) == analytic);
+}
+
 // -- config_validate tests ---------------------------------------------------
 
 static void test_validate(void) {
@@ -131,6 +205,15 @@ static void test_validate(void) {
   cfg.timezone_offset = -12.1;
   check_bool("validate tz=-12.1 invalid", !config_validate(&cfg));
 
+  // Catch-up window
+  cfg = config_default();
+  cfg.notification_catchup = 0;
+  check_bool("validate catchup=0", config_validate(&cfg));
+  cfg.notification_catchup = -1;
+  check_bool("validate catchup=-1 invalid", !config_validate(&cfg));
+  cfg.notification_catchup = 1441;
+  check_bool("validate catchup=1441 invalid", !config_validate(&cfg));
+
   // Bad reminder count
   cfg = config_default();
   cfg.fajr.reminder_count = MAX_REMINDERS + 1;
@@ -255,6 +338,7 @@ static void test_round_trip(void) {
   out.fajr.reminders[1] = 10;
   out.sunrise.enabled = true;
   out.notification_timeout = 8000;
+  out.notification_catchup = 3;
   out.notification_sound = false;
   strncpy(out.notification_sound_alarm, "default", sizeof(out.notification_sound_alarm) - 1);
   strncpy(out.notification_sound_reminder, "alarm", sizeof(out.notification_sound_reminder) - 1);
@@ -281,6 +365,7 @@ static void test_round_trip(void) {
                                       in.fajr.reminders[1] == 10);
   check_bool("rt sunrise enabled", in.sunrise.enabled == true);
   check_bool("rt timeout", in.notification_timeout == 8000);
+  check_bool("rt catchup", in.notification_catchup == 3);
   check_bool("rt sound", in.notification_sound == false);
   check_bool("rt sound_alarm", strcmp(in.notification_sound_alarm, "default") == 0);
   check_bool("rt sound_reminder", strcmp(in.notification_sound_reminder, "alarm") == 0);
@@ -297,6 +382,8 @@ int main(void) {
   printf("Running config tests...\n");
   test_parse_reminders();
   test_validate();
+  test_diff();
+  test_schedule_hash();
   test_get_prayer();
   test_format_reminders();
   test_default();
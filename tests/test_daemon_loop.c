@@ -1,7 +1,11 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "daemon_loop.h"
 
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
 
 static int total = 0;
 static int failures = 0;
@@ -25,9 +29,52 @@ static void test_seconds_until_next_minute(void) {
                                                        seconds_until_next_minute(1719500000) <= 60);
 }
 
+static void test_wake_counter(void) {
+  const time_t day0 = 1774137600; /* 2026-03-22 00:00 UTC */
+  WakeCounter c = {0};
+  int day = 0;
+  unsigned count = 0;
+
+  report_result("first wake-up does not roll over", wake_counter_tick(&c, day0, &day, &count) == 0);
+  wake_counter_tick(&c, day0 + 4 * 3600, &day, &count);
+  report_result("same day keeps counting",
+                wake_counter_tick(&c, day0 + 86399, &day, &count) == 0 && c.count == 3);
+  report_result("next day rolls over", wake_counter_tick(&c, day0 + 86400, &day, &count) == 1);
+  report_result("finished day reported", day == 20260322 && count == 3);
+  report_result("new day starts at one", c.day == 20260323 && c.count == 1);
+}
+
+static void test_clock_discontinuity(void) {
+  long long stepped, suspended;
+  ClockSample a = {1000, 500, 400};
+
+  ClockSample idle = {1060, 560, 460};
+  clock_discontinuity(&a, &idle, &stepped, &suspended);
+  report_result("plain sleep: no step, no suspend", stepped == 0 && suspended == 0);
+
+  ClockSample resumed = {4600, 4100, 460};
+  clock_discontinuity(&a, &resumed, &stepped, &suspended);
+  report_result("suspend: wall clock follows boottime", stepped == 0 && suspended == 3540);
+
+  ClockSample back = {700, 560, 460};
+  clock_discontinuity(&a, &back, &stepped, &suspended);
+  report_result("backward step is negative", stepped == -360 && suspended == 0);
+
+  ClockSample forward = {1960, 560, 460};
+  clock_discontinuity(&a, &forward, &stepped, &suspended);
+  report_result("forward step is positive", stepped == 900 && suspended == 0);
+}
+
 int main(void) {
+  setenv("TZ", "UTC", 1);
+  tzset();
+
   printf("test_seconds_until_next_minute\n");
   test_seconds_until_next_minute();
+  printf("test_wake_counter\n");
+  test_wake_counter();
+  printf("test_clock_discontinuity\n");
+  test_clock_discontinuity();
   if (failures == 0) {
     printf("All %d tests passed.\n", total);
     return 0;
@@ -0,0 +1,163 @@
+#define PRAYERTIMES_IMPLEMENTATION
+#include "ephemeris.h"
+#include "platform.h"
+#include "prayertimes.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+static int passed = 0;
+static int failed = 0;
+
+static void check_bool(const char *test, bool cond) {
+  if (cond) {
+    passed++;
+  } else {
+    failed++;
+    fprintf(stderr, "FAIL [%s]\n", test);
+  }
+}
+
+#define TABLE_PATH "test_ephemeris.bin"
+#define BAD_PATH "test_ephemeris_bad.bin"
+
+// Interpolation between daily samples: 1 ms of time is far below the minute
+// resolution that reaches the user
+#define MAX_INTERP_DECL_DEG 1e-6
+#define MAX_INTERP_EQT_HOURS (0.001 / 3600.0)
+
+static void test_write_and_open(void) {
+  printf("  write 2020-2030 and open...\n");
+  check_bool("write", ephemeris_write(TABLE_PATH, 2020, 2030, sun_position_analytic,
+                                      "analytic") == 0);
+
+  EphemerisTable t;
+  check_bool("open", ephemeris_open(&t, TABLE_PATH) == 0);
+  if (!t.map)
+    return;
+  check_bool("one record per day", t.header->count == 4018);
+  check_bool("starts on 2020-01-01", t.header->first_jd == 2458849.5 &&
+                                         t.header->first_jd == julian_day_for_date(2020, 1, 1));
+  check_bool("source recorded", strcmp(t.header->source, "analytic") == 0);
+  ephemeris_close(&t);
+  check_bool("closed", t.map == NULL);
+}
+
+static void test_lookup(void) {
+  printf("  lookup vs analytic model...\n");
+  EphemerisTable t;
+  if (ephemeris_open(&t, TABLE_PATH) != 0) {
+    check_bool("open", false);
+    return;
+  }
+
+  bool exact = true;
+  double max_decl = 0.0, max_eqt = 0.0;
+  for (uint32_t i = 0; i < t.header->count; i++) {
+    double jd = t.header->first_jd + i, d, e, ad, ae;
+    exact = exact && ephemeris_lookup(&t, jd, &d, &e);
+    sun_position_analytic(jd, &ad, &ae);
+    exact = exact && d == ad && e == ae;
+
+    // Quarter days, including the first and last interval
+    for (int q = 1; q < 4 && i + 1 < t.header->count; q++) {
+      if (!ephemeris_lookup(&t, jd + q * 0.25, &d, &e))
+        continue;
+      sun_position_analytic(jd + q * 0.25, &ad, &ae);
+      max_decl = fmax(max_decl, fabs(d - ad));
+      max_eqt = fmax(max_eqt, fabs(e - ae));
+    }
+  }
+  printf("    interpolation error: declination %.3g deg, equation of time %.3g s\n", max_decl,
+         max_eqt * 3600.0);
+  check_bool("whole days identical", exact);
+  check_bool("interpolated declination", max_decl <= MAX_INTERP_DECL_DEG);
+  check_bool("interpolated equation of time", max_eqt <= MAX_INTERP_EQT_HOURS);
+
+  double d, e;
+  check_bool("before table", !ephemeris_lookup(&t, t.header->first_jd - 0.5, &d, &e));
+  check_bool("after table",
+             !ephemeris_lookup(&t, t.header->first_jd + t.header->count, &d, &e));
+  check_bool("NaN", !ephemeris_lookup(&t, NAN, &d, &e));
+  ephemeris_close(&t);
+}
+
+static bool same_times(const struct PrayerTimes *a, const struct PrayerTimes *b) {
+  return a->fajr == b->fajr && a->sunrise == b->sunrise && a->dhuha == b->dhuha &&
+         a->dhuhr == b->dhuhr && a->asr == b->asr && a->maghrib == b->maghrib &&
+         a->isha == b->isha;
+}
+
+static void test_install(void) {
+  printf("  installed table gives identical prayer times...\n");
+  const MethodParams *p = method_params_get(CALC_KEMENAG);
+  struct PrayerTimes in_range = calculate_prayer_times(2026, 1, 15, -6.1667, 106.8167, 7.0, p);
+  struct PrayerTimes out_range = calculate_prayer_times(2040, 6, 1, 51.5074, -0.1278, 1.0, p);
+
+  check_bool("install", ephemeris_install(TABLE_PATH) == 0);
+  struct PrayerTimes a = calculate_prayer_times(2026, 1, 15, -6.1667, 106.8167, 7.0, p);
+  struct PrayerTimes b = calculate_prayer_times(2040, 6, 1, 51.5074, -0.1278, 1.0, p);
+  check_bool("in range identical", same_times(&a, &in_range));
+  check_bool("out of range falls back", same_times(&b, &out_range));
+
+  ephemeris_uninstall();
+  a = calculate_prayer_times(2026, 1, 15, -6.1667, 106.8167, 7.0, p);
+  check_bool("uninstall restores analytic", same_times(&a, &in_range));
+}
+
+static bool write_bad_copy(size_t keep, size_t flip) {
+  FILE *in = fopen(TABLE_PATH, "rb");
+  FILE *out = fopen(BAD_PATH, "wb");
+  bool ok = in && out;
+  for (size_t i = 0; ok && i < keep; i++) {
+    int c = fgetc(in);
+    if (c == EOF)
+      break;
+    fputc(i == flip ? c ^ 0xff : c, out);
+  }
+  if (in)
+    fclose(in);
+  if (out)
+    fclose(out);
+  return ok;
+}
+
+static void test_rejects_invalid(void) {
+  printf("  missing, truncated and corrupt tables are rejected...\n");
+  EphemerisTable t;
+  check_bool("missing file", ephemeris_open(&t, "does_not_exist.bin") != 0);
+  check_bool("missing install", ephemeris_install("does_not_exist.bin") != 0);
+
+  size_t full = sizeof(EphemerisHeader) + 4018 * 2 * sizeof(double);
+  check_bool("truncated copy", write_bad_copy(full - 8, (size_t)-1));
+  check_bool("truncated", ephemeris_open(&t, BAD_PATH) != 0);
+  check_bool("header only copy", write_bad_copy(20, (size_t)-1));
+  check_bool("header only", ephemeris_open(&t, BAD_PATH) != 0);
+  check_bool("bad magic copy", write_bad_copy(full, 0));
+  check_bool("bad magic", ephemeris_open(&t, BAD_PATH) != 0);
+  check_bool("bad byte order copy", write_bad_copy(full, 12));
+  check_bool("bad byte order", ephemeris_open(&t, BAD_PATH) != 0);
+  check_bool("intact copy", write_bad_copy(full, (size_t)-1));
+  check_bool("intact copy opens", ephemeris_open(&t, BAD_PATH) == 0);
+  ephemeris_close(&t);
+
+  check_bool("bad year range", ephemeris_write(BAD_PATH, 2030, 2020, sun_position_analytic,
+                                               "analytic") != 0);
+}
+
+int main(void) {
+  printf("Running ephemeris table tests...\n");
+
+  test_write_and_open();
+  test_lookup();
+  test_install();
+  test_rejects_invalid();
+
+  platform_file_delete(TABLE_PATH);
+  platform_file_delete(BAD_PATH);
+
+  printf("\nResults: %d passed, %d failed\n", passed, failed);
+  return failed > 0 ? 1 : 0;
+}
@@ -65,6 +65,12 @@ static void test_platform_time_helpers(void) {
   int second_tty = platform_isatty(stdout);
   report_result("platform_isatty(stdout) is stable",
                 first_tty == second_tty && (first_tty == 0 || first_tty == 1));
+
+  time_t before = time(NULL);
+  platform_sleep_until(before - 10);
+  report_result("platform_sleep_until() past deadline returns at once", time(NULL) - before <= 1);
+  platform_sleep_until(before + 1);
+  report_result("platform_sleep_until() reaches the deadline", time(NULL) >= before + 1);
 }
 
 static void test_platform_boundary(void) {
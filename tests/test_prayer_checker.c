@@ -164,6 +164,186 @@ static void test_all_disabled(void) {
   check_bool("all disabled none", m.type == PRAYER_NONE);
 }
 
+static void test_caller_owned_cache(void) {
+  printf("  caller-owned cache...\n");
+  Config cfg = test_config();
+  Config muted = cfg;
+  muted.dhuhr.enabled = false;
+  struct PrayerTimes times = jakarta_times();
+  struct tm now = make_time(12, 4);
+
+  // Two caches alternating between configs each keep their own schedule
+  PrayerCheckCache a, b;
+  memset(&a, 0, sizeof(a));
+  memset(&b, 0, sizeof(b));
+  bool right = true;
+  for (int i = 0; i < 3; i++) {
+    right = right && prayer_check_cached(&a, &cfg, &now, &times).type == PRAYER_DHUHR;
+    right = right && prayer_check_cached(&b, &muted, &now, &times).type == PRAYER_NONE;
+  }
+  check_bool("separate caches", right);
+  check_bool("cache compiled", a.valid && b.valid && prayer_map_due(&a.map, 12 * 60 + 4) &&
+                                   !prayer_map_due(&b.map, 12 * 60 + 4));
+
+  // A reloaded config recompiles the same cache
+  PrayerMatch m = prayer_check_cached(&a, &muted, &now, &times);
+  check_bool("recompiled on change", m.type == PRAYER_NONE);
+}
+
+// -- SchedulePlan tests ------------------------------------------------------
+
+static void test_schedule_plan(void) {
+  printf("  schedule plan...\n");
+  Config cfg = test_config();
+  cfg.asr.reminder_count = 4;
+  cfg.asr.reminders[0] = 5;
+  cfg.asr.reminders[1] = 60;
+  cfg.asr.reminders[2] = 15;
+  cfg.asr.reminders[3] = 30;
+  SchedulePlan plan;
+  schedule_plan_build(&plan, &cfg);
+
+  // Defaults: sunrise and dhuha off
+  unsigned expected = (1u << PRAYER_FAJR) | (1u << PRAYER_DHUHR) | (1u << PRAYER_ASR) |
+                      (1u << PRAYER_MAGHRIB) | (1u << PRAYER_ISHA);
+  check_bool("enabled bitmask", plan.enabled == expected);
+  check_bool("enabled lookup", schedule_plan_enabled(&plan, PRAYER_FAJR) &&
+                                   !schedule_plan_enabled(&plan, PRAYER_SUNRISE) &&
+                                   !schedule_plan_enabled(&plan, PRAYER_NONE));
+
+  const int *r = NULL;
+  int n = schedule_plan_reminders(&plan, PRAYER_ASR, &r);
+  check_bool("reminders sorted earliest first",
+             n == 4 && r[0] == 60 && r[1] == 30 && r[2] == 15 && r[3] == 5);
+  check_bool("no reminders for sunrise", schedule_plan_reminders(&plan, PRAYER_SUNRISE, &r) == 0);
+  check_bool("reminders packed", plan.reminder_first[PRAYER_NONE] == 3 + 3 + 4 + 3 + 3);
+
+  // Same reminders in another order compile to the same plan
+  Config shuffled = cfg;
+  shuffled.asr.reminders[0] = 30;
+  shuffled.asr.reminders[3] = 5;
+  SchedulePlan other;
+  schedule_plan_build(&other, &shuffled);
+  check_bool("plan independent of reminder order", memcmp(&plan, &other, sizeof(plan)) == 0);
+
+  struct PrayerTimes times = jakarta_times();
+  double t[PRAYER_NONE];
+  prayer_times_unpack(&times, t);
+  check_bool("times unpacked by type", t[PRAYER_FAJR] == times.fajr &&
+                                           t[PRAYER_DHUHA] == times.dhuha &&
+                                           t[PRAYER_ISHA] == times.isha);
+
+  bool same_next = true;
+  for (int m = 0; m < MINUTES_PER_DAY; m += 7) {
+    struct tm now = make_time(m / 60, m % 60);
+    int a = -1, b = -1;
+    PrayerType from_cfg = prayer_get_next(&cfg, &now, &times, &a);
+    PrayerType from_plan = prayer_plan_next(&plan, t, &now, &b);
+    same_next = same_next && from_cfg == from_plan && a == b;
+  }
+  check_bool("plan next matches get_next", same_next);
+}
+
+// -- MinuteMap tests ---------------------------------------------------------
+
+static void test_map_bits(void) {
+  printf("  minute map bits and next...\n");
+  Config cfg = test_config();
+  struct PrayerTimes times = jakarta_times();
+  SchedulePlan plan;
+  schedule_plan_build(&plan, &cfg);
+  MinuteMap map;
+  prayer_map_build(&map, &plan, &times);
+
+  // Defaults: five prayers with reminders at 30, 15 and 5 minutes
+  int set = 0;
+  for (int m = 0; m < MINUTES_PER_DAY; m++)
+    set += prayer_map_due(&map, m);
+  check_bool("bitmap is 180 bytes", sizeof(map.bits) == 180);
+  check_bool("one bit per trigger minute", set == 20 && map.first[set] == 20);
+  check_bool("fajr minute set", prayer_map_due(&map, 4 * 60 + 26));
+  check_bool("quiet minute clear", !prayer_map_due(&map, 10 * 60));
+  check_bool("out of range clear", !prayer_map_due(&map, -1) && !prayer_map_due(&map, 1440));
+
+  check_bool("next from midnight is fajr - 30", prayer_map_next(&map, 0) == 4 * 60 - 4);
+  check_bool("next from a set minute is itself", prayer_map_next(&map, 12 * 60 + 4) == 724);
+  check_bool("next skips empty words", prayer_map_next(&map, 12 * 60 + 5) == 15 * 60 - 1);
+  check_bool("nothing after isha", prayer_map_next(&map, 19 * 60 + 33) == -1);
+
+  const MinuteTrigger *t = NULL;
+  check_bool("lookup quiet minute", prayer_map_lookup(&map, 600, &t) == 0);
+  check_bool("lookup dhuhr - 15", prayer_map_lookup(&map, 12 * 60 - 11, &t) == 1 &&
+                                      t->type == PRAYER_DHUHR && t->minutes_before == 15);
+}
+
+static void test_map_shared_minute(void) {
+  printf("  minute map shared minute...\n");
+  Config cfg = test_config();
+  struct PrayerTimes times = jakarta_times();
+  // Asr - 205 lands on Dhuhr (12:04), after Dhuhr itself in check order
+  cfg.asr.reminders[0] = 205;
+  SchedulePlan plan;
+  schedule_plan_build(&plan, &cfg);
+  MinuteMap map;
+  prayer_map_build(&map, &plan, &times);
+
+  const MinuteTrigger *t = NULL;
+  int n = prayer_map_lookup(&map, 724, &t);
+  check_bool("both triggers indexed", n == 2);
+  check_bool("check order kept", n == 2 && t[0].type == PRAYER_DHUHR &&
+                                     t[0].minutes_before == 0 && t[1].type == PRAYER_ASR &&
+                                     t[1].minutes_before == 205);
+  PrayerMatch m = prayer_map_check(&map, 724);
+  check_bool("map check returns first", m.type == PRAYER_DHUHR && m.minutes_before == 0 &&
+                                            fabs(m.prayer_time - times.dhuhr) < 1e-9);
+}
+
+// Reference for prayer_check_current: the per-call scan it replaced
+static PrayerMatch scan_match(const Config *cfg, const struct PrayerTimes *times, int minute) {
+  PrayerMatch none = {.type = PRAYER_NONE, .minutes_before = -1, .prayer_time = 0.0};
+  for (int i = 0; i < PRAYER_NONE; i++) {
+    if (!prayer_is_enabled(cfg, (PrayerType)i))
+      continue;
+    double t = prayer_get_time(times, (PrayerType)i);
+    int prayer_min = (int)ceil(t * 60.0);
+    if (prayer_min == minute)
+      return (PrayerMatch){.type = (PrayerType)i, .minutes_before = 0, .prayer_time = t};
+    const PrayerConfig *pcfg = prayer_get_config(cfg, (PrayerType)i);
+    for (int j = 0; j < pcfg->reminder_count; j++) {
+      int m = prayer_min - pcfg->reminders[j];
+      if (m < 0)
+        m += 24 * 60;
+      if (m == minute)
+        return (PrayerMatch){
+            .type = (PrayerType)i, .minutes_before = pcfg->reminders[j], .prayer_time = t};
+    }
+  }
+  return none;
+}
+
+static void test_map_matches_scan(void) {
+  printf("  minute map matches the scan...\n");
+  Config cfg = test_config();
+  cfg.sunrise.enabled = true;
+  cfg.fajr.reminder_count = MAX_REMINDERS;
+  for (int j = 0; j < MAX_REMINDERS; j++)
+    cfg.fajr.reminders[j] = 60 * j + 7; // Several wrap past midnight
+  struct PrayerTimes times = jakarta_times();
+  SchedulePlan plan;
+  schedule_plan_build(&plan, &cfg);
+  MinuteMap map;
+  prayer_map_build(&map, &plan, &times);
+
+  bool same = true;
+  for (int m = 0; m < MINUTES_PER_DAY; m++) {
+    PrayerMatch a = prayer_map_check(&map, m);
+    PrayerMatch b = scan_match(&cfg, &times, m);
+    same = same && a.type == b.type && a.minutes_before == b.minutes_before &&
+           a.prayer_time == b.prayer_time;
+  }
+  check_bool("every minute agrees", same);
+}
+
 // -- prayer_get_next tests ---------------------------------------------------
 
 static void test_next_upcoming(void) {
@@ -270,6 +450,11 @@ int main(void) {
   test_disabled_skipped();
   test_midnight_crossover();
   test_all_disabled();
+  test_caller_owned_cache();
+  test_schedule_plan();
+  test_map_bits();
+  test_map_shared_minute();
+  test_map_matches_scan();
   test_next_upcoming();
   test_next_wraps_to_tomorrow();
   test_next_all_disabled();
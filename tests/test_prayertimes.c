@@ -4,6 +4,7 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 static const MethodParams *kemenag_params;
 
@@ -1672,6 +1673,270 @@ static void test_egypt_alexandria_dec(void) {
   printf("\n");
 }
 
+// =============================================================================
+// Batch date-range API: must agree exactly with the single-day entry point
+// =============================================================================
+
+static void check_same_times(const struct PrayerTimes *a, const struct PrayerTimes *b,
+                             const char *label) {
+  total++;
+  double diff = fabs(a->fajr - b->fajr) + fabs(a->sunrise - b->sunrise) +
+                fabs(a->dhuha - b->dhuha) + fabs(a->dhuhr - b->dhuhr) + fabs(a->asr - b->asr) +
+                fabs(a->maghrib - b->maghrib) + fabs(a->isha - b->isha);
+  if (diff < 1e-9) {
+    printf("  PASS  %s\n", label);
+  } else {
+    printf("  FAIL  %s  (sum of differences=%.3g h)\n", label, diff);
+    failures++;
+  }
+}
+
+static void test_range_matches_single_day(void) {
+  printf("Test Range 01: Jakarta — 400 days from 2024-02-25 (leap day + year end)\n");
+  enum { N = 400 };
+  static struct PrayerTimes out[N];
+  int n = calculate_prayer_times_range(2024, 2, 25, N, -6.1667, 106.8167, 7.0, NULL, NULL,
+                                       kemenag_params, out);
+  total++;
+  if (n == N) {
+    printf("  PASS  returned %d days\n", n);
+  } else {
+    printf("  FAIL  returned %d days, expected %d\n", n, N);
+    failures++;
+  }
+
+  // Walk the calendar independently with mktime-free arithmetic
+  int y = 2024, m = 2, d = 25;
+  static const int dim[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  int mismatches = 0;
+  for (int i = 0; i < N; i++) {
+    struct PrayerTimes t =
+        calculate_prayer_times(y, m, d, -6.1667, 106.8167, 7.0, kemenag_params);
+    if (memcmp(&t, &out[i], sizeof(t)) != 0)
+      mismatches++;
+    int days = dim[m - 1] + (m == 2 && y % 4 == 0 && (y % 100 != 0 || y % 400 == 0));
+    if (++d > days) {
+      d = 1;
+      if (++m > 12) {
+        m = 1;
+        y++;
+      }
+    }
+  }
+  total++;
+  if (mismatches == 0) {
+    printf("  PASS  every day identical to calculate_prayer_times\n");
+  } else {
+    printf("  FAIL  %d day(s) differ from calculate_prayer_times\n", mismatches);
+    failures++;
+  }
+  printf("\n");
+}
+
+// Egypt observes DST from the last Friday of April to the last Thursday of
+// October; approximate with whole months for the test.
+static double cairo_tz(int year, int month, int day, void *user) {
+  (void)year;
+  (void)day;
+  int *calls = (int *)user;
+  (*calls)++;
+  return (month >= 5 && month <= 10) ? 3.0 : 2.0;
+}
+
+static void test_range_tz_callback(void) {
+  printf("Test Range 02: Cairo — per-day timezone callback across DST months\n");
+  const MethodParams *p = method_params_get(CALC_EGYPT);
+  struct PrayerTimes out[62];
+  int calls = 0;
+  calculate_prayer_times_range(2026, 4, 1, 62, 30.0444, 31.2357, 0.0, cairo_tz, &calls, p, out);
+
+  total++;
+  if (calls == 62) {
+    printf("  PASS  tz callback invoked once per day\n");
+  } else {
+    printf("  FAIL  tz callback invoked %d times, expected 62\n", calls);
+    failures++;
+  }
+
+  struct PrayerTimes apr30 = calculate_prayer_times(2026, 4, 30, 30.0444, 31.2357, 2.0, p);
+  struct PrayerTimes may1 = calculate_prayer_times(2026, 5, 1, 30.0444, 31.2357, 3.0, p);
+  check_same_times(&out[29], &apr30, "2026-04-30 uses UTC+2");
+  check_same_times(&out[30], &may1, "2026-05-01 uses UTC+3");
+  printf("\n");
+}
+
+static void test_range_invalid_args(void) {
+  printf("Test Range 03: invalid arguments\n");
+  struct PrayerTimes out[1];
+  total++;
+  if (calculate_prayer_times_range(2026, 1, 1, 0, 0, 0, 0, NULL, NULL, kemenag_params, out) == 0 &&
+      calculate_prayer_times_range(2026, 13, 1, 1, 0, 0, 0, NULL, NULL, kemenag_params, out) ==
+          0 &&
+      calculate_prayer_times_range(2026, 1, 1, 1, 0, 0, 0, NULL, NULL, NULL, out) == 0 &&
+      calculate_prayer_times_range(2026, 2, 31, 1, 0, 0, 0, NULL, NULL, kemenag_params, out) ==
+          0 &&
+      calculate_prayer_times_range(2026, 2, 29, 1, 0, 0, 0, NULL, NULL, kemenag_params, out) ==
+          0 &&
+      calculate_prayer_times_range(2026, 4, 31, 1, 0, 0, 0, NULL, NULL, kemenag_params, out) ==
+          0 &&
+      calculate_prayer_times_range(2024, 2, 29, 1, 0, 0, 0, NULL, NULL, kemenag_params, out) ==
+          1) {
+    printf("  PASS  rejected, including dates that do not exist\n");
+  } else {
+    printf("  FAIL  accepted invalid arguments\n");
+    failures++;
+  }
+  printf("\n");
+}
+
+// =============================================================================
+// Two-stage API: one SunState shared by many locations and methods
+// =============================================================================
+
+static void test_sun_state_shared_across_sites(void) {
+  printf("Test SunState 01: one SunState for a latitude/longitude grid, every method\n");
+  SunState sun = sun_state_for_date(2026, 3, 20);
+  int mismatches = 0;
+  int checked = 0;
+  for (int m = 0; m < CALC_COUNT; m++) {
+    const MethodParams *p = method_params_get((CalcMethod)m);
+    for (double lat = -60.0; lat <= 60.0; lat += 7.5) {
+      for (double lon = -180.0; lon < 180.0; lon += 45.0) {
+        double tz = floor(lon / 15.0 + 0.5);
+        struct PrayerTimes a = prayer_times_from_sun_state(&sun, lat, lon, tz, p);
+        struct PrayerTimes b = calculate_prayer_times(2026, 3, 20, lat, lon, tz, p);
+        if (memcmp(&a, &b, sizeof(a)) != 0)
+          mismatches++;
+        checked++;
+      }
+    }
+  }
+  total++;
+  if (mismatches == 0) {
+    printf("  PASS  %d site/method combinations identical to calculate_prayer_times\n", checked);
+  } else {
+    printf("  FAIL  %d of %d combinations differ\n", mismatches, checked);
+    failures++;
+  }
+  printf("\n");
+}
+
+static void test_sun_state_values(void) {
+  printf("Test SunState 02: equinox and solstice declination\n");
+  SunState equinox = sun_state_for_date(2026, 3, 20);
+  SunState solstice = sun_state_for_date(2026, 6, 21);
+  total++;
+  if (fabs(equinox.declination) < 0.5 && fabs(solstice.declination - 23.44) < 0.1 &&
+      fabs(equinox.sin_decl - sin(equinox.declination * DEG_TO_RAD)) < 1e-15) {
+    printf("  PASS  decl(equinox)=%.3f decl(solstice)=%.3f\n", equinox.declination,
+           solstice.declination);
+  } else {
+    printf("  FAIL  decl(equinox)=%.3f decl(solstice)=%.3f\n", equinox.declination,
+           solstice.declination);
+    failures++;
+  }
+  printf("\n");
+}
+
+static void test_location_ctx_reuse(void) {
+  printf("Test SunState 03: one PrayerLocationCtx reused for a year of SunStates\n");
+  const MethodParams *p = method_params_get(CALC_MWL);
+  PrayerLocationCtx ctx;
+  prayer_location_ctx_init(&ctx, 51.5074, -0.1278, 0.0, p);
+  int mismatches = 0;
+  for (int m = 1; m <= 12; m++) {
+    for (int d = 1; d <= 28; d++) {
+      SunState sun = sun_state_for_date(2026, m, d);
+      struct PrayerTimes a = prayer_times_from_ctx(&sun, &ctx);
+      struct PrayerTimes b = calculate_prayer_times(2026, m, d, 51.5074, -0.1278, 0.0, p);
+      if (memcmp(&a, &b, sizeof(a)) != 0)
+        mismatches++;
+    }
+  }
+  total++;
+  if (mismatches == 0) {
+    printf("  PASS  London (high-latitude fallback in summer) identical to single-day path\n");
+  } else {
+    printf("  FAIL  %d day(s) differ\n", mismatches);
+    failures++;
+  }
+  printf("\n");
+}
+
+// =============================================================================
+// Per-method kernels: compiled-in constants must match the generic path
+// =============================================================================
+
+// Same event time, or both NaN (polar day/night); 1e-9 h absorbs a last-bit
+// difference between a compile-time and a run-time sin()
+static int same_event(double a, double b) {
+  if (isnan(a) || isnan(b))
+    return isnan(a) && isnan(b);
+  return fabs(a - b) <= 1e-9;
+}
+
+static void test_kernels_match_generic(void) {
+  printf("Test Kernel 01: every catalogue kernel vs the generic kernel, both madhabs\n");
+  int mismatches = 0;
+  int checked = 0;
+  for (int m = 0; m < CALC_CUSTOM; m++) {
+    PrayerKernelFn kernel = prayer_kernel_get((CalcMethod)m);
+    for (int shadow = ASR_STANDARD; shadow <= ASR_HANAFI; shadow++) {
+      MethodParams p = *method_params_get((CalcMethod)m);
+      p.asr_shadow = shadow;
+      for (int month = 1; month <= 12; month += 3) {
+        SunState sun = sun_state_for_date(2026, month, 21);
+        for (double lat = -66.0; lat <= 66.0; lat += 11.0) {
+          PrayerLocationCtx ctx;
+          prayer_location_ctx_init(&ctx, lat, 100.0, 7.0, &p);
+          struct PrayerTimes a = kernel(&sun, &ctx);
+          struct PrayerTimes b = prayer_times_generic(&sun, &ctx);
+          if (!same_event(a.fajr, b.fajr) || !same_event(a.sunrise, b.sunrise) ||
+              !same_event(a.dhuha, b.dhuha) || !same_event(a.dhuhr, b.dhuhr) ||
+              !same_event(a.asr, b.asr) || !same_event(a.maghrib, b.maghrib) ||
+              !same_event(a.isha, b.isha))
+            mismatches++;
+          checked++;
+        }
+      }
+    }
+  }
+  total++;
+  if (mismatches == 0) {
+    printf("  PASS  %d method/site/date combinations agree\n", checked);
+  } else {
+    printf("  FAIL  %d of %d combinations differ\n", mismatches, checked);
+    failures++;
+  }
+  printf("\n");
+}
+
+static void test_kernel_selection(void) {
+  printf("Test Kernel 02: prayer_location_ctx_init picks the specialized kernel\n");
+  PrayerLocationCtx ctx;
+
+  MethodParams hanafi = *kemenag_params;
+  hanafi.asr_shadow = ASR_HANAFI;
+  prayer_location_ctx_init(&ctx, -6.1667, 106.8167, 7.0, &hanafi);
+  int kemenag_ok = ctx.kernel == prayer_kernel_get(CALC_KEMENAG);
+
+  MethodParams custom = *method_params_get(CALC_CUSTOM);
+  custom.fajr_angle = 19.25;
+  prayer_location_ctx_init(&ctx, -6.1667, 106.8167, 7.0, &custom);
+  int custom_ok = ctx.kernel == prayer_times_generic &&
+                  prayer_kernel_get(CALC_CUSTOM) == prayer_times_generic &&
+                  prayer_kernel_get(CALC_COUNT) == prayer_times_generic;
+
+  total++;
+  if (kemenag_ok && custom_ok) {
+    printf("  PASS  Kemenag (Hanafi) -> Kemenag kernel, custom angles -> generic\n");
+  } else {
+    printf("  FAIL  kemenag_ok=%d custom_ok=%d\n", kemenag_ok, custom_ok);
+    failures++;
+  }
+  printf("\n");
+}
+
 int main(void) {
   printf("=== prayertimes.h unit tests ===\n");
   printf("=== Reference: jadwalsholat.org (Kemenag method) ===\n");
@@ -1860,6 +2125,23 @@ int main(void) {
   test_egypt_alexandria_sep();
   test_egypt_alexandria_dec();
 
+  // Batch date-range API
+  printf("--- Date-range API ---\n\n");
+  test_range_matches_single_day();
+  test_range_tz_callback();
+  test_range_invalid_args();
+
+  // Two-stage SunState API
+  printf("--- SunState API ---\n\n");
+  test_sun_state_shared_across_sites();
+  test_sun_state_values();
+  test_location_ctx_reuse();
+
+  // Per-method kernels
+  printf("--- Per-method kernels ---\n\n");
+  test_kernels_match_generic();
+  test_kernel_selection();
+
   printf("=== Summary ===\n");
   printf("Total checks: %d\n", total);
   if (failures == 0) {
@@ -0,0 +1,166 @@
+#define PRAYERTIMES_IMPLEMENTATION
+#include "prayertimes_fast_trig.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int passed = 0;
+static int failed = 0;
+
+static void check_bool(const char *test, bool cond) {
+  if (cond) {
+    passed++;
+  } else {
+    failed++;
+    fprintf(stderr, "FAIL [%s]\n", test);
+  }
+}
+
+// Documented bounds (prayertimes.h, PRAYERTIMES_FAST_TRIG)
+#define MAX_TRIG_ERROR 1e-15         /* absolute, per function */
+#define MAX_EVENT_ERROR_SECONDS 1e-6 /* per prayer time */
+
+static double times_get(const struct PrayerTimes *t, int event) {
+  const double v[7] = {t->fajr, t->sunrise, t->dhuha, t->dhuhr, t->asr, t->maghrib, t->isha};
+  return v[event];
+}
+
+static void test_elementary_functions(void) {
+  printf("  polynomial kernels vs libm...\n");
+  double err_sin = 0.0, err_tan = 0.0, err_inv = 0.0, err_atan2 = 0.0;
+  for (int i = -200000; i <= 200000; i++) {
+    double x = i * (4.0 * M_PI / 200000.0) + 1e-7;
+    err_sin = fmax(err_sin, fabs(fast_sin(x) - sin(x)));
+    err_sin = fmax(err_sin, fabs(fast_cos(x) - cos(x)));
+
+    double u = i / 200000.0;
+    err_inv = fmax(err_inv, fabs(fast_acos(u) - acos(u)));
+    err_inv = fmax(err_inv, fabs(fast_asin(u) - asin(u)));
+
+    // Asr uses tan on [0, 90) degrees; compare relative to the value
+    double t = fabs(u) * 1.5;
+    err_tan = fmax(err_tan, fabs(fast_tan(t) - tan(t)) / fmax(1.0, tan(t)));
+
+    double a = i * (M_PI / 200000.0);
+    err_atan2 = fmax(err_atan2, fabs(fast_atan2(sin(a), cos(a)) - atan2(sin(a), cos(a))));
+  }
+  printf("    sin/cos %.2g  tan %.2g (rel)  asin/acos %.2g  atan2 %.2g\n", err_sin, err_tan,
+         err_inv, err_atan2);
+  check_bool("sin/cos", err_sin <= MAX_TRIG_ERROR);
+  check_bool("tan", err_tan <= MAX_TRIG_ERROR);
+  check_bool("asin/acos", err_inv <= MAX_TRIG_ERROR);
+  check_bool("atan2", err_atan2 <= MAX_TRIG_ERROR);
+  check_bool("acos outside [-1, 1] is NaN",
+             isnan(fast_acos(1.0 + 1e-15)) && isnan(fast_acos(-2.0)));
+}
+
+static bool is_leap(int y) {
+  return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+// Every date 1900-2100. Each date gets 6 of the 27 latitudes -65, -60, .., 65,
+// rotating so that every latitude is visited every few days.
+static void test_sweep_1900_2100(void) {
+  printf("  every date 1900-2100, latitudes -65..65 (Kemenag)...\n");
+  static const int dim[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  const MethodParams *p = method_params_get(CALC_KEMENAG);
+  double max_diff = 0.0;
+  long nan_mismatch = 0, minute_flips = 0, samples = 0, day_index = 0;
+
+  for (int y = 1900; y <= 2100; y++) {
+    for (int m = 1; m <= 12; m++) {
+      int days = dim[m - 1] + (m == 2 && is_leap(y));
+      for (int d = 1; d <= days; d++, day_index++) {
+        for (int k = 0; k < 6; k++) {
+          int lat = -65 + (int)((day_index * 5 + k * 23) % 27) * 5;
+          // Spread longitudes so solar noon lands on many minute offsets
+          double lon = fmod(lat * 37.3 + d * 11.9 + m * 3.1, 360.0) - 180.0;
+          double tz = floor(lon / 15.0 + 0.5);
+          struct PrayerTimes a = calculate_prayer_times(y, m, d, lat, lon, tz, p);
+          struct PrayerTimes b = fast_calculate_prayer_times(y, m, d, lat, lon, tz, p);
+          for (int e = 0; e < 7; e++) {
+            double x = times_get(&a, e), z = times_get(&b, e);
+            samples++;
+            if (isnan(x) || isnan(z)) {
+              nan_mismatch += isnan(x) != isnan(z);
+              continue;
+            }
+            max_diff = fmax(max_diff, fabs(x - z));
+            char sa[16], sb[16];
+            format_time_hm(x, sa, sizeof(sa));
+            format_time_hm(z, sb, sizeof(sb));
+            minute_flips += strcmp(sa, sb) != 0;
+          }
+        }
+      }
+    }
+  }
+  printf("    %ld events: max difference %.3g s, %ld NaN mismatches, %ld displayed minutes "
+         "changed\n",
+         samples, max_diff * 3600.0, nan_mismatch, minute_flips);
+  check_bool("within documented error", max_diff * 3600.0 <= MAX_EVENT_ERROR_SECONDS);
+  check_bool("same polar day/night NaNs", nan_mismatch == 0);
+  check_bool("no displayed minute changes", minute_flips == 0);
+}
+
+// Every row of the jadwalsholat.org reference table: the fast build shows the
+// same minutes as the exact build, and both stay within 2 min of the site
+static void test_reference_csv(const char *path) {
+  printf("  %s...\n", path);
+  FILE *f = fopen(path, "r");
+  check_bool("reference CSV readable", f != NULL);
+  if (!f)
+    return;
+
+  const MethodParams *p = method_params_get(CALC_KEMENAG);
+  char line[256];
+  int rows = 0, same = 0, near_ref = 0;
+  while (fgets(line, sizeof(line), f)) {
+    double lat, lon, tz;
+    int y, m, d, h[7], mi[7];
+    char city[64];
+    int n = sscanf(line,
+                   "%63[^,],%*d,%lf,%lf,%lf,%d-%d-%d,%d:%d,%d:%d,%d:%d,%d:%d,%d:%d,%d:%d,%d:%d",
+                   city, &lat, &lon, &tz, &y, &m, &d, &h[0], &mi[0], &h[1], &mi[1], &h[2], &mi[2],
+                   &h[3], &mi[3], &h[4], &mi[4], &h[5], &mi[5], &h[6], &mi[6]);
+    if (line[0] == '#' || n != 21)
+      continue;
+
+    struct PrayerTimes a = calculate_prayer_times(y, m, d, lat, lon, tz, p);
+    struct PrayerTimes b = fast_calculate_prayer_times(y, m, d, lat, lon, tz, p);
+    bool row_same = true, row_near = true;
+    for (int e = 0; e < 7; e++) {
+      char sa[16], sb[16];
+      format_time_hm(times_get(&a, e), sa, sizeof(sa));
+      format_time_hm(times_get(&b, e), sb, sizeof(sb));
+      row_same = row_same && strcmp(sa, sb) == 0;
+      int shown = atoi(sb) * 60 + atoi(sb + 3);
+      row_near = row_near && abs(shown - (h[e] * 60 + mi[e])) <= 2;
+    }
+    rows++;
+    same += row_same;
+    near_ref += row_near;
+  }
+  fclose(f);
+
+  printf("    %d rows: %d identical to the exact build, %d within 2 min of reference\n", rows,
+         same, near_ref);
+  check_bool("reference rows parsed", rows > 0);
+  check_bool("fast build shows the exact build's minutes", same == rows);
+  check_bool("fast build within 2 min of reference", near_ref == rows);
+}
+
+int main(int argc, char **argv) {
+  const char *csv = argc > 1 ? argv[1] : "tests/reference_prayer_times.csv";
+
+  printf("Running PRAYERTIMES_FAST_TRIG accuracy tests...\n");
+  test_elementary_functions();
+  test_sweep_1900_2100();
+  test_reference_csv(csv);
+
+  printf("\nResults: %d passed, %d failed\n", passed, failed);
+  return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,171 @@
+#define PRAYERTIMES_IMPLEMENTATION
+#include "prayertimes_soa.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int passed = 0;
+static int failed = 0;
+
+static void check_bool(const char *test, bool cond) {
+  if (cond) {
+    passed++;
+  } else {
+    failed++;
+    fprintf(stderr, "FAIL [%s]\n", test);
+  }
+}
+
+// 1 ms of time, in hours: far inside the 2-3 minute per-method tolerances
+#define MAX_DIFF_HOURS (0.001 / 3600.0)
+
+typedef struct {
+  double *lat, *lon, *tz;
+  double *buf;
+  PrayerTimesSoA out;
+} Grid;
+
+static void grid_alloc(Grid *g, size_t n) {
+  g->lat = malloc(n * sizeof(double));
+  g->lon = malloc(n * sizeof(double));
+  g->tz = malloc(n * sizeof(double));
+  g->buf = malloc(7 * n * sizeof(double));
+  g->out = (PrayerTimesSoA){g->buf,         g->buf + n,     g->buf + 2 * n, g->buf + 3 * n,
+                            g->buf + 4 * n, g->buf + 5 * n, g->buf + 6 * n};
+}
+
+static void grid_free(Grid *g) {
+  free(g->lat);
+  free(g->lon);
+  free(g->tz);
+  free(g->buf);
+}
+
+static double soa_get(const PrayerTimesSoA *o, int event, size_t i) {
+  const double *cols[7] = {o->fajr, o->sunrise, o->dhuha, o->dhuhr, o->asr, o->maghrib, o->isha};
+  return cols[event][i];
+}
+
+// Compare an ISA against the scalar engine on a latitude/longitude grid
+static void check_isa_on_grid(PrayerSimdIsa isa) {
+  printf("  %s vs scalar on a city grid, every method...\n", prayer_simd_isa_name(isa));
+
+  // 61 latitudes x 19 longitudes = 1159 sites: not a multiple of 2 or 4
+  size_t n = 61 * 19;
+  Grid g, ref;
+  grid_alloc(&g, n);
+  grid_alloc(&ref, n);
+  size_t k = 0;
+  for (int a = 0; a < 61; a++) {
+    for (int b = 0; b < 19; b++, k++) {
+      g.lat[k] = -66.0 + a * 2.2;
+      g.lon[k] = -180.0 + b * 19.7;
+      g.tz[k] = floor(g.lon[k] / 15.0 + 0.5);
+    }
+  }
+
+  static const int dates[][3] = {{2026, 1, 15}, {2026, 3, 20}, {2026, 6, 21}, {2026, 9, 23},
+                                 {2026, 12, 21}};
+  double max_diff = 0.0;
+  bool nan_pattern_ok = true;
+  for (size_t d = 0; d < sizeof(dates) / sizeof(dates[0]); d++) {
+    SunState sun = sun_state_for_date(dates[d][0], dates[d][1], dates[d][2]);
+    for (int m = 0; m < CALC_COUNT; m++) {
+      const MethodParams *p = method_params_get((CalcMethod)m);
+      prayer_times_soa_isa(isa, &sun, p, n, g.lat, g.lon, g.tz, &g.out);
+      prayer_times_soa_isa(PRAYER_SIMD_SCALAR, &sun, p, n, g.lat, g.lon, g.tz, &ref.out);
+      for (size_t i = 0; i < n; i++) {
+        for (int e = 0; e < 7; e++) {
+          double x = soa_get(&g.out, e, i);
+          double y = soa_get(&ref.out, e, i);
+          if (isnan(x) || isnan(y)) {
+            if (isnan(x) != isnan(y))
+              nan_pattern_ok = false;
+            continue;
+          }
+          if (fabs(x - y) > max_diff)
+            max_diff = fabs(x - y);
+        }
+      }
+    }
+  }
+  printf("    max difference %.3g s\n", max_diff * 3600.0);
+  check_bool("within 1 ms of scalar", max_diff <= MAX_DIFF_HOURS);
+  check_bool("polar day/night lanes match scalar NaNs", nan_pattern_ok);
+
+  grid_free(&g);
+  grid_free(&ref);
+}
+
+static void test_scalar_matches_calculate_prayer_times(void) {
+  printf("  scalar path matches calculate_prayer_times...\n");
+  double lat[3] = {-6.1667, 51.5074, 21.4225};
+  double lon[3] = {106.8167, -0.1278, 39.8262};
+  double tz[3] = {7.0, 0.0, 3.0};
+  double buf[21];
+  PrayerTimesSoA out = {buf, buf + 3, buf + 6, buf + 9, buf + 12, buf + 15, buf + 18};
+  const MethodParams *p = method_params_get(CALC_MWL);
+  SunState sun = sun_state_for_date(2026, 6, 15);
+  prayer_times_soa_isa(PRAYER_SIMD_SCALAR, &sun, p, 3, lat, lon, tz, &out);
+  bool same = true;
+  for (int i = 0; i < 3; i++) {
+    struct PrayerTimes t = calculate_prayer_times(2026, 6, 15, lat[i], lon[i], tz[i], p);
+    same = same && t.fajr == out.fajr[i] && t.asr == out.asr[i] && t.isha == out.isha[i];
+  }
+  check_bool("scalar identical", same);
+}
+
+static void test_tail_lengths(void) {
+  printf("  lengths 1..9 exercise the padded tail...\n");
+  const MethodParams *p = method_params_get(CALC_KEMENAG);
+  SunState sun = sun_state_for_date(2026, 1, 15);
+  for (size_t n = 1; n <= 9; n++) {
+    double lat[9], lon[9], tz[9], buf[63], ref_buf[63];
+    for (size_t i = 0; i < n; i++) {
+      lat[i] = -6.1667 + (double)i;
+      lon[i] = 106.8167 + (double)i;
+      tz[i] = 7.0;
+    }
+    PrayerTimesSoA out = {buf,         buf + n,     buf + 2 * n, buf + 3 * n,
+                          buf + 4 * n, buf + 5 * n, buf + 6 * n};
+    PrayerTimesSoA ref = {ref_buf,         ref_buf + n,     ref_buf + 2 * n, ref_buf + 3 * n,
+                          ref_buf + 4 * n, ref_buf + 5 * n, ref_buf + 6 * n};
+    prayer_times_soa(&sun, p, n, lat, lon, tz, &out);
+    prayer_times_soa_isa(PRAYER_SIMD_SCALAR, &sun, p, n, lat, lon, tz, &ref);
+    bool ok = true;
+    for (size_t i = 0; i < 7 * n; i++)
+      ok = ok && fabs(buf[i] - ref_buf[i]) <= MAX_DIFF_HOURS;
+    check_bool("tail length matches scalar", ok);
+  }
+}
+
+static void test_reference_jakarta(void) {
+  printf("  Jakarta 2026-01-15 (Kemenag) matches jadwalsholat.org...\n");
+  // Same reference as test_prayertimes.c Test 01; times in minutes of day
+  static const int expected[7] = {4 * 60 + 26, 5 * 60 + 46, 6 * 60 + 10, 12 * 60 + 4,
+                                  15 * 60 + 29, 18 * 60 + 17, 19 * 60 + 32};
+  double lat = -6.1667, lon = 106.8167, tz = 7.0, buf[7];
+  PrayerTimesSoA out = {buf, buf + 1, buf + 2, buf + 3, buf + 4, buf + 5, buf + 6};
+  SunState sun = sun_state_for_date(2026, 1, 15);
+  prayer_times_soa(&sun, method_params_get(CALC_KEMENAG), 1, &lat, &lon, &tz, &out);
+  for (int e = 0; e < 7; e++) {
+    int minute = (int)ceil(buf[e] * 60.0);
+    check_bool("within 2 min of reference", abs(minute - expected[e]) <= 2);
+  }
+}
+
+int main(void) {
+  printf("Running prayer-times SoA tests (detected: %s)...\n",
+         prayer_simd_isa_name(prayer_simd_detect()));
+
+  test_scalar_matches_calculate_prayer_times();
+  test_tail_lengths();
+  test_reference_jakarta();
+  for (int isa = PRAYER_SIMD_SSE2; isa <= (int)prayer_simd_detect(); isa++)
+    check_isa_on_grid((PrayerSimdIsa)isa);
+
+  printf("\nResults: %d passed, %d failed\n", passed, failed);
+  return failed > 0 ? 1 : 0;
+}
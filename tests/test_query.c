@@ -0,0 +1,288 @@
+#define _GNU_SOURCE
+#include "check_cycle.h"
+#include "config.h"
+#include "platform.h"
+#include "prayer_checker.h"
+#include "query.h"
+#include <errno.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+static int passed = 0;
+static int failed = 0;
+
+static void check_bool(const char *test, bool cond) {
+  if (cond) {
+    passed++;
+  } else {
+    failed++;
+    fprintf(stderr, "FAIL [%s]\n", test);
+  }
+}
+
+static char tmpdir[] = "/tmp/mt_query_XXXXXX";
+
+// 2026-03-22 00:00 UTC; the test runs with TZ=UTC
+static const time_t DAY0 = 1774137600;
+
+static int count_lines(const char *s, const char *prefix) {
+  int n = 0;
+  for (const char *p = s; p && *p; p = strchr(p, '\n') ? strchr(p, '\n') + 1 : NULL) {
+    if (strncmp(p, prefix, strlen(prefix)) == 0)
+      n++;
+  }
+  return n;
+}
+
+static void test_socket_path(void) {
+  char path[108];
+  unsetenv("XDG_RUNTIME_DIR");
+  check_bool("no runtime dir, no socket", query_socket_path(path, sizeof(path)) == -1);
+  setenv("XDG_RUNTIME_DIR", "relative", 1);
+  check_bool("relative runtime dir rejected", query_socket_path(path, sizeof(path)) == -1);
+  setenv("XDG_RUNTIME_DIR", tmpdir, 1);
+  char expect[108];
+  snprintf(expect, sizeof(expect), "%s/%s", tmpdir, QUERY_SOCKET_NAME);
+  check_bool("socket in runtime dir",
+             query_socket_path(path, sizeof(path)) == 0 && strcmp(path, expect) == 0);
+  check_bool("path must fit the buffer", query_socket_path(path, 8) == -1);
+}
+
+static void test_answers(const Config *cfg) {
+  DaemonState st;
+  daemon_state_init(&st);
+  QueryContext ctx = {&st, NULL, DAY0, 3, 5, NULL};
+  char out[4096];
+  time_t now = DAY0 + 10 * 3600; // 10:00, between Dhuha and Dhuhr
+
+  query_answer(&ctx, "next", now, out, sizeof(out));
+  check_bool("not loaded is an error", strstr(out, "\nerror config not loaded\n") != NULL);
+
+  st.cfg = *cfg;
+  st.config_loaded = true;
+
+  int len = query_answer(&ctx, "next", now, out, sizeof(out));
+  char head[600];
+  snprintf(head, sizeof(head), "config %s\n", config_get_path());
+  check_bool("reply names its config",
+             len > 0 && (size_t)len == strlen(out) && strncmp(out, head, strlen(head)) == 0);
+
+  struct tm tm_now;
+  localtime_r(&now, &tm_now);
+  MethodParams params = method_params_from_config(cfg);
+  struct PrayerTimes times = calculate_prayer_times(2026, 3, 22, cfg->latitude, cfg->longitude,
+                                                    cfg->timezone_offset, &params);
+  int minutes_until = 0;
+  PrayerType next = prayer_get_next(cfg, &tm_now, &times, &minutes_until);
+  int type = -1, until = -1;
+  double hours = 0.0;
+  check_bool("next parses", sscanf(query_reply_body(out), "next %d %lf %d", &type, &hours,
+                                   &until) == 3);
+  check_bool("next matches prayer_get_next", type == (int)next && until == minutes_until);
+  check_bool("next time matches", hours == prayer_get_time(&times, next));
+
+  query_answer(&ctx, "today", now, out, sizeof(out));
+  check_bool("today is one day", count_lines(out, "day 2026-03-22 ") == 1 &&
+                                     count_lines(out, "day ") == 1);
+  char enabled[32];
+  SchedulePlan plan;
+  schedule_plan_build(&plan, cfg);
+  snprintf(enabled, sizeof(enabled), "\nenabled %u\n", plan.enabled);
+  check_bool("today carries the enabled mask", strstr(out, enabled) != NULL);
+
+  query_answer(&ctx, "range 2026-02-27 3", now, out, sizeof(out));
+  check_bool("range crosses the month", count_lines(out, "day ") == 3 &&
+                                            count_lines(out, "day 2026-03-01 ") == 1);
+  const char *day = strstr(out, "day 2026-03-01 ");
+  double fajr = 0.0;
+  struct PrayerTimes march1 = calculate_prayer_times(2026, 3, 1, cfg->latitude, cfg->longitude,
+                                                     cfg->timezone_offset, &params);
+  check_bool("range day times", day && sscanf(day, "day 2026-03-01 %lf", &fajr) == 1 &&
+                                    fabs(fajr - march1.fajr) < 1e-6);
+
+  len = query_answer(&ctx, "range 2026-01-01 366", now, out, sizeof(out));
+  check_bool("reply too large for the buffer", len == -1);
+  static char big[QUERY_REPLY_MAX];
+  len = query_answer(&ctx, "range 2026-01-01 366", now, big, sizeof(big));
+  check_bool("full year fits QUERY_REPLY_MAX", len > 0 && count_lines(big, "day ") == 366);
+
+  query_answer(&ctx, "range 2026-01-01 367", now, out, sizeof(out));
+  check_bool("range is bounded", strstr(out, "\nerror usage") != NULL);
+  query_answer(&ctx, "range tomorrow", now, out, sizeof(out));
+  check_bool("bad range date", strstr(out, "\nerror usage") != NULL);
+  query_answer(&ctx, "next please", now, out, sizeof(out));
+  check_bool("next takes no argument", strstr(out, "\nerror unknown request\n") != NULL);
+  query_answer(&ctx, "", now, out, sizeof(out));
+  check_bool("empty request", strstr(out, "\nerror unknown request\n") != NULL);
+
+  st.cache.trigger_count = 9;
+  st.cache.head = 2;
+  query_answer(&ctx, "stats", now + 60, out, sizeof(out));
+  check_bool("stats", strstr(out, "\nuptime 36060\n") && strstr(out, "\nwakeups_today 3\n") &&
+                          strstr(out, "\nqueries 5\n") && strstr(out, "\npending_triggers 7\n"));
+  check_bool("no client line without clients", strstr(out, "\nlatency ") == NULL);
+
+  // Client serve times come from the daemon's histogram, not the reactor's
+  // short-lived client sources
+  Reactor reactor;
+  ReactorSource sources[2] = {{.fd = 3, .name = "timer"}, {.fd = 4, .name = QUERY_CLIENT_SOURCE}};
+  reactor.sources = sources;
+  reactor.count = reactor.capacity = 2;
+  LatencyHistogram clients;
+  memset(&clients, 0, sizeof(clients));
+  latency_record(&clients, 20000);
+  latency_record(&clients, 40000);
+  QueryContext served = ctx;
+  served.reactor = &reactor;
+  served.clients = &clients;
+  query_answer(&served, "stats", now, out, sizeof(out));
+  check_bool("reactor source line", count_lines(out, "latency timer 0 ") == 1);
+  check_bool("client line from the histogram", count_lines(out, "latency client ") == 1 &&
+                                                   count_lines(out, "latency client 2 ") == 1);
+  st.cache.trigger_count = 0;
+  st.cache.head = 0;
+
+  daemon_state_free(&st);
+}
+
+/* Parent side of one round trip: wait for a connection and hand it to serve. */
+static int accept_one(int listen_fd) {
+  struct pollfd p = {.fd = listen_fd, .events = POLLIN};
+  if (poll(&p, 1, 2000) != 1)
+    return -1;
+  return query_accept(listen_fd);
+}
+
+static void test_round_trip(const Config *cfg) {
+  char path[108];
+  query_socket_path(path, sizeof(path));
+  check_bool("no daemon, no reply", query_request("next", (char[64]){0}, 64, 50) == -1);
+
+  int fd = query_listen(path);
+  check_bool("listen", fd >= 0);
+  errno = 0;
+  check_bool("second daemon refused", query_listen(path) == -1 && errno == EADDRINUSE);
+  close(accept_one(fd)); // Its probe connection
+
+  DaemonState st;
+  daemon_state_init(&st);
+  st.cfg = *cfg;
+  st.config_loaded = true;
+  QueryContext ctx = {&st, NULL, time(NULL), 0, 1, NULL};
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    char reply[512];
+    int rc = query_request("next", reply, sizeof(reply), 2000);
+    const char *body = query_reply_body(reply);
+    _exit(rc == 0 && (strncmp(body, "next ", 5) == 0 || strcmp(body, "none\n") == 0) ? 0 : 1);
+  }
+  int client = accept_one(fd);
+  check_bool("served", client >= 0 && query_serve(client, &ctx, time(NULL)) == 0);
+  close(client);
+  int status = 1;
+  waitpid(pid, &status, 0);
+  check_bool("client got the answer", WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  // A reply computed from another config.json is not used
+  pid = fork();
+  if (pid == 0) {
+    char reply[512];
+    _exit(query_request("next", reply, sizeof(reply), 2000) == -1 ? 0 : 1);
+  }
+  client = accept_one(fd);
+  char request[QUERY_REQUEST_MAX];
+  ssize_t n = client >= 0 ? read(client, request, sizeof(request)) : -1;
+  const char *other = "config /elsewhere/config.json\nnone\n";
+  check_bool("fake daemon", n > 0 && write(client, other, strlen(other)) > 0);
+  close(client);
+  waitpid(pid, &status, 0);
+  check_bool("other config ignored", WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  // A client that never sends is dropped after the timeout
+  int idle = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+  check_bool("idle connect", connect(idle, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+  client = accept_one(fd);
+  check_bool("idle client times out", client >= 0 && query_serve(client, &ctx, time(NULL)) == -1);
+  close(client);
+  close(idle);
+
+  // One byte just inside the timeout at a time still hits a single deadline
+  pid = fork();
+  if (pid == 0) {
+    int s = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (connect(s, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+      _exit(1);
+    for (int i = 0; i < 20; i++) {
+      if (send(s, "n", 1, MSG_NOSIGNAL) != 1)
+        break;
+      usleep((QUERY_TIMEOUT_MS - 10) * 1000);
+    }
+    _exit(0);
+  }
+  client = accept_one(fd);
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  int rc = client >= 0 ? query_serve(client, &ctx, time(NULL)) : 0;
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  long long ms = (t1.tv_sec - t0.tv_sec) * 1000LL + (t1.tv_nsec - t0.tv_nsec) / 1000000;
+  check_bool("trickling client times out", rc == -1 && ms < 2 * QUERY_TIMEOUT_MS);
+  close(client);
+  kill(pid, SIGKILL);
+  waitpid(pid, NULL, 0);
+
+  // A daemon that died leaves its socket file; the next one takes it over
+  close(fd);
+  check_bool("socket file left behind", access(path, F_OK) == 0);
+  check_bool("no daemon behind a stale socket", query_request("next", (char[64]){0}, 64, 50) == -1);
+  fd = query_listen(path);
+  check_bool("stale socket replaced", fd >= 0);
+  close(fd);
+  unlink(path);
+
+  daemon_state_free(&st);
+}
+
+int main(void) {
+  printf("Running query tests...\n");
+
+  if (!mkdtemp(tmpdir)) {
+    fprintf(stderr, "FATAL: mkdtemp failed\n");
+    return 1;
+  }
+  setenv("XDG_CONFIG_HOME", tmpdir, 1);
+  setenv("XDG_CACHE_HOME", tmpdir, 1);
+  setenv("TZ", "UTC", 1);
+  tzset();
+  platform_reset_cached_paths();
+
+  // Jakarta, fixed location so no network lookup happens
+  Config cfg = config_default();
+  cfg.latitude = -6.2088;
+  cfg.longitude = 106.8456;
+  cfg.timezone_offset = 7.0;
+  cfg.auto_detect = false;
+
+  test_socket_path();
+  test_answers(&cfg);
+  test_round_trip(&cfg);
+
+  char cmd[128];
+  snprintf(cmd, sizeof(cmd), "rm -rf %s", tmpdir);
+  if (system(cmd) != 0) { /* best-effort cleanup */
+  }
+
+  printf("\nResults: %d passed, %d failed\n", passed, failed);
+  return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,170 @@
+#define _GNU_SOURCE
+
+#include "reactor.h"
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+static int total = 0;
+static int failures = 0;
+
+static void report_result(const char *label, bool pass) {
+  total++;
+  if (pass) {
+    printf("  PASS: %s\n", label);
+  } else {
+    printf("  FAIL: %s\n", label);
+    failures++;
+  }
+}
+
+static int handled_count = 0;
+static int last_fd = -1;
+
+static void drain(Reactor *r, int fd, uint32_t events, void *user) {
+  (void)r;
+  (void)events;
+  char buf[sizeof(struct signalfd_siginfo)]; /* fits eventfd, timerfd and signalfd reads */
+  if (read(fd, buf, sizeof(buf)) < 0) { /* nothing left to drain */
+  }
+  handled_count++;
+  last_fd = fd;
+  if (user)
+    (*(int *)user)++;
+}
+
+static void remove_self(Reactor *r, int fd, uint32_t events, void *user) {
+  drain(r, fd, events, user);
+  reactor_remove(r, fd);
+}
+
+static void test_histogram(void) {
+  LatencyHistogram h = {0};
+  report_result("empty histogram percentile is 0", latency_percentile_ns(&h, 0.5) == 0);
+
+  for (int i = 0; i < 98; i++)
+    latency_record(&h, 500); /* < 1 us */
+  latency_record(&h, 3000);    /* [2, 4) us */
+  latency_record(&h, 5000000); /* ~5 ms */
+  report_result("count and max tracked", h.count == 100 && h.max_ns == 5000000);
+  report_result("p50 in the sub-microsecond bucket", latency_percentile_ns(&h, 0.50) == 1000);
+  report_result("p98 bucket upper bound", latency_percentile_ns(&h, 0.98) == 4000);
+  report_result("p100 covers the slowest sample", latency_percentile_ns(&h, 1.0) >= 5000000);
+
+  LatencyHistogram huge = {0};
+  latency_record(&huge, UINT64_MAX / 2);
+  report_result("oversized sample lands in last bucket", huge.buckets[LATENCY_BUCKETS - 1] == 1);
+}
+
+static void test_dispatch_and_remove(void) {
+  Reactor r;
+  report_result("reactor init", reactor_init(&r) == 0);
+
+  int a = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  int b = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  int hits_a = 0, hits_b = 0;
+  report_result("add first source", reactor_add(&r, a, "a", drain, &hits_a) == 0);
+  report_result("add second source", reactor_add(&r, b, "b", remove_self, &hits_b) == 1);
+  report_result("timeout with nothing ready", reactor_poll(&r, 10) == 0);
+
+  uint64_t one = 1;
+  if (write(a, &one, sizeof(one)) < 0 || write(b, &one, sizeof(one)) < 0)
+    report_result("eventfd write", false);
+  report_result("both sources dispatched", reactor_poll(&r, 100) == 2);
+  report_result("handlers got their user data", hits_a == 1 && hits_b == 1);
+  report_result("latency recorded for kept source", r.sources[0].latency.count == 1);
+  report_result("self-removed source freed its slot", r.sources[1].fd == -1);
+
+  if (write(b, &one, sizeof(one)) < 0)
+    report_result("eventfd write", false);
+  report_result("removed source is not dispatched", reactor_poll(&r, 10) == 0 && hits_b == 1);
+  report_result("remove unknown fd fails", reactor_remove(&r, b) == -1);
+
+  int c = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  report_result("freed slot is reused", reactor_add(&r, c, "c", drain, NULL) == 1);
+
+  reactor_free(&r);
+  close(a);
+  close(b);
+  close(c);
+}
+
+static void test_many_sources(void) {
+  enum { N = 500 };
+  Reactor r;
+  reactor_init(&r);
+  int fds[N];
+  bool added = true;
+  for (int i = 0; i < N; i++) {
+    fds[i] = eventfd(1, EFD_NONBLOCK | EFD_CLOEXEC); /* already readable */
+    added = added && fds[i] >= 0 && reactor_add(&r, fds[i], "ev", drain, NULL) == i;
+  }
+  report_result("500 sources registered", added);
+
+  handled_count = 0;
+  int polls = 0;
+  while (handled_count < N && polls < 100) {
+    reactor_poll(&r, 100);
+    polls++;
+  }
+  report_result("every source dispatched once", handled_count == N);
+  bool each_once = true;
+  for (int i = 0; i < N; i++)
+    each_once = each_once && r.sources[i].latency.count == 1;
+  report_result("per-source histograms", each_once);
+
+  reactor_free(&r);
+  for (int i = 0; i < N; i++)
+    close(fds[i]);
+}
+
+static void test_timer_and_signal(void) {
+  Reactor r;
+  reactor_init(&r);
+
+  int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  struct itimerspec its = {.it_value = {.tv_sec = 0, .tv_nsec = 1000000}};
+  timerfd_settime(tfd, 0, &its, NULL);
+  reactor_add(&r, tfd, "timer", drain, NULL);
+
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGUSR1);
+  sigprocmask(SIG_BLOCK, &mask, NULL);
+  int sfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+  reactor_add(&r, sfd, "signal", drain, NULL);
+
+  last_fd = -1;
+  report_result("timer expiry dispatched", reactor_poll(&r, 1000) == 1 && last_fd == tfd);
+
+  raise(SIGUSR1);
+  report_result("signal dispatched", reactor_poll(&r, 1000) == 1 && last_fd == sfd);
+  report_result("signal reaction under 1 ms", r.sources[1].latency.max_ns < 1000000);
+
+  reactor_free(&r);
+  close(tfd);
+  close(sfd);
+}
+
+int main(void) {
+  printf("test_histogram\n");
+  test_histogram();
+  printf("test_dispatch_and_remove\n");
+  test_dispatch_and_remove();
+  printf("test_many_sources\n");
+  test_many_sources();
+  printf("test_timer_and_signal\n");
+  test_timer_and_signal();
+  if (failures == 0) {
+    printf("All %d tests passed.\n", total);
+    return 0;
+  }
+  printf("%d/%d tests failed.\n", failures, total);
+  return 1;
+}
@@ -0,0 +1,244 @@
+#define _GNU_SOURCE
+#include "cache.h"
+#include "check_cycle.h"
+#include "config.h"
+#include "platform.h"
+#include "prayer_checker.h"
+#include "snapshot.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+static int passed = 0;
+static int failed = 0;
+
+static void check_bool(const char *test, bool cond) {
+  if (cond) {
+    passed++;
+  } else {
+    failed++;
+    fprintf(stderr, "FAIL [%s]\n", test);
+  }
+}
+
+static char tmpdir[] = "/tmp/mt_snapshot_XXXXXX";
+
+// 2026-03-22 00:00 UTC; the test runs with TZ=UTC
+static const time_t DAY0 = 1774137600;
+
+static void test_path(void) {
+  char path[PLATFORM_PATH_MAX];
+  unsetenv("XDG_RUNTIME_DIR");
+  check_bool("no runtime dir, no snapshot", snapshot_path(path, sizeof(path)) == -1);
+  setenv("XDG_RUNTIME_DIR", tmpdir, 1);
+  char expect[PLATFORM_PATH_MAX];
+  snprintf(expect, sizeof(expect), "%s/%s", tmpdir, SNAPSHOT_FILE_NAME);
+  check_bool("snapshot in runtime dir",
+             snapshot_path(path, sizeof(path)) == 0 && strcmp(path, expect) == 0);
+  check_bool("config key depends on the path",
+             snapshot_config_key("/a/config.json") != snapshot_config_key("/b/config.json"));
+}
+
+static void test_publish_and_read(DaemonState *st) {
+  char path[PLATFORM_PATH_MAX];
+  snapshot_path(path, sizeof(path));
+
+  SnapshotWriter w;
+  check_bool("writer open", snapshot_writer_open(&w, path) == 0);
+  struct stat sb;
+  check_bool("private to the user", stat(path, &sb) == 0 && (sb.st_mode & 0777) == 0600);
+
+  const SnapshotRegion *region = snapshot_map(path);
+  check_bool("reader maps", region != NULL);
+  if (!region)
+    return;
+  SnapshotData data;
+  check_bool("nothing published yet", snapshot_read(region, &data) == -1);
+
+  time_t now = DAY0 + 10 * 3600 + 30; // 10:00:30
+  SnapshotData pub;
+  check_bool("fill", snapshot_fill(&pub, st, now) == 0);
+  snapshot_publish(&w, &pub);
+  check_bool("read after publish", snapshot_read(region, &data) == 0 && data.generation == 1);
+
+  struct tm tm_now;
+  localtime_r(&now, &tm_now);
+  double times[PRAYER_NONE];
+  cache_day_times(&st->cfg, &tm_now, times);
+  check_bool("today's times", data.date == 20260322 &&
+                                  memcmp(data.times, times, sizeof(times)) == 0);
+
+  int next = cache_first_due_after(&st->cache, now);
+  const CacheTrigger *t = &st->cache.triggers[next];
+  check_bool("next trigger", data.next_due == (int64_t)t->due &&
+                                 strcmp(data.next_prayer, t->prayer) == 0 &&
+                                 data.next_minutes_before == t->minutes_before &&
+                                 data.next_due > (int64_t)now);
+
+  snapshot_publish(&w, &pub);
+  check_bool("generation advances", snapshot_read(region, &data) == 0 && data.generation == 2);
+
+  // Mid-update: the reader gives up rather than return a torn copy
+  w.region->seq++;
+  check_bool("odd sequence is not read", snapshot_read(region, &data) == -1);
+  w.region->seq++;
+  check_bool("even again", snapshot_read(region, &data) == 0);
+
+  // Current only for its day and its config path
+  const char *config = config_get_path();
+  check_bool("current", snapshot_is_current(&data, &tm_now, config));
+  struct tm tomorrow = tm_now;
+  tomorrow.tm_mday++;
+  check_bool("not for another day", !snapshot_is_current(&data, &tomorrow, config));
+  SnapshotData other = data;
+  other.config_key ^= 1;
+  check_bool("not for another config", !snapshot_is_current(&other, &tm_now, config));
+
+  // The opt-in stat check compares config.json with the stamp as loaded
+  check_bool("config unchanged", snapshot_config_unchanged(&data, config));
+  other = data;
+  other.config_stamp.mtime_ns -= 1000000000LL;
+  check_bool("config changed since", !snapshot_config_unchanged(&other, config));
+
+  // A daemon replacing one that died retires its region for readers still
+  // mapping it
+  SnapshotWriter died = w;
+  SnapshotWriter successor;
+  check_bool("successor opens", snapshot_writer_open(&successor, path) == 0);
+  check_bool("old mapping retired", snapshot_read(region, &data) == -1);
+  const SnapshotRegion *fresh = snapshot_map(path);
+  snapshot_publish(&successor, &pub);
+  check_bool("new file read", fresh && snapshot_read(fresh, &data) == 0 && data.generation == 1);
+  snapshot_unmap(fresh);
+  munmap(died.region, sizeof(SnapshotRegion));
+  w = successor;
+
+  // Same answer as prayer_get_next through the day
+  MethodParams params = method_params_from_config(&st->cfg);
+  struct PrayerTimes pt = calculate_prayer_times(2026, 3, 22, st->cfg.latitude, st->cfg.longitude,
+                                                 st->cfg.timezone_offset, &params);
+  bool same = true;
+  for (int minute = 0; minute < MINUTES_PER_DAY; minute += 7) {
+    struct tm at = tm_now;
+    at.tm_hour = minute / 60;
+    at.tm_min = minute % 60;
+    int want_min = 0, got_min = 0;
+    PrayerType want = prayer_get_next(&st->cfg, &at, &pt, &want_min);
+    PrayerType got = snapshot_next_prayer(&data, &at, &got_min);
+    same = same && want == got && want_min == got_min;
+  }
+  check_bool("next prayer matches prayer_get_next", same);
+
+  region = snapshot_map(path);
+  snapshot_writer_close(&w);
+  check_bool("closed snapshot holds no schedule", region && snapshot_read(region, &data) == -1);
+  check_bool("file removed", access(path, F_OK) != 0);
+  snapshot_unmap(region);
+}
+
+/* A child publishes as fast as it can, every time field set to the same
+ * counter; the parent must never see a mix of two publishes. */
+static void test_concurrent_reads(void) {
+  char path[PLATFORM_PATH_MAX];
+  snapshot_path(path, sizeof(path));
+  SnapshotWriter w;
+  if (snapshot_writer_open(&w, path) != 0) {
+    check_bool("writer open for concurrency", false);
+    return;
+  }
+  const SnapshotRegion *region = snapshot_map(path);
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    SnapshotData d;
+    memset(&d, 0, sizeof(d));
+    for (int n = 1;; n++) {
+      for (int i = 0; i < PRAYER_NONE; i++)
+        d.times[i] = n;
+      d.next_prayer_time = n;
+      d.date = n;
+      snapshot_publish(&w, &d);
+    }
+  }
+
+  int reads = 0, torn = 0;
+  time_t until = time(NULL) + 1;
+  while (time(NULL) <= until) {
+    SnapshotData d;
+    if (snapshot_read(region, &d) != 0)
+      continue;
+    reads++;
+    for (int i = 0; i < PRAYER_NONE; i++)
+      torn += d.times[i] != d.date;
+    torn += d.next_prayer_time != d.date;
+  }
+  kill(pid, SIGKILL);
+  waitpid(pid, NULL, 0);
+
+  check_bool("reads succeed under a busy writer", reads > 0);
+  check_bool("no torn reads", torn == 0);
+  snapshot_unmap(region);
+  snapshot_writer_close(&w);
+}
+
+static void test_foreign_file(void) {
+  char path[PLATFORM_PATH_MAX];
+  snprintf(path, sizeof(path), "%s/not-a-snapshot", tmpdir);
+  FILE *f = fopen(path, "w");
+  fputs("hello", f);
+  fclose(f);
+  check_bool("wrong size is not mapped", snapshot_map(path) == NULL);
+  check_bool("missing file is not mapped", snapshot_map("/nonexistent/snapshot") == NULL);
+}
+
+int main(void) {
+  printf("Running snapshot tests...\n");
+
+  if (!mkdtemp(tmpdir)) {
+    fprintf(stderr, "FATAL: mkdtemp failed\n");
+    return 1;
+  }
+  setenv("XDG_CONFIG_HOME", tmpdir, 1);
+  setenv("XDG_CACHE_HOME", tmpdir, 1);
+  setenv("TZ", "UTC", 1);
+  tzset();
+  platform_reset_cached_paths();
+  cache_reset_path();
+
+  // Jakarta, fixed location so no network lookup happens
+  Config cfg = config_default();
+  cfg.latitude = -6.2088;
+  cfg.longitude = 106.8456;
+  cfg.timezone_offset = 7.0;
+  cfg.auto_detect = false;
+  check_bool("config saved", config_save(&cfg) == 0);
+
+  DaemonState st;
+  daemon_state_init(&st);
+  st.cfg = cfg;
+  st.config_loaded = true;
+  platform_file_stamp(config_get_path(), &st.config_stamp);
+  check_bool("window built", cache_build_window(&st.cache, &cfg, "2026-03-22", 2, DAY0) >= 0);
+
+  test_path();
+  test_publish_and_read(&st);
+  test_concurrent_reads();
+  test_foreign_file();
+
+  daemon_state_free(&st);
+
+  char cmd[128];
+  snprintf(cmd, sizeof(cmd), "rm -rf %s", tmpdir);
+  if (system(cmd) != 0) { /* best-effort cleanup */
+  }
+
+  printf("\nResults: %d passed, %d failed\n", passed, failed);
+  return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,149 @@
+#define PRAYERTIMES_IMPLEMENTATION
+#include "prayertimes.h"
+#include "sun_chebyshev.h"
+#include "vsop87_sun.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int passed = 0;
+static int failed = 0;
+
+static void check_bool(const char *test, bool cond) {
+  if (cond) {
+    passed++;
+  } else {
+    failed++;
+    fprintf(stderr, "FAIL [%s]\n", test);
+  }
+}
+
+// Documented bounds (sun_chebyshev.h): fit error against the VSOP87 reference
+#define MAX_FIT_DECL_ARCSEC 0.05
+#define MAX_FIT_EQT_SECONDS 0.005
+
+static void test_reference_model(void) {
+  printf("  VSOP87 reference vs Meeus examples 25.b / 28.b...\n");
+  // 1992 Oct 13.0 TD; ΔT of 1992 brings it back to UT
+  double jd = 2448908.5 - vsop87_delta_t(1992.78) / 86400.0;
+  double lon, decl, eqt;
+  vsop87_sun_apparent(jd, &lon, &decl, &eqt);
+  check_bool("apparent longitude 199°54'21.82\"",
+             fabs(lon - (199 + 54 / 60.0 + 21.818 / 3600.0)) * 3600.0 < 1.0);
+  check_bool("declination -7°47'01.74\"",
+             fabs(decl - -(7 + 47 / 60.0 + 1.74 / 3600.0)) * 3600.0 < 1.0);
+  check_bool("equation of time 13m42.6s", fabs(eqt * 3600.0 - (13 * 60 + 42.6)) < 0.5);
+}
+
+static void test_fit_error(void) {
+  printf("  Chebyshev fit and analytic model vs VSOP87, 1900-2200...\n");
+  double first, last;
+  sun_chebyshev_range(&first, &last);
+  check_bool("span starts 1900-01-01", first == sun_state_for_date(1900, 1, 1).jd);
+  check_bool("span ends 2201-01-01", last == sun_state_for_date(2201, 1, 1).jd);
+
+  double fit_decl = 0.0, fit_eqt = 0.0, ana_decl = 0.0, ana_eqt = 0.0;
+  // Every 0h UT, plus a fractional day every week
+  for (double jd = first; jd < last; jd += 1.0) {
+    for (int k = 0; k < 2; k++) {
+      double t = jd + (k == 0 ? 0.0 : 0.37);
+      if (k == 1 && fmod(jd - first, 7.0) != 0.0)
+        continue;
+      double rd, re, cd, ce, ad, ae;
+      vsop87_sun_apparent(t, NULL, &rd, &re);
+      if (!sun_chebyshev(t, &cd, &ce)) {
+        check_bool("inside span", false);
+        return;
+      }
+      sun_position_analytic(t, &ad, &ae);
+      fit_decl = fmax(fit_decl, fabs(cd - rd));
+      fit_eqt = fmax(fit_eqt, fabs(ce - re));
+      ana_decl = fmax(ana_decl, fabs(ad - rd));
+      ana_eqt = fmax(ana_eqt, fabs(ae - re));
+    }
+  }
+  printf("    chebyshev: declination %.3g\", equation of time %.3g s\n", fit_decl * 3600.0,
+         fit_eqt * 3600.0);
+  printf("    analytic:  declination %.3g\", equation of time %.3g s\n", ana_decl * 3600.0,
+         ana_eqt * 3600.0);
+  check_bool("declination fit", fit_decl * 3600.0 <= MAX_FIT_DECL_ARCSEC);
+  check_bool("equation of time fit", fit_eqt * 3600.0 <= MAX_FIT_EQT_SECONDS);
+
+  double d = 1.0, e = 2.0;
+  check_bool("before span", !sun_chebyshev(first - 0.5, &d, &e));
+  check_bool("after span", !sun_chebyshev(last, &d, &e));
+  check_bool("NaN", !sun_chebyshev(NAN, &d, &e));
+  check_bool("outputs untouched", d == 1.0 && e == 2.0);
+}
+
+static double times_get(const struct PrayerTimes *t, int event) {
+  const double v[7] = {t->fajr, t->sunrise, t->dhuha, t->dhuhr, t->asr, t->maghrib, t->isha};
+  return v[event];
+}
+
+// Every row of the jadwalsholat.org reference table stays within 2 min with
+// the Chebyshev backend installed
+static void test_reference_csv(const char *path) {
+  printf("  %s with the Chebyshev backend...\n", path);
+  FILE *f = fopen(path, "r");
+  check_bool("reference CSV readable", f != NULL);
+  if (!f)
+    return;
+
+  sun_chebyshev_install();
+  const MethodParams *p = method_params_get(CALC_KEMENAG);
+  char line[256];
+  int rows = 0, near_ref = 0, max_shift = 0;
+  while (fgets(line, sizeof(line), f)) {
+    double lat, lon, tz;
+    int y, m, d, h[7], mi[7];
+    char city[64];
+    int n = sscanf(line,
+                   "%63[^,],%*d,%lf,%lf,%lf,%d-%d-%d,%d:%d,%d:%d,%d:%d,%d:%d,%d:%d,%d:%d,%d:%d",
+                   city, &lat, &lon, &tz, &y, &m, &d, &h[0], &mi[0], &h[1], &mi[1], &h[2], &mi[2],
+                   &h[3], &mi[3], &h[4], &mi[4], &h[5], &mi[5], &h[6], &mi[6]);
+    if (line[0] == '#' || n != 21)
+      continue;
+
+    struct PrayerTimes cheb = calculate_prayer_times(y, m, d, lat, lon, tz, p);
+    prayer_set_sun_source(NULL, NULL);
+    struct PrayerTimes ana = calculate_prayer_times(y, m, d, lat, lon, tz, p);
+    sun_chebyshev_install();
+
+    bool row_near = true;
+    for (int e = 0; e < 7; e++) {
+      char sc[16], sa[16];
+      format_time_hm(times_get(&cheb, e), sc, sizeof(sc));
+      format_time_hm(times_get(&ana, e), sa, sizeof(sa));
+      int shown = atoi(sc) * 60 + atoi(sc + 3);
+      int shift = abs(shown - (atoi(sa) * 60 + atoi(sa + 3)));
+      max_shift = shift > max_shift ? shift : max_shift;
+      row_near = row_near && abs(shown - (h[e] * 60 + mi[e])) <= 2;
+    }
+    rows++;
+    near_ref += row_near;
+  }
+  fclose(f);
+  prayer_set_sun_source(NULL, NULL);
+
+  printf("    %d rows: %d within 2 min of reference, at most %d min from analytic\n", rows,
+         near_ref, max_shift);
+  check_bool("reference rows parsed", rows > 0);
+  check_bool("within 2 min of reference", near_ref == rows);
+  check_bool("at most 1 min from analytic", max_shift <= 1);
+}
+
+int main(int argc, char **argv) {
+  const char *csv = argc > 1 ? argv[1] : "tests/reference_prayer_times.csv";
+
+  printf("Running Chebyshev solar ephemeris tests...\n");
+  test_reference_model();
+  test_fit_error();
+  test_reference_csv(csv);
+
+  printf("\nResults: %d passed, %d failed\n", passed, failed);
+  return failed > 0 ? 1 : 0;
+}
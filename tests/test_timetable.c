@@ -0,0 +1,243 @@
+#define PRAYERTIMES_IMPLEMENTATION
+#include "platform.h"
+#include "timetable.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int passed = 0;
+static int failed = 0;
+
+static void check_bool(const char *test, bool cond) {
+  if (cond) {
+    passed++;
+  } else {
+    failed++;
+    fprintf(stderr, "FAIL [%s]\n", test);
+  }
+}
+
+#define CSV_PATH "test_timetable_locations.csv"
+
+static void write_file(const char *path, const char *text) {
+  FILE *f = fopen(path, "w");
+  if (f) {
+    fputs(text, f);
+    fclose(f);
+  }
+}
+
+// Run an export into memory; returns a malloc'd NUL-terminated string or NULL
+static char *export_to_string(const TimetableLocation *locs, size_t n, TimetableDate from,
+                              TimetableDate to, int threads) {
+  FILE *f = tmpfile();
+  if (!f)
+    return NULL;
+  char *text = NULL;
+  if (timetable_export(f, locs, n, from, to, threads) == 0) {
+    long len = ftell(f);
+    text = malloc((size_t)len + 1);
+    rewind(f);
+    if (text && fread(text, 1, (size_t)len, f) == (size_t)len) {
+      text[len] = '\0';
+    } else {
+      free(text);
+      text = NULL;
+    }
+  }
+  fclose(f);
+  return text;
+}
+
+static void test_parse_date(void) {
+  printf("  timetable_parse_date...\n");
+  TimetableDate d;
+  check_bool("plain date", timetable_parse_date("2026-03-09", &d) == 0 && d.year == 2026 &&
+                               d.month == 3 && d.day == 9);
+  check_bool("leap day", timetable_parse_date("2024-02-29", &d) == 0);
+  check_bool("not a leap year", timetable_parse_date("2026-02-29", &d) != 0);
+  check_bool("month 13", timetable_parse_date("2026-13-01", &d) != 0);
+  check_bool("trailing text", timetable_parse_date("2026-01-05x", &d) != 0);
+  check_bool("empty", timetable_parse_date("", &d) != 0);
+}
+
+static void test_load_locations(void) {
+  printf("  timetable_load_locations...\n");
+  write_file(CSV_PATH, "# name,lat,lon,tz,method\n"
+                       "\n"
+                       "Masjid Istiqlal,-6.1702,106.8310,7,kemenag\n"
+                       "East London Mosque,51.5177,-0.0652,0,mwl\r\n"
+                       "Masjid al-Haram,21.4225,39.8262,3,makkah\n");
+  TimetableLocation *locs = NULL;
+  size_t n = 0;
+  check_bool("load", timetable_load_locations(CSV_PATH, &locs, &n) == 0);
+  check_bool("three rows", n == 3);
+  if (n == 3) {
+    check_bool("name with spaces", strcmp(locs[0].name, "Masjid Istiqlal") == 0);
+    check_bool("coordinates", locs[1].latitude == 51.5177 && locs[1].longitude == -0.0652 &&
+                                  locs[1].timezone == 0.0);
+    check_bool("method keys", locs[0].method == CALC_KEMENAG && locs[1].method == CALC_MWL &&
+                                  locs[2].method == CALC_MAKKAH);
+  }
+  free(locs);
+
+  locs = NULL;
+  write_file(CSV_PATH, "Somewhere,1,2,3,nosuchmethod\n");
+  check_bool("unknown method", timetable_load_locations(CSV_PATH, &locs, &n) != 0);
+  write_file(CSV_PATH, "Somewhere,1,2\n");
+  check_bool("missing columns", timetable_load_locations(CSV_PATH, &locs, &n) != 0);
+  write_file(CSV_PATH, "Somewhere,95,2,3,mwl\n");
+  check_bool("latitude out of range", timetable_load_locations(CSV_PATH, &locs, &n) != 0);
+  check_bool("missing file", timetable_load_locations("does_not_exist.csv", &locs, &n) != 0);
+  platform_file_delete(CSV_PATH);
+}
+
+static void append_expected(char *p, const TimetableLocation *l, int y, int m, int d) {
+  struct PrayerTimes t = calculate_prayer_times(y, m, d, l->latitude, l->longitude, l->timezone,
+                                                method_params_get(l->method));
+  const double v[7] = {t.fajr, t.sunrise, t.dhuha, t.dhuhr, t.asr, t.maghrib, t.isha};
+  p += sprintf(p, "%s,%04d-%02d-%02d", l->name, y, m, d);
+  for (int e = 0; e < 7; e++) {
+    char hm[16];
+    if (isnan(v[e]))
+      strcpy(hm, "--:--");
+    else
+      format_time_hm(v[e], hm, sizeof(hm));
+    p += sprintf(p, ",%s", hm);
+  }
+  strcpy(p, "\n");
+}
+
+static void test_matches_serial(void) {
+  printf("  rows match calculate_prayer_times, across month and year ends...\n");
+  const TimetableLocation locs[] = {
+      {"Jakarta", -6.1667, 106.8167, 7.0, CALC_KEMENAG},
+      {"London", 51.5074, -0.1278, 0.0, CALC_MWL},
+      {"Longyearbyen", 78.2232, 15.6267, 1.0, CALC_MWL},
+  };
+  TimetableDate from = {2025, 12, 30}, to = {2026, 3, 2};
+  char *text = export_to_string(locs, 3, from, to, 2);
+  check_bool("export", text != NULL);
+  if (!text)
+    return;
+
+  size_t size = 3 * 63 * 160 + 1;
+  char *expected = malloc(size);
+  char *p = expected;
+  static const int dim[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  for (int l = 0; l < 3; l++) {
+    int y = from.year, m = from.month, d = from.day;
+    for (;;) {
+      append_expected(p, &locs[l], y, m, d);
+      p += strlen(p);
+      if (y == to.year && m == to.month && d == to.day)
+        break;
+      if (++d > dim[m - 1]) {
+        d = 1;
+        if (++m > 12) {
+          m = 1;
+          y++;
+        }
+      }
+    }
+  }
+  check_bool("identical to serial loop", strcmp(text, expected) == 0);
+  const char *polar = strstr(text, "Longyearbyen,2026-01-01,");
+  const char *polar_end = polar ? strchr(polar, '\n') : NULL;
+  const char *dash = polar ? strstr(polar, "--:--") : NULL;
+  check_bool("polar night sunrise shows --:--", dash && dash < polar_end);
+  free(expected);
+  free(text);
+}
+
+static void test_thread_counts_identical(void) {
+  printf("  1, 3 and 8 threads produce identical output (2 batches)...\n");
+  // 400 locations x 12 months = 4800 chunks: more than one output batch
+  size_t n = 400;
+  TimetableLocation *locs = calloc(n, sizeof(*locs));
+  for (size_t i = 0; i < n; i++) {
+    snprintf(locs[i].name, sizeof(locs[i].name), "site%zu", i);
+    locs[i].latitude = -60.0 + (double)(i % 121);
+    locs[i].longitude = -180.0 + (double)(i * 37 % 360);
+    locs[i].timezone = floor(locs[i].longitude / 15.0 + 0.5);
+    locs[i].method = (CalcMethod)(i % CALC_CUSTOM);
+  }
+  TimetableDate from = {2026, 1, 1}, to = {2026, 12, 31};
+  char *one = export_to_string(locs, n, from, to, 1);
+  char *three = export_to_string(locs, n, from, to, 3);
+  char *eight = export_to_string(locs, n, from, to, 8);
+  check_bool("exports", one && three && eight);
+  if (one && three && eight) {
+    size_t rows = 0;
+    for (const char *c = one; *c; c++)
+      rows += *c == '\n';
+    check_bool("one row per location-day", rows == n * 365);
+    check_bool("3 threads identical", strcmp(one, three) == 0);
+    check_bool("8 threads identical", strcmp(one, eight) == 0);
+  }
+  free(one);
+  free(three);
+  free(eight);
+  free(locs);
+}
+
+static void test_far_timezone(void) {
+  printf("  longitude 180 at UTC-14, longest name...\n");
+  // Valid loader input whose times fall outside [0, 24): every field must
+  // still be HH:MM, so rows never outgrow the buffer reserved for them
+  TimetableLocation loc = {"", 21.4225, 180.0, -14.0, CALC_MWL};
+  memset(loc.name, 'x', TIMETABLE_NAME_MAX - 1);
+  TimetableDate from = {2026, 1, 1}, to = {2026, 12, 31};
+  char *text = export_to_string(&loc, 1, from, to, 2);
+  check_bool("export", text != NULL);
+  if (!text)
+    return;
+
+  size_t row_len = (TIMETABLE_NAME_MAX - 1) + 1 + 10 + 7 * 6 + 1;
+  size_t rows = 0, bad = 0;
+  for (const char *row = text; *row; rows++) {
+    const char *nl = strchr(row, '\n');
+    if (!nl)
+      break;
+    bad += (size_t)(nl + 1 - row) != row_len;
+    for (const char *c = row + TIMETABLE_NAME_MAX + 10; c < nl; c += 6) {
+      int h = -1, m = -1;
+      bad += strncmp(c, ",--:--", 6) != 0 &&
+             (sscanf(c, ",%2d:%2d", &h, &m) != 2 || h < 0 || h > 23 || m < 0 || m > 59);
+    }
+    row = nl + 1;
+  }
+  check_bool("one row per day", rows == 365);
+  check_bool("fixed-width HH:MM fields", bad == 0);
+  free(text);
+}
+
+static void test_invalid(void) {
+  printf("  invalid ranges...\n");
+  TimetableLocation loc = {"Jakarta", -6.1667, 106.8167, 7.0, CALC_KEMENAG};
+  TimetableDate a = {2026, 3, 1}, b = {2026, 2, 1};
+  FILE *f = tmpfile();
+  check_bool("reversed range", f && timetable_export(f, &loc, 1, a, b, 1) != 0);
+  check_bool("range check", timetable_check_range(a, b) != 0 && timetable_check_range(b, a) == 0);
+  check_bool("single day", f && timetable_export(f, &loc, 1, a, a, 4) == 0);
+  check_bool("no locations", f && timetable_export(f, &loc, 0, b, a, 1) == 0);
+  if (f)
+    fclose(f);
+}
+
+int main(void) {
+  printf("Running timetable export tests...\n");
+
+  test_parse_date();
+  test_load_locations();
+  test_matches_serial();
+  test_thread_counts_identical();
+  test_far_timezone();
+  test_invalid();
+
+  printf("\nResults: %d passed, %d failed\n", passed, failed);
+  return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,87 @@
+// Generate the precomputed solar ephemeris read by ephemeris_install().
+//
+//   gen_ephemeris [--from YEAR] [--to YEAR] [--model analytic|chebyshev] [OUTPUT]
+//
+// Defaults to 1900-2200 from the analytic model, written to
+// ephemeris_get_path() (~/.cache/muslimtify/sun_ephemeris.bin). The chebyshev
+// model (sun_chebyshev.h) gives VSOP87-grade values; days outside its fitted
+// span use the analytic model.
+
+#define PRAYERTIMES_IMPLEMENTATION
+#include "ephemeris.h"
+#include "platform.h"
+#include "prayertimes.h"
+#include "sun_chebyshev.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void usage(const char *argv0) {
+  fprintf(stderr, "Usage: %s [--from YEAR] [--to YEAR] [--model analytic|chebyshev] [OUTPUT]\n",
+          argv0);
+}
+
+static void chebyshev_or_analytic(double jd, double *declination, double *equation_of_time) {
+  if (!sun_chebyshev(jd, declination, equation_of_time))
+    sun_position_analytic(jd, declination, equation_of_time);
+}
+
+int main(int argc, char **argv) {
+  int first_year = 1900, last_year = 2200;
+  const char *out = NULL;
+  const char *model = "analytic";
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+      first_year = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+      last_year = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+      model = argv[++i];
+    } else if (argv[i][0] != '-' && !out) {
+      out = argv[i];
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  EphemerisSourceFn source;
+  if (strcmp(model, "analytic") == 0) {
+    source = sun_position_analytic;
+  } else if (strcmp(model, "chebyshev") == 0) {
+    source = chebyshev_or_analytic;
+  } else {
+    fprintf(stderr, "Error: unknown model '%s'\n", model);
+    return 1;
+  }
+
+  if (last_year < first_year) {
+    fprintf(stderr, "Error: --to must not be before --from\n");
+    return 1;
+  }
+
+  if (!out) {
+    out = ephemeris_get_path();
+    if (out[0] == '\0' || platform_mkdir_p(platform_cache_dir()) != 0) {
+      fprintf(stderr, "Error: cannot determine cache directory\n");
+      return 1;
+    }
+  }
+
+  if (ephemeris_write(out, first_year, last_year, source, model) != 0) {
+    fprintf(stderr, "Error: failed to write %s\n", out);
+    return 1;
+  }
+
+  EphemerisTable table;
+  if (ephemeris_open(&table, out) != 0) {
+    fprintf(stderr, "Error: %s failed validation\n", out);
+    return 1;
+  }
+  printf("Wrote %s: %u days (%d-%d), %zu bytes\n", out, table.header->count, first_year,
+         last_year, table.map_size);
+  ephemeris_close(&table);
+  return 0;
+}
@@ -0,0 +1,129 @@
+// Fit the Chebyshev solar ephemeris compiled into src/core/sun_chebyshev.c.
+//
+//   gen_sun_chebyshev [--from YEAR] [--to YEAR] OUTPUT
+//
+// Writes src/core/sun_chebyshev_table.h, which is committed; regenerate it with
+// the update_sun_chebyshev_table target (BUILD_TOOLS). The sun_chebyshev_table
+// test fails when the committed copy no longer matches this output.
+// Each SEGMENT_DAYS-day segment gets a degree COEFFS-1 Chebyshev interpolant
+// of declination and equation of time through the VSOP87 reference
+// (tools/vsop87_sun.c) at the Chebyshev nodes. Fit error is ~0.01" and ~1 ms,
+// far below the reference's own ~1" accuracy.
+
+#include "vsop87_sun.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define SEGMENT_DAYS 32
+#define COEFFS 10
+
+// Julian day of Jan 1, 0h UT (Gregorian)
+static double jd_jan1(int year) {
+  int y = year - 1;
+  int a = y / 100;
+  return floor(365.25 * (y + 4716)) + floor(30.6001 * 14) + 1 + (2 - a + a / 4) - 1524.5;
+}
+
+static void fit_segment(double start, double c[2][COEFFS]) {
+  double f[2][COEFFS];
+  for (int k = 0; k < COEFFS; k++) {
+    double x = cos(M_PI * (k + 0.5) / COEFFS);
+    vsop87_sun_apparent(start + 0.5 * SEGMENT_DAYS * (1.0 + x), NULL, &f[0][k], &f[1][k]);
+  }
+  for (int q = 0; q < 2; q++) {
+    for (int j = 0; j < COEFFS; j++) {
+      double sum = 0.0;
+      for (int k = 0; k < COEFFS; k++)
+        sum += f[q][k] * cos(M_PI * j * (k + 0.5) / COEFFS);
+      c[q][j] = sum * (j == 0 ? 1.0 : 2.0) / COEFFS;
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  int first_year = 1900, last_year = 2200;
+  const char *out = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+      first_year = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+      last_year = atoi(argv[++i]);
+    } else if (argv[i][0] != '-' && !out) {
+      out = argv[i];
+    } else {
+      out = NULL;
+      break;
+    }
+  }
+  if (!out || last_year < first_year) {
+    fprintf(stderr, "Usage: %s [--from YEAR] [--to YEAR] OUTPUT\n", argv[0]);
+    return 1;
+  }
+
+  double first_jd = jd_jan1(first_year);
+  double days = jd_jan1(last_year + 1) - first_jd;
+  int segments = (int)ceil(days / SEGMENT_DAYS);
+
+  // Written beside out and renamed over it, so an interrupted run never
+  // leaves a truncated table that looks up to date to the build
+  char tmp[4096];
+  int n = snprintf(tmp, sizeof(tmp), "%s.tmp", out);
+  if (n < 0 || (size_t)n >= sizeof(tmp)) {
+    fprintf(stderr, "Error: output path too long: %s\n", out);
+    return 1;
+  }
+  FILE *f = fopen(tmp, "w");
+  if (!f) {
+    fprintf(stderr, "Error: cannot write %s\n", tmp);
+    return 1;
+  }
+
+  fprintf(f, "// Generated by tools/gen_sun_chebyshev.c -- do not edit.\n");
+  fprintf(f, "// clang-format off\n");
+  fprintf(f, "// VSOP87 apparent sun, %d-%d, %d-day segments, %d coefficients.\n\n", first_year,
+          last_year, SEGMENT_DAYS, COEFFS);
+  fprintf(f, "#define SUN_CHEBYSHEV_FIRST_JD %.1f\n", first_jd);
+  fprintf(f, "#define SUN_CHEBYSHEV_DAYS %.0f\n", days);
+  fprintf(f, "#define SUN_CHEBYSHEV_SEGMENT_DAYS %d\n", SEGMENT_DAYS);
+  fprintf(f, "#define SUN_CHEBYSHEV_SEGMENTS %d\n", segments);
+  fprintf(f, "#define SUN_CHEBYSHEV_COEFFS %d\n\n", COEFFS);
+  fprintf(f, "// [segment][0 = declination (deg), 1 = equation of time (h)][coefficient]\n");
+  fprintf(f, "static const double sun_chebyshev_table[%d][2][%d] = {\n", segments, COEFFS);
+  for (int s = 0; s < segments; s++) {
+    double c[2][COEFFS];
+    fit_segment(first_jd + (double)s * SEGMENT_DAYS, c);
+    fprintf(f, "    {");
+    for (int q = 0; q < 2; q++) {
+      fprintf(f, "{");
+      for (int j = 0; j < COEFFS; j++)
+        fprintf(f, "%.17g%s", c[q][j], j + 1 < COEFFS ? ", " : "");
+      fprintf(f, "}%s", q == 0 ? ", " : "");
+    }
+    fprintf(f, "},\n");
+  }
+  fprintf(f, "};\n");
+
+  int write_error = ferror(f);
+  if (fclose(f) != 0 || write_error) {
+    fprintf(stderr, "Error: failed to write %s\n", tmp);
+    remove(tmp);
+    return 1;
+  }
+#ifdef _WIN32
+  remove(out); // rename() does not replace an existing file there
+#endif
+  if (rename(tmp, out) != 0) {
+    fprintf(stderr, "Error: cannot rename %s to %s\n", tmp, out);
+    remove(tmp);
+    return 1;
+  }
+  return 0;
+}
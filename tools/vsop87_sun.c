@@ -0,0 +1,331 @@
+#include "vsop87_sun.h"
+
+#include <math.h>
+#include <stddef.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define DEG (M_PI / 180.0)
+#define ARCSEC (DEG / 3600.0)
+
+typedef struct {
+  double a, b, c; // a * cos(b + c * tau), tau in Julian millennia from J2000
+} Vsop87Term;
+
+// Earth heliocentric longitude L0..L5, latitude B0..B1, radius R0..R4;
+// amplitudes in 1e-8 rad / 1e-8 AU
+static const Vsop87Term L0[] = {
+    {175347046, 0, 0},
+    {3341656, 4.6692568, 6283.07585},
+    {34894, 4.6261, 12566.1517},
+    {3497, 2.7441, 5753.3849},
+    {3418, 2.8289, 3.5231},
+    {3136, 3.6277, 77713.7715},
+    {2676, 4.4181, 7860.4194},
+    {2343, 6.1352, 3930.2097},
+    {1324, 0.7425, 11506.7698},
+    {1273, 2.0371, 529.691},
+    {1199, 1.1096, 1577.3435},
+    {990, 5.233, 5884.927},
+    {902, 2.045, 26.298},
+    {857, 3.508, 398.149},
+    {780, 1.179, 5223.694},
+    {753, 2.533, 5507.553},
+    {505, 4.583, 18849.228},
+    {492, 4.205, 775.523},
+    {357, 2.92, 0.067},
+    {317, 5.849, 11790.629},
+    {284, 1.899, 796.298},
+    {271, 0.315, 10977.079},
+    {243, 0.345, 5486.778},
+    {206, 4.806, 2544.314},
+    {205, 1.869, 5573.143},
+    {202, 2.458, 6069.777},
+    {156, 0.833, 213.299},
+    {132, 3.411, 2942.463},
+    {126, 1.083, 20.775},
+    {115, 0.645, 0.98},
+    {103, 0.636, 4694.003},
+    {102, 0.976, 15720.839},
+    {102, 4.267, 7.114},
+    {99, 6.21, 2146.17},
+    {98, 0.68, 155.42},
+    {86, 5.98, 161000.69},
+    {85, 1.3, 6275.96},
+    {85, 3.67, 71430.7},
+    {80, 1.81, 17260.15},
+    {79, 3.04, 12036.46},
+    {75, 1.76, 5088.63},
+    {74, 3.5, 3154.69},
+    {74, 4.68, 801.82},
+    {70, 0.83, 9437.76},
+    {62, 3.98, 8827.39},
+    {61, 1.82, 7084.9},
+    {57, 2.78, 6286.6},
+    {56, 4.39, 14143.5},
+    {56, 3.47, 6279.55},
+    {52, 0.19, 12139.55},
+    {52, 1.33, 1748.02},
+    {51, 0.28, 5856.48},
+    {49, 0.49, 1194.45},
+    {41, 5.37, 8429.24},
+    {41, 2.4, 19651.05},
+    {39, 6.17, 10447.39},
+    {37, 6.04, 10213.29},
+    {37, 2.57, 1059.38},
+    {36, 1.71, 2352.87},
+    {36, 1.78, 6812.77},
+    {33, 0.59, 17789.85},
+    {30, 0.44, 83996.85},
+    {30, 2.74, 1349.87},
+    {25, 3.16, 4690.48},
+};
+
+static const Vsop87Term L1[] = {
+    {628331966747.0, 0, 0},
+    {206059, 2.678235, 6283.07585},
+    {4303, 2.6351, 12566.1517},
+    {425, 1.59, 3.523},
+    {119, 5.796, 26.298},
+    {109, 2.966, 1577.344},
+    {93, 2.59, 18849.23},
+    {72, 1.14, 529.69},
+    {68, 1.87, 398.15},
+    {67, 4.41, 5507.55},
+    {59, 2.89, 5223.69},
+    {56, 2.17, 155.42},
+    {45, 0.4, 796.3},
+    {36, 0.47, 775.52},
+    {29, 2.65, 7.11},
+    {21, 5.34, 0.98},
+    {19, 1.85, 5486.78},
+    {19, 4.97, 213.3},
+    {17, 2.99, 6275.96},
+    {16, 0.03, 2544.31},
+    {16, 1.43, 2146.17},
+    {15, 1.21, 10977.08},
+    {12, 2.83, 1748.02},
+    {12, 3.26, 5088.63},
+    {12, 5.27, 1194.45},
+    {12, 2.08, 4694},
+    {11, 0.77, 553.57},
+    {10, 1.3, 6286.6},
+    {10, 4.24, 1349.87},
+    {9, 2.7, 242.73},
+    {9, 5.64, 951.72},
+    {8, 5.3, 2352.87},
+    {6, 2.65, 9437.76},
+    {6, 4.67, 4690.48},
+};
+
+static const Vsop87Term L2[] = {
+    {52919, 0, 0},         {8720, 1.0721, 6283.0758}, {309, 0.867, 12566.152},
+    {27, 0.05, 3.52},      {16, 5.19, 26.3},          {16, 3.68, 155.42},
+    {10, 0.76, 18849.23},  {9, 2.06, 77713.77},       {7, 0.83, 775.52},
+    {5, 4.66, 1577.34},    {4, 1.03, 7.11},           {4, 3.44, 5573.14},
+    {3, 5.14, 796.3},      {3, 6.05, 5507.55},        {3, 1.19, 242.73},
+    {3, 6.12, 529.69},     {3, 0.31, 398.15},         {3, 2.28, 553.57},
+    {2, 4.38, 5223.69},    {2, 3.75, 0.98},
+};
+
+static const Vsop87Term L3[] = {
+    {289, 5.844, 6283.076}, {35, 0, 0},         {17, 5.49, 12566.15}, {3, 5.2, 155.42},
+    {1, 4.72, 3.52},        {1, 5.3, 18849.23}, {1, 5.97, 242.73},
+};
+
+static const Vsop87Term L4[] = {{114, 3.142, 0}, {8, 4.13, 6283.08}, {1, 3.84, 12566.15}};
+
+static const Vsop87Term L5[] = {{1, 3.14, 0}};
+
+static const Vsop87Term B0[] = {
+    {280, 3.199, 84334.662}, {102, 5.422, 5507.553}, {80, 3.88, 5223.69},
+    {44, 3.7, 2352.87},      {32, 4, 1577.34},
+};
+
+static const Vsop87Term B1[] = {{9, 3.9, 5507.55}, {6, 1.73, 5223.69}};
+
+static const Vsop87Term R0[] = {
+    {100013989, 0, 0},
+    {1670700, 3.0984635, 6283.07585},
+    {13956, 3.05525, 12566.1517},
+    {3084, 5.1985, 77713.7715},
+    {1628, 1.1739, 5753.3849},
+    {1576, 2.8469, 7860.4194},
+    {925, 5.453, 11506.77},
+    {542, 4.564, 3930.21},
+    {472, 3.661, 5884.927},
+    {346, 0.964, 5507.553},
+    {329, 5.9, 5223.694},
+    {307, 0.299, 5573.143},
+    {243, 4.273, 11790.629},
+    {212, 5.847, 1577.344},
+    {186, 5.022, 10977.079},
+    {175, 3.012, 18849.228},
+    {110, 5.055, 5486.778},
+    {98, 0.89, 6069.78},
+    {86, 5.69, 15720.84},
+    {86, 1.27, 161000.69},
+    {65, 0.27, 17260.15},
+    {63, 0.92, 529.69},
+    {57, 2.01, 83996.85},
+    {56, 5.24, 71430.7},
+    {49, 3.25, 2544.31},
+    {47, 2.58, 775.52},
+    {45, 5.54, 9437.76},
+    {43, 6.01, 6275.96},
+    {39, 5.36, 4694},
+    {38, 2.39, 8827.39},
+    {37, 0.83, 19651.05},
+    {37, 4.9, 12139.55},
+    {36, 1.67, 12036.46},
+    {35, 1.84, 2942.46},
+    {33, 0.24, 7084.9},
+    {32, 0.18, 5088.63},
+    {32, 1.78, 398.15},
+    {28, 1.21, 6286.6},
+    {28, 1.9, 6279.55},
+    {26, 4.59, 10447.39},
+};
+
+static const Vsop87Term R1[] = {
+    {103019, 1.10749, 6283.07585}, {1721, 1.0644, 12566.1517}, {702, 3.142, 0},
+    {32, 1.02, 18849.23},          {31, 2.84, 5507.55},        {25, 1.32, 5223.69},
+    {18, 1.42, 1577.34},           {10, 5.91, 10977.08},       {9, 1.42, 6275.96},
+    {9, 0.27, 5486.78},
+};
+
+static const Vsop87Term R2[] = {
+    {4359, 5.7846, 6283.0758}, {124, 5.579, 12566.152}, {12, 3.14, 0},
+    {9, 3.63, 77713.77},       {6, 1.87, 5573.14},      {3, 5.47, 18849.23},
+};
+
+static const Vsop87Term R3[] = {{145, 4.273, 6283.076}, {7, 3.92, 12566.15}};
+
+static const Vsop87Term R4[] = {{4, 2.56, 6283.08}};
+
+#define SERIES(t) {t, sizeof(t) / sizeof(t[0])}
+
+typedef struct {
+  const Vsop87Term *terms;
+  size_t count;
+} Vsop87Series;
+
+static double series_sum(const Vsop87Series *s, size_t n, double tau) {
+  double total = 0.0, power = 1.0;
+  for (size_t i = 0; i < n; i++) {
+    double sum = 0.0;
+    for (size_t k = 0; k < s[i].count; k++)
+      sum += s[i].terms[k].a * cos(s[i].terms[k].b + s[i].terms[k].c * tau);
+    total += sum * power;
+    power *= tau;
+  }
+  return total * 1e-8;
+}
+
+// c[0] + c[1] x + ... + c[n-1] x^(n-1)
+static double horner(const double *c, size_t n, double x) {
+  double r = 0.0;
+  while (n-- > 0)
+    r = r * x + c[n];
+  return r;
+}
+
+double vsop87_delta_t(double y) {
+  double t;
+  if (y < 1920) {
+    t = y - 1900;
+    return -2.79 + 1.494119 * t - 0.0598939 * t * t + 0.0061966 * t * t * t -
+           0.000197 * t * t * t * t;
+  }
+  if (y < 1941) {
+    t = y - 1920;
+    return 21.20 + 0.84493 * t - 0.076100 * t * t + 0.0020936 * t * t * t;
+  }
+  if (y < 1961) {
+    t = y - 1950;
+    return 29.07 + 0.407 * t - t * t / 233.0 + t * t * t / 2547.0;
+  }
+  if (y < 1986) {
+    t = y - 1975;
+    return 45.45 + 1.067 * t - t * t / 260.0 - t * t * t / 718.0;
+  }
+  if (y < 2005) {
+    t = y - 2000;
+    return 63.86 + 0.3345 * t - 0.060374 * t * t + 0.0017275 * t * t * t +
+           0.000651814 * t * t * t * t + 0.00002373599 * t * t * t * t * t;
+  }
+  if (y < 2050) {
+    t = y - 2000;
+    return 62.92 + 0.32217 * t + 0.005589 * t * t;
+  }
+  double u = (y - 1820) / 100.0;
+  if (y < 2150)
+    return -20 + 32 * u * u - 0.5628 * (2150 - y);
+  return -20 + 32 * u * u;
+}
+
+void vsop87_sun_apparent(double jd_ut, double *longitude, double *declination,
+                         double *equation_of_time) {
+  static const Vsop87Series L[] = {SERIES(L0), SERIES(L1), SERIES(L2),
+                                   SERIES(L3), SERIES(L4), SERIES(L5)};
+  static const Vsop87Series B[] = {SERIES(B0), SERIES(B1)};
+  static const Vsop87Series R[] = {SERIES(R0), SERIES(R1), SERIES(R2), SERIES(R3), SERIES(R4)};
+
+  double year = 2000.0 + (jd_ut - 2451545.0) / 365.25;
+  double jde = jd_ut + vsop87_delta_t(year) / 86400.0;
+  double T = (jde - 2451545.0) / 36525.0;
+  double tau = T / 10.0;
+
+  // Geocentric ecliptic coordinates (dynamical equinox), then FK5 (Meeus 25.9)
+  double lon = series_sum(L, 6, tau) + M_PI;
+  double lat = -series_sum(B, 2, tau);
+  double dist = series_sum(R, 5, tau);
+  double lon_fk5 = lon - 1.397 * DEG * T - 0.00031 * DEG * T * T;
+  lon += -0.09033 * ARCSEC;
+  lat += 0.03916 * ARCSEC * (cos(lon_fk5) - sin(lon_fk5));
+
+  // Nutation (Meeus ch. 22, terms above 0.1")
+  double omega = (125.04452 - 1934.136261 * T + 0.0020708 * T * T) * DEG;
+  double ls = (280.4665 + 36000.7698 * T) * DEG;
+  double lm = (218.3165 + 481267.8813 * T) * DEG;
+  double dpsi = (-17.20 * sin(omega) - 1.32 * sin(2 * ls) - 0.23 * sin(2 * lm) +
+                 0.21 * sin(2 * omega)) *
+                ARCSEC;
+  double deps =
+      (9.20 * cos(omega) + 0.57 * cos(2 * ls) + 0.10 * cos(2 * lm) - 0.09 * cos(2 * omega)) *
+      ARCSEC;
+
+  // Mean obliquity (Laskar, Meeus 22.3), arcseconds in U = T / 100
+  static const double eps_coeff[] = {84381.448, -4680.93, -1.55, 1999.25, -51.38, -249.67,
+                                     -39.05,    7.12,     27.87, 5.79,    2.45};
+  double eps0 = horner(eps_coeff, sizeof(eps_coeff) / sizeof(eps_coeff[0]), T / 100.0);
+  double eps = eps0 * ARCSEC + deps;
+
+  // Apparent longitude: nutation and annual aberration
+  double lambda = lon + dpsi - 20.4898 * ARCSEC / dist;
+
+  double ra = atan2(sin(lambda) * cos(eps) - tan(lat) * sin(eps), cos(lambda));
+  double dec = asin(sin(lat) * cos(eps) + cos(lat) * sin(eps) * sin(lambda));
+
+  // Equation of time (Meeus 28.3), in degrees then hours
+  static const double mean_lon_coeff[] = {280.4664567,        360007.6982779,   0.03032028,
+                                          1.0 / 49931.0,      -1.0 / 15300.0, -1.0 / 2000000.0};
+  double L0m = horner(mean_lon_coeff, sizeof(mean_lon_coeff) / sizeof(mean_lon_coeff[0]), tau);
+  double E = L0m - 0.0057183 - ra / DEG + dpsi / DEG * cos(eps);
+  E = fmod(E, 360.0);
+  if (E > 180.0)
+    E -= 360.0;
+  if (E < -180.0)
+    E += 360.0;
+
+  if (longitude) {
+    double l = fmod(lambda / DEG, 360.0);
+    *longitude = l < 0 ? l + 360.0 : l;
+  }
+  if (declination)
+    *declination = dec / DEG;
+  if (equation_of_time)
+    *equation_of_time = E / 15.0;
+}
@@ -0,0 +1,28 @@
+#ifndef VSOP87_SUN_H
+#define VSOP87_SUN_H
+
+/*
+ * High-accuracy apparent solar position: the abridged VSOP87D Earth series
+ * (Meeus, Astronomical Algorithms, 2nd ed., Appendix III; the same terms as
+ * NREL SPA) with FK5 correction, IAU 1980 nutation (main terms), aberration
+ * and ΔT (Espenak & Meeus). Accurate to about 1 arcsecond over 1900-2200.
+ *
+ * Too slow for the engine's hot path (~250 trigonometric terms); used as the
+ * reference the Chebyshev tables are fitted to and checked against.
+ */
+
+/**
+ * ΔT = TT - UT in seconds for a decimal year (valid 1900-2200).
+ */
+double vsop87_delta_t(double year);
+
+/**
+ * Apparent geocentric solar coordinates at a Julian day in UT.
+ * longitude and declination in degrees, equation of time in hours
+ * (apparent minus mean solar time, same sign as the engine's).
+ * Any output pointer may be NULL.
+ */
+void vsop87_sun_apparent(double jd_ut, double *longitude, double *declination,
+                         double *equation_of_time);
+
+#endif // VSOP87_SUN_H